@@ -0,0 +1,113 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+
+namespace Benchmark
+{
+    /**
+     * Prevents compiler from optimizing computation of value out.
+     */
+    template<typename T>
+    inline void doNotOptimize(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /**
+     * Runs function repeatedly for at least minDuration and returns average time of one call in nanoseconds.
+     */
+    template<typename F>
+    double measure(F&& function, std::chrono::milliseconds minDuration=std::chrono::milliseconds{200})
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Warm-up
+        function();
+
+        std::size_t iterations = 0;
+        std::size_t batch = 1;
+        auto begin = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < minDuration)
+        {
+            for (std::size_t i=0; i<batch; ++i)
+            {
+                function();
+            }
+            iterations += batch;
+            batch *= 2;
+            elapsed = Clock::now() - begin;
+        }
+        return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    }
+
+    /**
+     * Connection settings of benchmarks using database.
+     */
+    struct DatabaseSettings
+    {
+        std::string host{"127.0.0.1"};
+        std::uint16_t port{3306};
+        std::string user{"root"};
+        std::string password{"password"};
+        std::string database{"test_superior_sqlpp"};
+    };
+
+    /**
+     * Reads settings from arguments: [host [port [user [password [database]]]]].
+     */
+    inline DatabaseSettings parseDatabaseSettings(int argc, char* argv[])
+    {
+        DatabaseSettings settings{};
+        if (argc > 1)
+        {
+            settings.host = argv[1];
+        }
+        if (argc > 2)
+        {
+            settings.port = static_cast<std::uint16_t>(std::atoi(argv[2]));
+        }
+        if (argc > 3)
+        {
+            settings.user = argv[3];
+        }
+        if (argc > 4)
+        {
+            settings.password = argv[4];
+        }
+        if (argc > 5)
+        {
+            settings.database = argv[5];
+        }
+        return settings;
+    }
+
+    inline void printHeader(const std::string& title)
+    {
+        std::printf("\n%s\n", title.c_str());
+    }
+
+    inline void printResult(const std::string& name, double nanoseconds, std::size_t bytes=0)
+    {
+        if (bytes != 0)
+        {
+            std::printf("  %-40s %12.1f ns %10.3f ns/B %10.1f MB/s\n", name.c_str(), nanoseconds,
+                        nanoseconds / bytes, bytes * 1000.0 / nanoseconds);
+        }
+        else
+        {
+            std::printf("  %-40s %12.1f ns\n", name.c_str(), nanoseconds);
+        }
+    }
+}
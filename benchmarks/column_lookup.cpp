@@ -0,0 +1,92 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <superior_mysqlpp/column_name_index.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+int main()
+{
+    constexpr std::size_t rowsCount = 100000;
+
+    for (std::size_t columnsCount: {4u, 16u, 64u})
+    {
+        std::vector<std::string> storage{};
+        for (std::size_t i=0; i<columnsCount; ++i)
+        {
+            storage.push_back("column_name_" + std::to_string(i * 7919 % 1000));
+        }
+        std::vector<StringView> names{storage.begin(), storage.end()};
+
+        // Previous implementation: sorted (name, index) pairs searched by std::lower_bound
+        std::vector<std::tuple<StringView, std::size_t>> sorted{};
+        for (std::size_t i=0; i<names.size(); ++i)
+        {
+            sorted.emplace_back(names[i], i);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        detail::ColumnNameIndex index{names};
+        std::vector<ColumnHandle> handles{};
+        for (auto&& name: names)
+        {
+            handles.emplace_back(index.find(name));
+        }
+
+        const auto lookups = rowsCount * columnsCount;
+        Benchmark::printHeader("Lookup of all " + std::to_string(columnsCount) + " columns in " + std::to_string(rowsCount) + " rows");
+
+        auto sortedTime = Benchmark::measure([&](){
+            std::size_t sum = 0;
+            for (std::size_t row=0; row<rowsCount; ++row)
+            {
+                for (auto&& name: storage)
+                {
+                    StringView columnName{name};
+                    auto it = std::lower_bound(sorted.begin(), sorted.end(), columnName, [](auto&& elem, auto&& value){
+                        return std::get<0>(elem) < value;
+                    });
+                    sum += std::get<1>(*it);
+                }
+            }
+            Benchmark::doNotOptimize(sum);
+        });
+        Benchmark::printResult("sorted vector (per lookup)", sortedTime / lookups);
+
+        auto hashTime = Benchmark::measure([&](){
+            std::size_t sum = 0;
+            for (std::size_t row=0; row<rowsCount; ++row)
+            {
+                for (auto&& name: storage)
+                {
+                    sum += index.find(name);
+                }
+            }
+            Benchmark::doNotOptimize(sum);
+        });
+        Benchmark::printResult("ColumnNameIndex (per lookup)", hashTime / lookups);
+
+        auto handleTime = Benchmark::measure([&](){
+            std::size_t sum = 0;
+            for (std::size_t row=0; row<rowsCount; ++row)
+            {
+                for (auto handle: handles)
+                {
+                    sum += handle.getIndex();
+                }
+                Benchmark::doNotOptimize(sum);
+            }
+        });
+        Benchmark::printResult("ColumnHandle (per lookup)", handleTime / lookups);
+    }
+
+    return 0;
+}
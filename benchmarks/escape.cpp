@@ -0,0 +1,81 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <string>
+#include <vector>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+namespace
+{
+    std::string makePayload(std::size_t size, const std::string& pattern)
+    {
+        std::string payload{};
+        payload.reserve(size + pattern.size());
+        while (payload.size() < size)
+        {
+            payload += pattern;
+        }
+        payload.resize(size);
+        return payload;
+    }
+}
+
+
+int main()
+{
+    // Escaping needs no connection, only the client charset
+    LowLevel::DBDriver driver{};
+
+    const std::vector<std::pair<std::string, std::string>> patterns{
+        {"ascii", "The quick brown fox jumps over the lazy dog; it's \"fine\".\n"},
+        {"utf8", "Příliš žluťoučký kůň úpěl ďábelské ódy; it's \"fine\".\n"},
+    };
+
+    for (auto charset: {"utf8mb4", "latin1"})
+    {
+        std::string charsetName{charset};
+        driver.setCharacterSet(&charsetName.front());
+
+        for (auto&& pattern: patterns)
+        {
+            for (std::size_t size: {16u, 64u, 1024u, 16*1024u, 64*1024u})
+            {
+                auto payload = makePayload(size, pattern.second);
+                std::string output(size*2 + 1, '\0');
+
+                Benchmark::printHeader(charsetName + " / " + pattern.first + " / " + std::to_string(size) + " B");
+
+                auto cApi = Benchmark::measure([&](){
+                    auto length = mysql_real_escape_string(driver.detail_getMysqlPtr(), &output.front(), payload.data(), payload.size());
+                    Benchmark::doNotOptimize(length);
+                });
+                Benchmark::printResult("mysql_real_escape_string", cApi, size);
+
+                auto escapeCharset = LowLevel::detail::getEscapeCharset(driver.getCharacterSetName());
+                auto fallback = [&](char* to, const char* from, std::size_t length){
+                    return mysql_real_escape_string(driver.detail_getMysqlPtr(), to, from, length);
+                };
+                auto scalar = Benchmark::measure([&](){
+                    auto length = LowLevel::detail::escapeString<false>(&output.front(), payload.data(), payload.size(), escapeCharset, fallback);
+                    Benchmark::doNotOptimize(length);
+                });
+                Benchmark::printResult("scalar", scalar, size);
+
+                auto vectorized = Benchmark::measure([&](){
+                    auto length = driver.escapeStringInto(&output.front(), payload.data(), payload.size());
+                    Benchmark::doNotOptimize(length);
+                });
+                Benchmark::printResult("DBDriver::escapeStringInto", vectorized, size);
+            }
+        }
+    }
+
+    return 0;
+}
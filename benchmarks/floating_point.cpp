@@ -0,0 +1,123 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_chars.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+namespace
+{
+    /**
+     * Values with given number of significant digits as MySQL sends them in text protocol.
+     */
+    std::vector<std::string> makeFields(const std::vector<double>& values, int precision)
+    {
+        std::vector<std::string> fields{};
+        fields.reserve(values.size());
+        for (auto value: values)
+        {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            fields.emplace_back(buffer);
+        }
+        return fields;
+    }
+}
+
+
+int main()
+{
+    constexpr std::size_t count = 100000;
+
+    std::mt19937_64 generator{42};
+    std::uniform_real_distribution<double> prices{0.0, 10000.0};
+    std::uniform_real_distribution<double> exponents{-300.0, 300.0};
+    std::vector<double> values{};
+    std::vector<double> wideValues{};
+    for (std::size_t i=0; i<count; ++i)
+    {
+        values.push_back(prices(generator));
+        wideValues.push_back(std::pow(10.0, exponents(generator)));
+    }
+
+    const std::vector<std::pair<std::string, std::vector<std::string>>> inputs{
+        {"6 significant digits, 0 to 10000", makeFields(values, 6)},
+        {"17 significant digits, 0 to 10000", makeFields(values, 17)},
+        {"17 significant digits, 1e-300 to 1e300", makeFields(wideValues, 17)},
+    };
+
+    std::vector<double> output(count);
+    for (auto&& input: inputs)
+    {
+        auto& fields = input.second;
+        Benchmark::printHeader("Parsing " + input.first + " / " + std::to_string(count) + " fields");
+
+        auto strtodTime = Benchmark::measure([&](){
+            for (std::size_t i=0; i<count; ++i)
+            {
+                output[i] = std::strtod(fields[i].c_str(), nullptr);
+            }
+            Benchmark::doNotOptimize(output);
+        });
+        Benchmark::printResult("strtod (per field)", strtodTime / count);
+
+        auto toFloatingPointTime = Benchmark::measure([&](){
+            for (std::size_t i=0; i<count; ++i)
+            {
+                output[i] = Converters::toFloatingPoint<double>(fields[i].data(), fields[i].size());
+            }
+            Benchmark::doNotOptimize(output);
+        });
+        Benchmark::printResult("toFloatingPoint (per field)", toFloatingPointTime / count);
+    }
+
+    for (auto&& input: {std::make_pair("0 to 10000", &values), std::make_pair("1e-300 to 1e300", &wideValues)})
+    {
+        auto& numbers = *input.second;
+        Benchmark::printHeader(std::string{"Writing "} + input.first + " / " + std::to_string(count) + " values");
+
+        char buffer[Converters::toCharsBufferSize];
+        auto toStringTime = Benchmark::measure([&](){
+            for (auto number: numbers)
+            {
+                auto written = std::to_string(number);
+                Benchmark::doNotOptimize(written);
+            }
+        });
+        Benchmark::printResult("std::to_string (per value)", toStringTime / count);
+
+        auto snprintfTime = Benchmark::measure([&](){
+            for (auto number: numbers)
+            {
+                std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+                Benchmark::doNotOptimize(buffer);
+            }
+        });
+        Benchmark::printResult("snprintf %.17g (per value)", snprintfTime / count);
+
+        auto toCharsTime = Benchmark::measure([&](){
+            for (auto number: numbers)
+            {
+                auto end = Converters::toChars(buffer, buffer + sizeof(buffer), number);
+                Benchmark::doNotOptimize(end);
+                Benchmark::doNotOptimize(buffer);
+            }
+        });
+        Benchmark::printResult("toChars (per value)", toCharsTime / count);
+    }
+
+    return 0;
+}
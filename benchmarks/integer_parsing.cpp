@@ -0,0 +1,103 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_integer_batch.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+namespace
+{
+    /**
+     * Column of text protocol fields stored in one buffer like rows of a stored result.
+     */
+    struct TextColumn
+    {
+        std::string buffer{};
+        std::vector<const char*> values{};
+        std::vector<unsigned long> lengths{};
+    };
+
+    TextColumn makeColumn(std::size_t count, std::uint64_t maxValue, bool withNegatives)
+    {
+        std::mt19937_64 generator{42};
+        std::uniform_int_distribution<std::uint64_t> distribution{0, maxValue};
+
+        TextColumn column{};
+        std::vector<std::size_t> offsets{};
+        for (std::size_t i=0; i<count; ++i)
+        {
+            auto value = std::to_string(distribution(generator));
+            if (withNegatives && (generator() & 1))
+            {
+                value.insert(0, 1, '-');
+            }
+            offsets.push_back(column.buffer.size());
+            column.lengths.push_back(value.size());
+            column.buffer += value;
+            column.buffer.push_back('\0');
+        }
+        for (auto offset: offsets)
+        {
+            column.values.push_back(column.buffer.data() + offset);
+        }
+        return column;
+    }
+}
+
+
+int main()
+{
+    constexpr std::size_t count = 100000;
+    const std::vector<std::pair<std::string, std::uint64_t>> ranges{
+        {"up to 3 digits", 999u},
+        {"up to 10 digits", 2147483647u},
+        {"up to 18 digits", 999999999999999999u},
+    };
+
+    std::vector<std::int64_t> output(count);
+    for (auto&& range: ranges)
+    {
+        for (auto withNegatives: {false, true})
+        {
+            auto column = makeColumn(count, range.second, withNegatives);
+            Benchmark::printHeader(range.first + (withNegatives? ", signed" : "") + " / " + std::to_string(count) + " fields");
+
+            auto scalar = Benchmark::measure([&](){
+                for (std::size_t i=0; i<count; ++i)
+                {
+                    output[i] = Converters::toInteger<std::int64_t>(column.values[i], column.lengths[i]);
+                }
+                Benchmark::doNotOptimize(output);
+            });
+            Benchmark::printResult("toInteger (per field)", scalar / count);
+
+            auto scalarValidated = Benchmark::measure([&](){
+                for (std::size_t i=0; i<count; ++i)
+                {
+                    output[i] = Converters::toInteger<std::int64_t, true>(column.values[i], column.lengths[i]);
+                }
+                Benchmark::doNotOptimize(output);
+            });
+            Benchmark::printResult("toInteger<validate> (per field)", scalarValidated / count);
+
+            auto batch = Benchmark::measure([&](){
+                auto report = Converters::toIntegerBatch(column.values.data(), column.lengths.data(), count, output.data());
+                Benchmark::doNotOptimize(report);
+                Benchmark::doNotOptimize(output);
+            });
+            Benchmark::printResult("toIntegerBatch (per field)", batch / count);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <superior_mysqlpp.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+namespace
+{
+    const std::string query = "SELECT LENGTH(?)";
+
+    /**
+     * Returns source generating size bytes, so the value is never materialized.
+     */
+    LongDataSource makeSource(std::size_t size, std::size_t chunkSize)
+    {
+        std::size_t position = 0;
+        return LongDataSource{[position, size](char* destination, std::size_t count) mutable {
+            count = std::min(count, size - position);
+            std::memset(destination, 'x', count);
+            position += count;
+            return count;
+        }, chunkSize};
+    }
+
+    template<typename PreparedStatementType>
+    void executeAndCheck(PreparedStatementType& preparedStatement, std::size_t size)
+    {
+        preparedStatement.execute();
+        if (!preparedStatement.fetch() || static_cast<std::size_t>(std::get<0>(preparedStatement.getResult())) != size)
+        {
+            throw std::logic_error{"Unexpected length of sent value!"};
+        }
+        while (preparedStatement.fetch()) {}
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    auto settings = Benchmark::parseDatabaseSettings(argc, argv);
+    Connection connection{settings.database, settings.user, settings.password, settings.host, settings.port};
+
+    PreparedStatement<ResultBindings<Sql::BigInt>, ParamBindings<std::string>> stringStatement{connection, query, std::string{}};
+    PreparedStatement<ResultBindings<Sql::BigInt>, ParamBindings<LongDataSource>> longDataStatement{connection, query, LongDataSource{}};
+
+    for (std::size_t size: {1024u * 1024u, 16u * 1024u * 1024u})
+    {
+        Benchmark::printHeader("Sending " + std::to_string(size / 1024) + " KiB value");
+
+        // Value materialized in memory and sent with execution
+        std::get<0>(stringStatement.getParams()) = std::string(size, 'x');
+        stringStatement.updateParamsBindings();
+        auto stringTime = Benchmark::measure([&](){ executeAndCheck(stringStatement, size); });
+        Benchmark::printResult("std::string param", stringTime, size);
+
+        for (std::size_t chunkSize: {4u * 1024u, 16u * 1024u, 64u * 1024u, 256u * 1024u, 1024u * 1024u})
+        {
+            auto time = Benchmark::measure([&](){
+                std::get<0>(longDataStatement.getParams()) = makeSource(size, chunkSize);
+                executeAndCheck(longDataStatement, size);
+            });
+            Benchmark::printResult("LongDataSource chunk " + std::to_string(chunkSize / 1024) + " KiB", time, size);
+        }
+    }
+
+    return 0;
+}
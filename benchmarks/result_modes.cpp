@@ -0,0 +1,91 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <superior_mysqlpp.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+namespace
+{
+    template<bool storeResult, CursorMode cursorMode=CursorMode::Disabled>
+    using Statement = PreparedStatement<ResultBindings<Sql::Int, Sql::String>, ParamBindings<>, storeResult,
+                                        ValidateMetadataMode::ArithmeticPromotions, ValidateMetadataMode::Same, false, cursorMode>;
+
+    const std::string selectQuery = "SELECT `id`, `payload` FROM `benchmark_rows`";
+
+    /**
+     * Executes statement and reads at most rowsLimit rows.
+     */
+    template<typename PreparedStatementType>
+    void readRows(PreparedStatementType& preparedStatement, std::size_t rowsLimit)
+    {
+        preparedStatement.execute();
+        std::size_t sum = 0;
+        for (std::size_t row=0; row<rowsLimit && preparedStatement.fetch(); ++row)
+        {
+            sum += std::get<0>(preparedStatement.getResult());
+        }
+        preparedStatement.freeResult();
+        Benchmark::doNotOptimize(sum);
+    }
+
+    template<typename PreparedStatementType>
+    void benchmarkMode(Connection& connection, const std::string& name, std::size_t rowsCount, unsigned long prefetchRowCount=0)
+    {
+        PreparedStatementType preparedStatement{connection, selectQuery};
+        if (prefetchRowCount != 0)
+        {
+            preparedStatement.setPrefetchRowCount(prefetchRowCount);
+        }
+
+        auto allTime = Benchmark::measure([&](){ readRows(preparedStatement, rowsCount); });
+        Benchmark::printResult(name + " all rows (per row)", allTime / rowsCount);
+
+        auto firstTime = Benchmark::measure([&](){ readRows(preparedStatement, 100); });
+        Benchmark::printResult(name + " first 100 rows", firstTime);
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    auto settings = Benchmark::parseDatabaseSettings(argc, argv);
+    Connection connection{settings.database, settings.user, settings.password, settings.host, settings.port};
+    connection.makeQuery(
+        "CREATE TEMPORARY TABLE `benchmark_rows` ("
+        "`id` INT NOT NULL PRIMARY KEY, "
+        "`payload` VARCHAR(64) NOT NULL"
+        ") ENGINE=InnoDB"
+    ).execute();
+
+    auto insert = connection.makePreparedStatement("INSERT INTO `benchmark_rows` VALUES (?, ?)", 0, std::string{});
+    std::size_t rowsCount = 0;
+    for (std::size_t size: {1000u, 100000u, 1000000u})
+    {
+        std::vector<std::tuple<int, std::string>> rows{};
+        for (; rowsCount<size; ++rowsCount)
+        {
+            rows.emplace_back(static_cast<int>(rowsCount), "payload of row " + std::to_string(rowsCount));
+        }
+        insert.executeBulk(rows);
+
+        Benchmark::printHeader("Reading " + std::to_string(rowsCount) + " rows");
+        benchmarkMode<Statement<true>>(connection, "store", rowsCount);
+        benchmarkMode<Statement<false>>(connection, "use", rowsCount);
+        for (unsigned long prefetchRowCount: {16ul, 1024ul, 16384ul})
+        {
+            benchmarkMode<Statement<false, CursorMode::ReadOnly>>(
+                connection, "cursor, prefetch " + std::to_string(prefetchRowCount), rowsCount, prefetchRowCount);
+        }
+    }
+
+    return 0;
+}
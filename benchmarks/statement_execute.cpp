@@ -0,0 +1,119 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <stdexcept>
+#include <string>
+
+#include <superior_mysqlpp.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+int main(int argc, char* argv[])
+{
+    using Bindings = ResultBindings<Sql::BigInt, Sql::BigInt, Sql::BigInt, Sql::BigInt, Sql::String, Sql::String, Sql::String, Sql::String>;
+    const std::string query = "SELECT 1, 2, 3, 4, 'a', 'b', 'c', 'd'";
+
+    auto settings = Benchmark::parseDatabaseSettings(argc, argv);
+    Connection connection{settings.database, settings.user, settings.password, settings.host, settings.port};
+
+    // Separate statements, because the first one has result bound to other bindings
+    PreparedStatement<Bindings, ParamBindings<>> rebindingStatement{connection, query};
+    PreparedStatement<Bindings, ParamBindings<>> preparedStatement{connection, query};
+    auto& statement = rebindingStatement.detail_getStatementRef();
+    Bindings bindings{};
+
+    Benchmark::printHeader("Result binding of statement with " + std::to_string(Bindings::kArgumentsCount) + " columns");
+
+    auto bindTime = Benchmark::measure([&](){
+        statement.bindResult(bindings.bindings.data());
+    });
+    Benchmark::printResult("bindResult", bindTime);
+
+    Benchmark::printHeader("Execute and fetch single row");
+
+    // Previous implementation: field count checked and result bound on every execute
+    auto rebindTime = Benchmark::measure([&](){
+        statement.execute();
+        if (statement.fieldCount() != Bindings::kArgumentsCount)
+        {
+            throw std::logic_error{"Unexpected field count!"};
+        }
+        statement.bindResult(bindings.bindings.data());
+        statement.storeResult();
+        while (statement.fetch())
+        {
+            Benchmark::doNotOptimize(std::get<0>(bindings.data));
+        }
+    });
+    Benchmark::printResult("rebinding result on every execute", rebindTime);
+
+    auto cachedTime = Benchmark::measure([&](){
+        preparedStatement.execute();
+        while (preparedStatement.fetch())
+        {
+            Benchmark::doNotOptimize(std::get<0>(preparedStatement.getResult()));
+        }
+    });
+    Benchmark::printResult("PreparedStatement::execute", cachedTime);
+    Benchmark::printResult("difference", rebindTime - cachedTime);
+
+    using Params = ParamBindings<Sql::BigInt, Sql::BigInt, StringData, StringData>;
+    const std::string paramsQuery = "SELECT ? + ? + LENGTH(?) + LENGTH(?)";
+
+    PreparedStatement<ResultBindings<Sql::BigInt>, Params> paramsRebindingStatement{connection, paramsQuery, 1, 2, "abc", "def"};
+    PreparedStatement<ResultBindings<Sql::BigInt>, Params> paramsStatement{connection, paramsQuery, 1, 2, "abc", "def"};
+    auto& paramsRebinding = paramsRebindingStatement.detail_getStatementRef();
+    Params params{1, 2, "abc", "def"};
+    paramsRebinding.bindParam(params.bindings.data());
+
+    Benchmark::printHeader("Update of " + std::to_string(Params::kArgumentsCount) + " params");
+
+    Sql::BigInt value = 0;
+    // Previous implementation: params bound again on every update
+    auto paramsRebindTime = Benchmark::measure([&](){
+        std::get<0>(params.data) = ++value;
+        std::get<2>(params.data) = (value % 2)? "abc" : "abcdef";
+        params.update();
+        paramsRebinding.bindParam(params.bindings.data());
+    });
+    Benchmark::printResult("binding params on every update", paramsRebindTime);
+
+    auto paramsUpdateTime = Benchmark::measure([&](){
+        std::get<0>(paramsStatement.getParams()) = ++value;
+        std::get<2>(paramsStatement.getParams()) = (value % 2)? "abc" : "abcdef";
+        paramsStatement.updateParamsBindings();
+    });
+    Benchmark::printResult("PreparedStatement::updateParamsBindings", paramsUpdateTime);
+    Benchmark::printResult("difference", paramsRebindTime - paramsUpdateTime);
+
+    Benchmark::printHeader("Set params, execute and fetch single row");
+
+    auto paramsRebindExecuteTime = Benchmark::measure([&](){
+        std::get<0>(params.data) = ++value;
+        params.update();
+        paramsRebinding.bindParam(params.bindings.data());
+        paramsRebindingStatement.execute();
+        while (paramsRebindingStatement.fetch())
+        {
+            Benchmark::doNotOptimize(std::get<0>(paramsRebindingStatement.getResult()));
+        }
+    });
+    Benchmark::printResult("binding params on every execute", paramsRebindExecuteTime);
+
+    auto paramsExecuteTime = Benchmark::measure([&](){
+        std::get<0>(paramsStatement.getParams()) = ++value;
+        paramsStatement.execute();
+        while (paramsStatement.fetch())
+        {
+            Benchmark::doNotOptimize(std::get<0>(paramsStatement.getResult()));
+        }
+    });
+    Benchmark::printResult("PreparedStatement::execute", paramsExecuteTime);
+    Benchmark::printResult("difference", paramsRebindExecuteTime - paramsExecuteTime);
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <superior_mysqlpp.hpp>
+#include <superior_mysqlpp/struct_mapping.hpp>
+
+#include "benchmark.hpp"
+
+using namespace SuperiorMySqlpp;
+
+
+namespace
+{
+    struct BenchmarkRow
+    {
+        int id;
+        StringData payload;
+        Nullable<double> value;
+
+        SUPERIOR_MYSQLPP_MEMBERS(id, payload, value)
+    };
+
+    const std::string selectQuery = "SELECT `id`, `payload`, `value` FROM `benchmark_rows`";
+}
+
+
+int main(int argc, char* argv[])
+{
+    auto settings = Benchmark::parseDatabaseSettings(argc, argv);
+    Connection connection{settings.database, settings.user, settings.password, settings.host, settings.port};
+    connection.makeQuery(
+        "CREATE TEMPORARY TABLE `benchmark_rows` ("
+        "`id` INT NOT NULL PRIMARY KEY, "
+        "`payload` VARCHAR(64) NOT NULL, "
+        "`value` DOUBLE NULL"
+        ") ENGINE=InnoDB"
+    ).execute();
+
+    constexpr std::size_t rowsCount = 100000;
+    std::vector<std::tuple<int, std::string, Nullable<double>>> rows{};
+    for (std::size_t i=0; i<rowsCount; ++i)
+    {
+        rows.emplace_back(static_cast<int>(i), "payload of row " + std::to_string(i), i%2? Nullable<double>{i * 0.5} : Nullable<double>{});
+    }
+    connection.makePreparedStatement("INSERT INTO `benchmark_rows` VALUES (?, ?, ?)", 0, std::string{}, Nullable<double>{}).executeBulk(rows);
+
+    PreparedStatement<StructResultBindings<BenchmarkRow>, ParamBindings<>> preparedStatement{connection, selectQuery};
+
+    Benchmark::printHeader("Reading " + std::to_string(rowsCount) + " rows into std::vector of structs");
+
+    auto copyTime = Benchmark::measure([&](){
+        std::vector<BenchmarkRow> result{};
+        preparedStatement.execute();
+        while (preparedStatement.fetch())
+        {
+            auto& row = preparedStatement.getResult();
+            result.push_back({std::get<0>(row), std::get<1>(row), std::get<2>(row)});
+        }
+        Benchmark::doNotOptimize(result);
+    });
+    Benchmark::printResult("fetch and copy from result storage (per row)", copyTime / rowsCount);
+
+    auto directTime = Benchmark::measure([&](){
+        std::vector<BenchmarkRow> result{};
+        preparedStatement.execute();
+        preparedStatement.fetchAllInto(result);
+        Benchmark::doNotOptimize(result);
+    });
+    Benchmark::printResult("fetchAllInto (per row)", directTime / rowsCount);
+    Benchmark::printResult("difference (per row)", (copyTime - directTime) / rowsCount);
+
+    return 0;
+}
@@ -0,0 +1,974 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+#include <superior_mysqlpp/columnar_result.hpp>
+#include <superior_mysqlpp/converters/to_integer_batch.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/prepared_statement.hpp>
+#include <superior_mysqlpp/query_result.hpp>
+#include <superior_mysqlpp/types/date.hpp>
+#include <superior_mysqlpp/types/time.hpp>
+#include <superior_mysqlpp/types/datetime.hpp>
+#include <superior_mysqlpp/types/nullable.hpp>
+
+
+/*
+ * Export of results through Apache Arrow C Data Interface
+ * (https://arrow.apache.org/docs/format/CDataInterface.html).
+ *
+ * Result is exported as struct array with one child per column. Buffers of ColumnarResult
+ * already have Arrow layout, so they are handed over without copying. Rows of UseQueryResult
+ * and PreparedStatement are appended to Arrow buffers as they are fetched, without intermediate
+ * ColumnarResult. Buffers are freed by the release callbacks. libarrow is not required.
+ */
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C"
+{
+    struct ArrowSchema
+    {
+        // Array type description
+        const char* format;
+        const char* name;
+        const char* metadata;
+        int64_t flags;
+        int64_t n_children;
+        struct ArrowSchema** children;
+        struct ArrowSchema* dictionary;
+
+        // Release callback
+        void (*release)(struct ArrowSchema*);
+        // Opaque producer-specific data
+        void* private_data;
+    };
+
+    struct ArrowArray
+    {
+        // Array data description
+        int64_t length;
+        int64_t null_count;
+        int64_t offset;
+        int64_t n_buffers;
+        int64_t n_children;
+        const void** buffers;
+        struct ArrowArray** children;
+        struct ArrowArray* dictionary;
+
+        // Release callback
+        void (*release)(struct ArrowArray*);
+        // Opaque producer-specific data
+        void* private_data;
+    };
+}
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+
+namespace SuperiorMySqlpp
+{
+    namespace detail
+    {
+        /**
+         * @return Arrow format string of column of given physical type.
+         */
+        inline const char* getArrowFormat(ColumnType type, bool binary) noexcept
+        {
+            switch (type)
+            {
+                case ColumnType::int64:
+                    return "l";
+                case ColumnType::uint64:
+                    return "L";
+                case ColumnType::float64:
+                    return "g";
+                case ColumnType::string:
+                    // Offsets are 64-bit
+                    return binary? "Z" : "U";
+            }
+            return "U";
+        }
+
+        /**
+         * @return Arrow format string of column.
+         */
+        inline const char* getArrowFormat(const ColumnarResult::Column& column) noexcept
+        {
+            return getArrowFormat(column.getType(), column.isBinary());
+        }
+
+        struct ArrowSchemaPrivateData
+        {
+            std::string name{};
+            std::vector<ArrowSchema> children{};
+            std::vector<ArrowSchema*> childrenPointers{};
+        };
+
+        inline void releaseArrowSchema(ArrowSchema* schema) noexcept
+        {
+            std::unique_ptr<ArrowSchemaPrivateData> privateData{static_cast<ArrowSchemaPrivateData*>(schema->private_data)};
+            for (auto&& child: privateData->children)
+            {
+                // Children may have been moved out by consumer
+                if (child.release != nullptr)
+                {
+                    child.release(&child);
+                }
+            }
+            schema->release = nullptr;
+        }
+
+        inline void initializeArrowSchema(ArrowSchema& schema, const char* format, std::unique_ptr<ArrowSchemaPrivateData> privateData, std::int64_t flags) noexcept
+        {
+            schema.format = format;
+            schema.name = privateData->name.c_str();
+            schema.metadata = nullptr;
+            schema.flags = flags;
+            schema.n_children = static_cast<std::int64_t>(privateData->children.size());
+            schema.children = privateData->childrenPointers.data();
+            schema.dictionary = nullptr;
+            schema.release = &releaseArrowSchema;
+            schema.private_data = privateData.release();
+        }
+
+
+        struct ArrowArrayPrivateData
+        {
+            /** Owner of the buffers of column array. */
+            std::shared_ptr<void> owner{};
+            const void* buffers[3] = {nullptr, nullptr, nullptr};
+            std::vector<ArrowArray> children{};
+            std::vector<ArrowArray*> childrenPointers{};
+        };
+
+        inline void releaseArrowArray(ArrowArray* array) noexcept
+        {
+            std::unique_ptr<ArrowArrayPrivateData> privateData{static_cast<ArrowArrayPrivateData*>(array->private_data)};
+            for (auto&& child: privateData->children)
+            {
+                if (child.release != nullptr)
+                {
+                    child.release(&child);
+                }
+            }
+            array->release = nullptr;
+        }
+
+        inline void initializeArrowArray(ArrowArray& array, std::unique_ptr<ArrowArrayPrivateData> privateData,
+                                         std::size_t length, std::size_t nullCount, std::int64_t buffersCount) noexcept
+        {
+            array.length = static_cast<std::int64_t>(length);
+            array.null_count = static_cast<std::int64_t>(nullCount);
+            array.offset = 0;
+            array.n_buffers = buffersCount;
+            array.n_children = static_cast<std::int64_t>(privateData->children.size());
+            array.buffers = privateData->buffers;
+            array.children = privateData->childrenPointers.data();
+            array.dictionary = nullptr;
+            array.release = &releaseArrowArray;
+            array.private_data = privateData.release();
+        }
+
+        /**
+         * Releases exported children owned by parent private data unless committed.
+         */
+        template<typename ArrowStructure>
+        class ArrowChildrenGuard
+        {
+        private:
+            std::vector<ArrowStructure>& children;
+            bool committed = false;
+
+        public:
+            explicit ArrowChildrenGuard(std::vector<ArrowStructure>& children) noexcept
+                : children{children}
+            {
+            }
+
+            ArrowChildrenGuard(const ArrowChildrenGuard&) = delete;
+            ArrowChildrenGuard& operator=(const ArrowChildrenGuard&) = delete;
+
+            ~ArrowChildrenGuard()
+            {
+                if (!committed)
+                {
+                    for (auto&& child: children)
+                    {
+                        if (child.release != nullptr)
+                        {
+                            child.release(&child);
+                        }
+                    }
+                }
+            }
+
+            void commit() noexcept
+            {
+                committed = true;
+            }
+        };
+
+        inline void exportArrowColumn(ArrowArray& array, ColumnarResult::Column&& column)
+        {
+            std::unique_ptr<ArrowArrayPrivateData> privateData{new ArrowArrayPrivateData{}};
+            // Column must be moved before its buffers are referenced (short strings do not keep their address)
+            auto ownedColumn = std::make_shared<ColumnarResult::Column>(std::move(column));
+            privateData->buffers[0] = ownedColumn->getNullCount() == 0? nullptr : ownedColumn->getValidityBitmap().data();
+            std::int64_t buffersCount = 2;
+            switch (ownedColumn->getType())
+            {
+                case ColumnType::int64:
+                    privateData->buffers[1] = ownedColumn->getInt64Values().data();
+                    break;
+                case ColumnType::uint64:
+                    privateData->buffers[1] = ownedColumn->getUint64Values().data();
+                    break;
+                case ColumnType::float64:
+                    privateData->buffers[1] = ownedColumn->getDoubleValues().data();
+                    break;
+                case ColumnType::string:
+                    buffersCount = 3;
+                    privateData->buffers[1] = ownedColumn->getOffsets().data();
+                    privateData->buffers[2] = ownedColumn->getBytes().data();
+                    break;
+            }
+            auto length = ownedColumn->size();
+            auto nullCount = ownedColumn->getNullCount();
+            privateData->owner = std::move(ownedColumn);
+            initializeArrowArray(array, std::move(privateData), length, nullCount, buffersCount);
+        }
+
+
+        /**
+         * Name and Arrow format of exported column.
+         */
+        struct ArrowFieldDescription
+        {
+            std::string name;
+            /** Static string. */
+            const char* format;
+        };
+
+        /**
+         * Describes columns as Arrow struct type.
+         */
+        inline void exportArrowStructSchema(std::vector<ArrowFieldDescription>&& fields, ArrowSchema* schema)
+        {
+            std::unique_ptr<ArrowSchemaPrivateData> privateData{new ArrowSchemaPrivateData{}};
+            privateData->children.resize(fields.size());
+            privateData->childrenPointers.reserve(fields.size());
+
+            // Children are owned by privateData, release them on failure
+            ArrowChildrenGuard<ArrowSchema> guard{privateData->children};
+            for (std::size_t i=0; i<fields.size(); ++i)
+            {
+                auto& child = privateData->children[i];
+                std::unique_ptr<ArrowSchemaPrivateData> childPrivateData{new ArrowSchemaPrivateData{}};
+                childPrivateData->name = std::move(fields[i].name);
+                initializeArrowSchema(child, fields[i].format, std::move(childPrivateData), ARROW_FLAG_NULLABLE);
+                privateData->childrenPointers.push_back(&child);
+            }
+
+            guard.commit();
+            initializeArrowSchema(*schema, "+s", std::move(privateData), 0);
+        }
+
+        /**
+         * Exports struct array of columns.
+         * @param exportChildren Callable exporting all columns into given array of childrenCount children.
+         */
+        template<typename ExportChildren>
+        inline void exportArrowStructArray(ArrowArray* array, std::size_t rowsCount, std::size_t childrenCount, ExportChildren&& exportChildren)
+        {
+            std::unique_ptr<ArrowArrayPrivateData> privateData{new ArrowArrayPrivateData{}};
+            privateData->children.resize(childrenCount);
+            privateData->childrenPointers.reserve(childrenCount);
+
+            ArrowChildrenGuard<ArrowArray> guard{privateData->children};
+            exportChildren(privateData->children.data());
+            for (auto&& child: privateData->children)
+            {
+                privateData->childrenPointers.push_back(&child);
+            }
+            guard.commit();
+
+            // Struct array has only validity buffer; rows themselves are never NULL
+            initializeArrowArray(*array, std::move(privateData), rowsCount, 0, 1);
+        }
+
+        /**
+         * Exports both schema and struct array, schema is released when export of array fails.
+         */
+        template<typename ExportChildren>
+        inline void exportArrowStruct(std::vector<ArrowFieldDescription>&& fields, std::size_t rowsCount, ExportChildren&& exportChildren,
+                                      ArrowSchema* schema, ArrowArray* array)
+        {
+            auto childrenCount = fields.size();
+            exportArrowStructSchema(std::move(fields), schema);
+            try
+            {
+                exportArrowStructArray(array, rowsCount, childrenCount, std::forward<ExportChildren>(exportChildren));
+            }
+            catch (...)
+            {
+                schema->release(schema);
+                throw;
+            }
+        }
+
+
+        /**
+         * Validity bitmap of column being filled row by row.
+         */
+        class ArrowValidityBuilder
+        {
+        protected:
+            std::size_t rowsCount = 0;
+            std::size_t nullCount = 0;
+            std::vector<std::uint8_t> validity{};
+
+        protected:
+            void appendValidity(bool valid)
+            {
+                if (rowsCount % 8 == 0)
+                {
+                    validity.push_back(0);
+                }
+                if (valid)
+                {
+                    validity.back() |= static_cast<std::uint8_t>(1u << (rowsCount % 8));
+                }
+                else
+                {
+                    ++nullCount;
+                }
+                ++rowsCount;
+            }
+
+            const void* getValidityBuffer() const noexcept
+            {
+                return nullCount == 0? nullptr : validity.data();
+            }
+
+        public:
+            std::size_t size() const noexcept
+            {
+                return rowsCount;
+            }
+
+            std::size_t getNullCount() const noexcept
+            {
+                return nullCount;
+            }
+        };
+
+        /**
+         * Arrow fixed width column (numbers, dates, timestamps, durations) being filled row by row.
+         */
+        template<typename T>
+        class ArrowFixedWidthBuilder : public ArrowValidityBuilder
+        {
+        private:
+            std::vector<T> values{};
+
+        public:
+            void append(T value)
+            {
+                appendValidity(true);
+                values.push_back(value);
+            }
+
+            void appendNull()
+            {
+                appendValidity(false);
+                values.push_back(T{});
+            }
+
+            /**
+             * Moves buffers into Arrow array; builder is left empty.
+             */
+            void exportTo(ArrowArray& array) &&
+            {
+                std::unique_ptr<ArrowArrayPrivateData> privateData{new ArrowArrayPrivateData{}};
+                auto owner = std::make_shared<ArrowFixedWidthBuilder>(std::move(*this));
+                privateData->buffers[0] = owner->getValidityBuffer();
+                privateData->buffers[1] = owner->values.data();
+                auto length = owner->rowsCount;
+                auto nullCount = owner->nullCount;
+                privateData->owner = std::move(owner);
+                initializeArrowArray(array, std::move(privateData), length, nullCount, 2);
+            }
+        };
+
+        /**
+         * Arrow large (64-bit offsets) string or binary column being filled row by row.
+         */
+        class ArrowBinaryBuilder : public ArrowValidityBuilder
+        {
+        private:
+            std::vector<std::int64_t> offsets{0};
+            std::string bytes{};
+
+        public:
+            void append(const char* data, std::size_t length)
+            {
+                appendValidity(true);
+                bytes.append(data, length);
+                offsets.push_back(static_cast<std::int64_t>(bytes.size()));
+            }
+
+            void appendNull()
+            {
+                appendValidity(false);
+                offsets.push_back(static_cast<std::int64_t>(bytes.size()));
+            }
+
+            /**
+             * Moves buffers into Arrow array; builder is left empty.
+             */
+            void exportTo(ArrowArray& array) &&
+            {
+                std::unique_ptr<ArrowArrayPrivateData> privateData{new ArrowArrayPrivateData{}};
+                // Builder must be moved before its buffers are referenced (short strings do not keep their address)
+                auto owner = std::make_shared<ArrowBinaryBuilder>(std::move(*this));
+                privateData->buffers[0] = owner->getValidityBuffer();
+                privateData->buffers[1] = owner->offsets.data();
+                privateData->buffers[2] = owner->bytes.data();
+                auto length = owner->rowsCount;
+                auto nullCount = owner->nullCount;
+                privateData->owner = std::move(owner);
+                initializeArrowArray(array, std::move(privateData), length, nullCount, 3);
+            }
+        };
+
+
+        /**
+         * Column of UseQueryResult converted from text protocol as rows arrive.
+         * Physical types match ColumnarResult.
+         */
+        class ArrowTextColumnBuilder
+        {
+        private:
+            std::string name;
+            ColumnType type;
+            bool binary;
+            ArrowFixedWidthBuilder<std::int64_t> signedValues{};
+            ArrowFixedWidthBuilder<std::uint64_t> unsignedValues{};
+            ArrowFixedWidthBuilder<double> doubleValues{};
+            ArrowBinaryBuilder strings{};
+
+        private:
+            template<typename T>
+            void appendInteger(ArrowFixedWidthBuilder<T>& values, const char* data, unsigned long length)
+            {
+                // Field data are valid only until next row is fetched, so they are converted immediately
+                T value{};
+                if (!Converters::toIntegerBatch(&data, &length, 1, &value).isOk())
+                {
+                    throw OutOfRange{"Value of column \"" + name + "\" in row " + std::to_string(values.size())
+                                     + " is not a number in range of the column type!"};
+                }
+                values.append(value);
+            }
+
+        public:
+            ArrowTextColumnBuilder(std::string name, ColumnType type, bool binary)
+                : name{std::move(name)}, type{type}, binary{binary}
+            {
+            }
+
+            ArrowFieldDescription getDescription() const
+            {
+                return {name, getArrowFormat(type, binary)};
+            }
+
+            void append(const Field& field)
+            {
+                auto data = field.data();
+                switch (type)
+                {
+                    case ColumnType::int64:
+                        if (data == nullptr)
+                        {
+                            signedValues.appendNull();
+                        }
+                        else
+                        {
+                            appendInteger(signedValues, data, field.size());
+                        }
+                        break;
+                    case ColumnType::uint64:
+                        if (data == nullptr)
+                        {
+                            unsignedValues.appendNull();
+                        }
+                        else
+                        {
+                            appendInteger(unsignedValues, data, field.size());
+                        }
+                        break;
+                    case ColumnType::float64:
+                        if (data == nullptr)
+                        {
+                            doubleValues.appendNull();
+                        }
+                        else
+                        {
+                            doubleValues.append(Converters::to<double>(data, field.size()));
+                        }
+                        break;
+                    case ColumnType::string:
+                        if (data == nullptr)
+                        {
+                            strings.appendNull();
+                        }
+                        else
+                        {
+                            strings.append(data, field.size());
+                        }
+                        break;
+                }
+            }
+
+            void exportTo(ArrowArray& array) &&
+            {
+                switch (type)
+                {
+                    case ColumnType::int64:
+                        std::move(signedValues).exportTo(array);
+                        break;
+                    case ColumnType::uint64:
+                        std::move(unsignedValues).exportTo(array);
+                        break;
+                    case ColumnType::float64:
+                        std::move(doubleValues).exportTo(array);
+                        break;
+                    case ColumnType::string:
+                        std::move(strings).exportTo(array);
+                        break;
+                }
+            }
+        };
+
+
+        /**
+         * @return Arrow format string of C++ number type.
+         */
+        template<typename T>
+        inline const char* getArrowNumberFormat() noexcept
+        {
+            static_assert(sizeof(T) <= sizeof(std::uint64_t), "Number type must have at most 64 bits!");
+            if (std::is_floating_point<T>::value)
+            {
+                return sizeof(T) == sizeof(float)? "f" : "g";
+            }
+            switch (sizeof(T))
+            {
+                case 1:
+                    return std::is_signed<T>::value? "c" : "C";
+                case 2:
+                    return std::is_signed<T>::value? "s" : "S";
+                case 4:
+                    return std::is_signed<T>::value? "i" : "I";
+                default:
+                    return std::is_signed<T>::value? "l" : "L";
+            }
+        }
+
+        /**
+         * @return Days since 1970-01-01 of proleptic Gregorian calendar date.
+         */
+        inline std::int32_t toArrowDays(unsigned int year, unsigned int month, unsigned int day) noexcept
+        {
+            // Years start in March, so leap day is the last one
+            const int shiftedYear = static_cast<int>(year) - (month <= 2? 1 : 0);
+            const int era = (shiftedYear >= 0? shiftedYear : shiftedYear - 399) / 400;
+            const unsigned int yearOfEra = static_cast<unsigned int>(shiftedYear - era * 400);
+            const unsigned int dayOfYear = (153 * ((month + 9) % 12) + 2) / 5 + day - 1;
+            const unsigned int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            return era * 146097 + static_cast<int>(dayOfEra) - 719468;
+        }
+
+        template<typename T>
+        inline std::int64_t toArrowMicroseconds(const T& time) noexcept
+        {
+            return ((static_cast<std::int64_t>(time.getHour()) * 60 + time.getMinute()) * 60 + time.getSecond()) * 1000000
+                   + static_cast<std::int64_t>(time.getSecondFraction());
+        }
+
+        template<typename T>
+        inline bool isZeroDate(const T& date) noexcept
+        {
+            return date.getMonth() == 0 || date.getDay() == 0;
+        }
+
+        /**
+         * Describes how storage type T of prepared statement result is appended to Arrow column.
+         * Generic template, actual implementation is in specializations.
+         */
+        template<typename T, typename Enable=void>
+        struct ArrowResultColumn
+        {
+            static_assert(sizeof(T) == 0, "Result storage type can not be exported to Arrow!");
+        };
+
+        /**
+         * Integers and floats are stored in native width.
+         */
+        template<typename T>
+        struct ArrowResultColumn<T, std::enable_if_t<std::is_arithmetic<T>::value>>
+        {
+            using Builder = ArrowFixedWidthBuilder<T>;
+
+            static const char* getFormat() noexcept
+            {
+                return getArrowNumberFormat<T>();
+            }
+
+            static void append(Builder& builder, const T& value)
+            {
+                builder.append(value);
+            }
+        };
+
+        /**
+         * Decimals are exported as text, there is no lossless conversion to Arrow decimal of unknown precision.
+         */
+        template<typename T>
+        struct ArrowResultColumn<T, std::enable_if_t<CanBindAsResult<BindingTypes::String, T>::value ||
+                                                     CanBindAsResult<BindingTypes::Decimal, T>::value>>
+        {
+            using Builder = ArrowBinaryBuilder;
+
+            static const char* getFormat() noexcept
+            {
+                return "U";
+            }
+
+            static void append(Builder& builder, const T& value)
+            {
+                builder.append(value.data(), value.size());
+            }
+        };
+
+        template<typename T>
+        struct ArrowResultColumn<T, std::enable_if_t<CanBindAsResult<BindingTypes::Blob, T>::value>>
+        {
+            static_assert(!std::is_same<T, BlobStream>::value, "BlobStream is read after fetch and can not be exported to Arrow!");
+
+            using Builder = ArrowBinaryBuilder;
+
+            static const char* getFormat() noexcept
+            {
+                return "Z";
+            }
+
+            static void append(Builder& builder, const T& value)
+            {
+                builder.append(value.data(), value.size());
+            }
+        };
+
+        /**
+         * Date as date32; zero dates (0000-00-00) are not representable and are exported as NULL.
+         */
+        template<typename T>
+        struct ArrowResultColumn<T, std::enable_if_t<CanBindAsResult<BindingTypes::Date, T>::value>>
+        {
+            using Builder = ArrowFixedWidthBuilder<std::int32_t>;
+
+            static const char* getFormat() noexcept
+            {
+                return "tdD";
+            }
+
+            static void append(Builder& builder, const T& date)
+            {
+                if (isZeroDate(date))
+                {
+                    builder.appendNull();
+                }
+                else
+                {
+                    builder.append(toArrowDays(date.getYear(), date.getMonth(), date.getDay()));
+                }
+            }
+        };
+
+        /**
+         * Time as duration in microseconds, MySQL TIME exceeds range of day and can be negative.
+         */
+        template<typename T>
+        struct ArrowResultColumn<T, std::enable_if_t<CanBindAsResult<BindingTypes::Time, T>::value>>
+        {
+            using Builder = ArrowFixedWidthBuilder<std::int64_t>;
+
+            static const char* getFormat() noexcept
+            {
+                return "tDu";
+            }
+
+            static void append(Builder& builder, const T& time)
+            {
+                auto microseconds = toArrowMicroseconds(time);
+                builder.append(time.isNegative()? -microseconds : microseconds);
+            }
+        };
+
+        /**
+         * Datetime and timestamp as timestamp in microseconds without time zone (values are in session time zone);
+         * zero dates are exported as NULL.
+         */
+        template<typename T>
+        struct ArrowResultColumn<T, std::enable_if_t<CanBindAsResult<BindingTypes::Datetime, T>::value ||
+                                                     CanBindAsResult<BindingTypes::Timestamp, T>::value>>
+        {
+            using Builder = ArrowFixedWidthBuilder<std::int64_t>;
+
+            static const char* getFormat() noexcept
+            {
+                return "tsu:";
+            }
+
+            static void append(Builder& builder, const T& datetime)
+            {
+                if (isZeroDate(datetime))
+                {
+                    builder.appendNull();
+                }
+                else
+                {
+                    auto days = toArrowDays(datetime.getYear(), datetime.getMonth(), datetime.getDay());
+                    builder.append(static_cast<std::int64_t>(days) * 86400 * 1000000 + toArrowMicroseconds(datetime));
+                }
+            }
+        };
+
+        template<typename T>
+        struct ArrowResultColumn<Nullable<T>>
+        {
+            using Builder = typename ArrowResultColumn<T>::Builder;
+
+            static const char* getFormat() noexcept
+            {
+                return ArrowResultColumn<T>::getFormat();
+            }
+
+            static void append(Builder& builder, const Nullable<T>& value)
+            {
+                if (value)
+                {
+                    ArrowResultColumn<T>::append(builder, *value);
+                }
+                else
+                {
+                    builder.appendNull();
+                }
+            }
+        };
+
+        /**
+         * Columns of prepared statement result with storage types Types being filled as rows are fetched.
+         */
+        template<typename... Types>
+        class ArrowResultBuilders
+        {
+        private:
+            std::tuple<typename ArrowResultColumn<Types>::Builder...> builders{};
+
+        private:
+            template<std::size_t... I>
+            void append(const std::tuple<Types...>& row, std::index_sequence<I...>)
+            {
+                using Expander = int[];
+                (void) Expander{0, (ArrowResultColumn<Types>::append(std::get<I>(builders), std::get<I>(row)), 0)...};
+            }
+
+            template<std::size_t... I>
+            void exportTo(ArrowArray* children, std::index_sequence<I...>)
+            {
+                using Expander = int[];
+                (void) Expander{0, (std::move(std::get<I>(builders)).exportTo(children[I]), 0)...};
+            }
+
+        public:
+            /**
+             * @return Arrow formats of columns, static strings.
+             */
+            static std::vector<const char*> getFormats()
+            {
+                return {ArrowResultColumn<Types>::getFormat()...};
+            }
+
+            void append(const std::tuple<Types...>& row)
+            {
+                append(row, std::index_sequence_for<Types...>{});
+            }
+
+            /**
+             * Moves buffers of columns into sizeof...(Types) children arrays.
+             */
+            void exportTo(ArrowArray* children) &&
+            {
+                exportTo(children, std::index_sequence_for<Types...>{});
+            }
+        };
+    }
+
+
+    /**
+     * Describes columns of result as Arrow struct type.
+     *
+     * @param result Converted result.
+     * @param schema Output; must be released by consumer (schema->release).
+     */
+    inline void exportArrowSchema(const ColumnarResult& result, ArrowSchema* schema)
+    {
+        std::vector<detail::ArrowFieldDescription> fields{};
+        fields.reserve(result.getColumnsCount());
+        for (auto&& column: result)
+        {
+            fields.push_back({column.getName(), detail::getArrowFormat(column)});
+        }
+        detail::exportArrowStructSchema(std::move(fields), schema);
+    }
+
+    /**
+     * Moves buffers of result into Arrow struct array without copying; result is left empty.
+     *
+     * @param result Converted result.
+     * @param array Output; must be released by consumer (array->release).
+     */
+    inline void exportArrowArray(ColumnarResult&& result, ArrowArray* array)
+    {
+        auto rowsCount = result.getRowsCount();
+        auto columns = result.releaseColumns();
+        detail::exportArrowStructArray(array, rowsCount, columns.size(), [&](ArrowArray* children){
+            for (std::size_t i=0; i<columns.size(); ++i)
+            {
+                detail::exportArrowColumn(children[i], std::move(columns[i]));
+            }
+        });
+    }
+
+    /**
+     * Exports both schema and data of result.
+     * @see exportArrowSchema, exportArrowArray
+     */
+    inline void exportArrow(ColumnarResult&& result, ArrowSchema* schema, ArrowArray* array)
+    {
+        exportArrowSchema(result, schema);
+        try
+        {
+            exportArrowArray(std::move(result), array);
+        }
+        catch (...)
+        {
+            schema->release(schema);
+            throw;
+        }
+    }
+
+    /**
+     * Fetches all remaining rows of result and appends their fields directly into Arrow buffers
+     * as they arrive (no ColumnarResult nor stored result is built). Columns have the same types as
+     * ColumnarResult would have.
+     *
+     * @param result Result of query in use mode.
+     * @param schema Output; must be released by consumer (schema->release).
+     * @param array Output; must be released by consumer (array->release).
+     * @throws OutOfRange When integer column contains value which is not a number in range of its type.
+     */
+    inline void exportArrow(UseQueryResult& result, ArrowSchema* schema, ArrowArray* array)
+    {
+        std::vector<detail::ArrowTextColumnBuilder> columns{};
+        columns.reserve(result.getMetadata().size());
+        for (auto&& field: result.getMetadata())
+        {
+            columns.emplace_back(field.getColumnName(), getColumnType(field), isBinaryField(field));
+        }
+
+        std::size_t rowsCount = 0;
+        while (auto row = result.fetchRow())
+        {
+            for (std::size_t i=0; i<columns.size(); ++i)
+            {
+                columns[i].append(row[static_cast<unsigned int>(i)]);
+            }
+            ++rowsCount;
+        }
+
+        std::vector<detail::ArrowFieldDescription> fields{};
+        fields.reserve(columns.size());
+        for (auto&& column: columns)
+        {
+            fields.push_back(column.getDescription());
+        }
+        detail::exportArrowStruct(std::move(fields), rowsCount, [&](ArrowArray* children){
+            for (std::size_t i=0; i<columns.size(); ++i)
+            {
+                std::move(columns[i]).exportTo(children[i]);
+            }
+        }, schema, array);
+    }
+
+    /**
+     * Fetches all remaining rows of executed statement and appends values of result bindings
+     * directly into Arrow buffers after each fetch (no ColumnarResult is built).
+     *
+     * Numbers keep their native width, strings and decimals are exported as large utf8,
+     * blobs as large binary, Date as date32, Time as duration and Datetime or Timestamp as timestamp
+     * in microseconds. Nullable storage makes values NULL, zero dates are exported as NULL too.
+     * BlobStream is not supported.
+     *
+     * @param preparedStatement Executed statement.
+     * @param schema Output; must be released by consumer (schema->release).
+     * @param array Output; must be released by consumer (array->release).
+     */
+    template<typename... ResultTypes, typename ParamBindings, bool storeResult, ValidateMetadataMode validateMode,
+             ValidateMetadataMode warnMode, bool ignoreNullable, CursorMode cursorMode>
+    inline void exportArrow(PreparedStatement<ResultBindings<ResultTypes...>, ParamBindings, storeResult, validateMode, warnMode, ignoreNullable, cursorMode>& preparedStatement,
+                            ArrowSchema* schema, ArrowArray* array)
+    {
+        using Builders = detail::ArrowResultBuilders<ResultTypes...>;
+
+        Builders builders{};
+        std::size_t rowsCount = 0;
+        while (preparedStatement.fetch())
+        {
+            builders.append(preparedStatement.getResult());
+            ++rowsCount;
+        }
+
+        auto formats = Builders::getFormats();
+        std::vector<detail::ArrowFieldDescription> fields{};
+        fields.reserve(formats.size());
+        // Fields count of executed statement was checked to match result bindings
+        for (auto&& field: preparedStatement.getResultMetadata())
+        {
+            auto index = fields.size();
+            fields.push_back({field.getColumnName(), formats[index]});
+        }
+
+        detail::exportArrowStruct(std::move(fields), rowsCount, [&](ArrowArray* children){
+            std::move(builders).exportTo(children);
+        }, schema, array);
+    }
+}
@@ -0,0 +1,179 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#include <superior_mysqlpp/types/string_view.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Column index resolved once by name (see QueryResult::getColumnHandle).
+     * Accessing row by handle costs the same as accessing it by index.
+     */
+    class ColumnHandle
+    {
+    private:
+        std::size_t index;
+
+    public:
+        constexpr explicit ColumnHandle(std::size_t index) noexcept
+            : index{index}
+        {
+        }
+
+        constexpr std::size_t getIndex() const noexcept
+        {
+            return index;
+        }
+
+        constexpr operator std::size_t() const noexcept
+        {
+            return index;
+        }
+    };
+
+
+    namespace detail
+    {
+        /**
+         * Open addressing hash table mapping column names to their indexes.
+         *
+         * Table is built once from result metadata and never modified, so it uses linear probing
+         * with load factor at most 1/2 and stores a part of the hash next to the index
+         * to compare names only on probable match.
+         */
+        class ColumnNameIndex
+        {
+        private:
+            struct Slot
+            {
+                std::uint32_t hash;
+                /** Column index + 1; 0 marks empty slot. */
+                std::uint32_t position;
+            };
+
+            std::vector<Slot> slots{};
+            std::vector<StringView> names{};
+            std::size_t mask = 0;
+
+        public:
+            /**
+             * Hashes 8 bytes per step; only the resulting value matters, so byte order is not fixed.
+             */
+            static std::uint64_t hash(StringView name) noexcept
+            {
+                constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15u;
+                auto data = name.data();
+                auto length = name.size();
+                std::uint64_t result = length * multiplier;
+                for (; length >= 8; data += 8, length -= 8)
+                {
+                    std::uint64_t word;
+                    std::memcpy(&word, data, sizeof(word));
+                    result = (result ^ word) * multiplier;
+                    result ^= result >> 29;
+                }
+                if (length > 0)
+                {
+                    // Variable length memcpy would be a library call
+                    std::uint64_t word = 0;
+                    for (std::size_t i=0; i<length; ++i)
+                    {
+                        word |= std::uint64_t{static_cast<unsigned char>(data[i])} << (8 * i);
+                    }
+                    result = (result ^ word) * multiplier;
+                    result ^= result >> 29;
+                }
+                // Multiplication mixes only towards high bits, slot is chosen by the low ones
+                result *= multiplier;
+                return result ^ (result >> 32);
+            }
+
+        private:
+            static std::uint32_t getTag(std::uint64_t hashValue) noexcept
+            {
+                return static_cast<std::uint32_t>(hashValue >> 32);
+            }
+
+        public:
+            ColumnNameIndex() = default;
+
+            /**
+             * @param columnNames Names in column order; referenced data must outlive this object.
+             * When names repeat, the first column is found.
+             */
+            explicit ColumnNameIndex(std::vector<StringView> columnNames)
+                : names{std::move(columnNames)}
+            {
+                std::size_t capacity = 2;
+                while (capacity < names.size() * 2)
+                {
+                    capacity *= 2;
+                }
+                slots.assign(capacity, Slot{0, 0});
+                mask = capacity - 1;
+
+                for (std::size_t i=0; i<names.size(); ++i)
+                {
+                    auto hashValue = hash(names[i]);
+                    auto tag = getTag(hashValue);
+                    for (auto j=static_cast<std::size_t>(hashValue) & mask; ; j=(j+1) & mask)
+                    {
+                        auto& slot = slots[j];
+                        if (slot.position == 0)
+                        {
+                            slot.hash = tag;
+                            slot.position = static_cast<std::uint32_t>(i + 1);
+                            break;
+                        }
+                        if (slot.hash == tag && names[slot.position - 1] == names[i])
+                        {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            /**
+             * @return Index of column or size() when there is no such column.
+             */
+            std::size_t find(StringView columnName) const noexcept
+            {
+                if (slots.empty())
+                {
+                    return names.size();
+                }
+
+                auto hashValue = hash(columnName);
+                auto tag = getTag(hashValue);
+                for (auto j=static_cast<std::size_t>(hashValue) & mask; ; j=(j+1) & mask)
+                {
+                    auto& slot = slots[j];
+                    if (slot.position == 0)
+                    {
+                        return names.size();
+                    }
+                    if (slot.hash == tag && names[slot.position - 1] == columnName)
+                    {
+                        return slot.position - 1;
+                    }
+                }
+            }
+
+            std::size_t size() const noexcept
+            {
+                return names.size();
+            }
+        };
+    }
+}
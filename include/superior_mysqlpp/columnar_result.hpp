@@ -0,0 +1,438 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_integer_batch.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/field_types.hpp>
+#include <superior_mysqlpp/query_result.hpp>
+#include <superior_mysqlpp/types/string_view.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Physical representation of ColumnarResult column.
+     */
+    enum class ColumnType
+    {
+        /** Signed integers (TINYINT to BIGINT, YEAR); std::int64_t values. */
+        int64,
+        /** Unsigned integers; std::uint64_t values. */
+        uint64,
+        /** FLOAT and DOUBLE; double values. */
+        float64,
+        /** Everything else (strings, blobs, decimals, temporal types) as received in text protocol; offsets and bytes. */
+        string,
+    };
+
+    /**
+     * Chooses physical column type for result field.
+     */
+    inline ColumnType getColumnType(const ResultField& field)
+    {
+        switch (field.getFieldType())
+        {
+            case FieldTypes::Tiny:
+            case FieldTypes::Short:
+            case FieldTypes::Int24:
+            case FieldTypes::Long:
+            case FieldTypes::LongLong:
+            case FieldTypes::Year:
+                return field.isUnsigned()? ColumnType::uint64 : ColumnType::int64;
+
+            case FieldTypes::Float:
+            case FieldTypes::Double:
+                return ColumnType::float64;
+
+            case FieldTypes::Decimal:
+            case FieldTypes::NewDecimal:
+            case FieldTypes::Time:
+            case FieldTypes::Date:
+            case FieldTypes::Datetime:
+            case FieldTypes::Timestamp:
+            case FieldTypes::String:
+            case FieldTypes::VarString:
+            case FieldTypes::Enum:
+            case FieldTypes::Set:
+            case FieldTypes::Bit:
+            case FieldTypes::Blob:
+            case FieldTypes::TinyBlob:
+            case FieldTypes::MediumBlob:
+            case FieldTypes::LongBlob:
+            case FieldTypes::Geometry:
+            case FieldTypes::Null:
+                return ColumnType::string;
+        }
+        return ColumnType::string;
+    }
+
+    /**
+     * @return True for fields holding binary data (binary character set), e.g. BLOB or VARBINARY.
+     */
+    inline bool isBinaryField(const ResultField& field)
+    {
+        // Number of MySQL "binary" character set
+        return field.getCharacterSetNumber() == 63;
+    }
+
+
+    /**
+     * Stored result converted into one contiguous vector per column.
+     *
+     * Every column has validity bitmap (bit i set when row i is not NULL, least significant bit first).
+     * Numeric columns hold values in typed vectors (NULL rows contain 0), string columns hold
+     * rows.size()+1 offsets into a single byte buffer (same layout as Apache Arrow uses).
+     */
+    class ColumnarResult
+    {
+    public:
+        class Column
+        {
+        private:
+            std::string name;
+            ColumnType type;
+            FieldTypes fieldType;
+            bool binary;
+            std::size_t rowsCount = 0;
+            std::size_t nullCount = 0;
+            std::vector<std::uint8_t> validity{};
+            std::vector<std::int64_t> signedValues{};
+            std::vector<std::uint64_t> unsignedValues{};
+            std::vector<double> doubleValues{};
+            std::vector<std::int64_t> offsets{};
+            std::string bytes{};
+            /** Integer fields waiting for batch conversion. */
+            std::vector<const char*> pendingValues{};
+            std::vector<unsigned long> pendingLengths{};
+
+            friend class ColumnarResult;
+
+            static constexpr std::size_t integerBatchSize = 256;
+
+        private:
+            template<typename T>
+            void convertPendingIntegers(std::vector<T>& values)
+            {
+                auto offset = values.size();
+                values.resize(offset + pendingValues.size());
+                auto report = Converters::toIntegerBatch(pendingValues.data(), pendingLengths.data(), pendingValues.size(), values.data() + offset);
+                if (!report.isOk())
+                {
+                    auto row = rowsCount - pendingValues.size() + report.firstErrorIndex;
+                    throw OutOfRange{"Value of column \"" + name + "\" in row " + std::to_string(row)
+                                     + " is not a number in range of the column type!"};
+                }
+                pendingValues.clear();
+                pendingLengths.clear();
+            }
+
+            void flush()
+            {
+                if (type == ColumnType::int64)
+                {
+                    convertPendingIntegers(signedValues);
+                }
+                else if (type == ColumnType::uint64)
+                {
+                    convertPendingIntegers(unsignedValues);
+                }
+            }
+
+            void reserve(std::size_t rows)
+            {
+                validity.reserve((rows + 7) / 8);
+                switch (type)
+                {
+                    case ColumnType::int64:
+                        signedValues.reserve(rows);
+                        pendingValues.reserve(integerBatchSize);
+                        pendingLengths.reserve(integerBatchSize);
+                        break;
+                    case ColumnType::uint64:
+                        unsignedValues.reserve(rows);
+                        pendingValues.reserve(integerBatchSize);
+                        pendingLengths.reserve(integerBatchSize);
+                        break;
+                    case ColumnType::float64:
+                        doubleValues.reserve(rows);
+                        break;
+                    case ColumnType::string:
+                        offsets.reserve(rows + 1);
+                        break;
+                }
+            }
+
+            void append(const char* data, unsigned long length)
+            {
+                if (rowsCount % 8 == 0)
+                {
+                    validity.push_back(0);
+                }
+                if (data == nullptr)
+                {
+                    ++nullCount;
+                }
+                else
+                {
+                    validity.back() |= static_cast<std::uint8_t>(1u << (rowsCount % 8));
+                }
+                ++rowsCount;
+
+                switch (type)
+                {
+                    case ColumnType::int64:
+                    case ColumnType::uint64:
+                        // Converted by batches, data of stored rows stay valid
+                        pendingValues.push_back(data);
+                        pendingLengths.push_back(length);
+                        if (pendingValues.size() == integerBatchSize)
+                        {
+                            flush();
+                        }
+                        break;
+                    case ColumnType::float64:
+                        doubleValues.push_back(data == nullptr? 0.0 : Converters::to<double>(data, length));
+                        break;
+                    case ColumnType::string:
+                        if (data != nullptr)
+                        {
+                            bytes.append(data, length);
+                        }
+                        offsets.push_back(static_cast<std::int64_t>(bytes.size()));
+                        break;
+                }
+            }
+
+            void checkType(ColumnType expected) const
+            {
+                if (type != expected)
+                {
+                    throw LogicError{"Column \"" + name + "\" does not hold requested type!"};
+                }
+            }
+
+        public:
+            Column(std::string name, ColumnType type, FieldTypes fieldType, bool binary=false)
+                : name{std::move(name)}, type{type}, fieldType{fieldType}, binary{binary}
+            {
+                if (type == ColumnType::string)
+                {
+                    offsets.push_back(0);
+                }
+            }
+
+            const std::string& getName() const noexcept
+            {
+                return name;
+            }
+
+            ColumnType getType() const noexcept
+            {
+                return type;
+            }
+
+            FieldTypes getFieldType() const noexcept
+            {
+                return fieldType;
+            }
+
+            /**
+             * @return True for string columns holding binary data (binary character set).
+             */
+            bool isBinary() const noexcept
+            {
+                return binary;
+            }
+
+            std::size_t size() const noexcept
+            {
+                return rowsCount;
+            }
+
+            std::size_t getNullCount() const noexcept
+            {
+                return nullCount;
+            }
+
+            bool isNull(std::size_t row) const noexcept
+            {
+                return !(validity[row / 8] & (1u << (row % 8)));
+            }
+
+            const std::vector<std::uint8_t>& getValidityBitmap() const noexcept
+            {
+                return validity;
+            }
+
+            /**
+             * @throws LogicError When column is not ColumnType::int64.
+             */
+            const std::vector<std::int64_t>& getInt64Values() const
+            {
+                checkType(ColumnType::int64);
+                return signedValues;
+            }
+
+            /**
+             * @throws LogicError When column is not ColumnType::uint64.
+             */
+            const std::vector<std::uint64_t>& getUint64Values() const
+            {
+                checkType(ColumnType::uint64);
+                return unsignedValues;
+            }
+
+            /**
+             * @throws LogicError When column is not ColumnType::float64.
+             */
+            const std::vector<double>& getDoubleValues() const
+            {
+                checkType(ColumnType::float64);
+                return doubleValues;
+            }
+
+            /**
+             * String of row i spans bytes [offsets[i], offsets[i+1]).
+             * @throws LogicError When column is not ColumnType::string.
+             */
+            const std::vector<std::int64_t>& getOffsets() const
+            {
+                checkType(ColumnType::string);
+                return offsets;
+            }
+
+            /**
+             * @throws LogicError When column is not ColumnType::string.
+             */
+            const std::string& getBytes() const
+            {
+                checkType(ColumnType::string);
+                return bytes;
+            }
+
+            /**
+             * @return Value of string column; empty for NULL.
+             */
+            StringView getString(std::size_t row) const
+            {
+                checkType(ColumnType::string);
+                return {bytes.data() + offsets[row], static_cast<std::size_t>(offsets[row + 1] - offsets[row])};
+            }
+        };
+
+    private:
+        std::vector<Column> columns{};
+        std::size_t rowsCount = 0;
+
+    public:
+        /**
+         * Converts all remaining rows of result.
+         *
+         * @throws OutOfRange When integer column contains value which is not a number in range of its type.
+         */
+        explicit ColumnarResult(StoreQueryResult& result)
+        {
+            auto& metadata = result.getMetadata();
+            columns.reserve(metadata.size());
+            for (auto&& field: metadata)
+            {
+                columns.emplace_back(field.getColumnName(), getColumnType(field), field.getFieldType(), isBinaryField(field));
+            }
+
+            auto& lowLevelResult = result.detail_getResult();
+            auto expectedRowsCount = static_cast<std::size_t>(lowLevelResult.getRowsCount());
+            for (auto&& column: columns)
+            {
+                column.reserve(expectedRowsCount);
+            }
+
+            const auto columnsCount = columns.size();
+            while (auto row = lowLevelResult.fetchRow())
+            {
+                auto lengths = lowLevelResult.fetchLengths();
+                for (std::size_t i=0; i<columnsCount; ++i)
+                {
+                    columns[i].append(row[i], lengths[i]);
+                }
+                ++rowsCount;
+            }
+            for (auto&& column: columns)
+            {
+                column.flush();
+            }
+        }
+
+        explicit ColumnarResult(StoreQueryResult&& result)
+            : ColumnarResult{result}
+        {
+        }
+
+        ColumnarResult(ColumnarResult&&) = default;
+        ColumnarResult& operator=(ColumnarResult&&) = default;
+
+        ColumnarResult(const ColumnarResult&) = delete;
+        ColumnarResult& operator=(const ColumnarResult&) = delete;
+
+        std::size_t getRowsCount() const noexcept
+        {
+            return rowsCount;
+        }
+
+        std::size_t getColumnsCount() const noexcept
+        {
+            return columns.size();
+        }
+
+        const Column& operator[](std::size_t index) const
+        {
+            return columns[index];
+        }
+
+        /**
+         * @throws OutOfRange When there is no column with given name.
+         */
+        const Column& getColumn(StringView columnName) const
+        {
+            auto it = std::find_if(columns.begin(), columns.end(), [&](const Column& column){
+                return StringView{column.getName()} == columnName;
+            });
+            if (it == columns.end())
+            {
+                throw OutOfRange{"Column name \"" + std::string(columnName) + "\" not found!"};
+            }
+            return *it;
+        }
+
+        /**
+         * Moves columns out of this object (e.g. to hand their buffers over without copying).
+         */
+        std::vector<Column> releaseColumns()
+        {
+            auto released = std::move(columns);
+            columns.clear();
+            rowsCount = 0;
+            return released;
+        }
+
+        auto begin() const noexcept
+        {
+            return columns.cbegin();
+        }
+
+        auto end() const noexcept
+        {
+            return columns.cend();
+        }
+    };
+}
@@ -19,13 +19,15 @@ namespace SuperiorMySqlpp
              ValidateMetadataMode validateMode,
              ValidateMetadataMode warnMode,
              bool ignoreNullable,
+             CursorMode cursorMode,
              typename... Args>
     PreparedStatement<RBindings,
                       ParamBindings<std::decay_t<Args>...>,
                       storeResult,
                       validateMode,
                       warnMode,
-                      ignoreNullable
+                      ignoreNullable,
+                      cursorMode
                       > Connection::makePreparedStatement(const std::string& query, Args&&... args) &
     {
         return {*this, query, std::forward<Args>(args)...};
@@ -37,6 +39,7 @@ namespace SuperiorMySqlpp
              ValidateMetadataMode validateMode,
              ValidateMetadataMode warnMode,
              bool ignoreNullable,
+             CursorMode cursorMode,
              template<typename...> class RArgsTuple, template<typename...> class PArgsTuple,
              typename... RArgs, typename... PArgs>
     PreparedStatement<RBindings,
@@ -44,7 +47,8 @@ namespace SuperiorMySqlpp
                       storeResult,
                       validateMode,
                       warnMode,
-                      ignoreNullable
+                      ignoreNullable,
+                      cursorMode
                       > Connection::makePreparedStatement(const std::string& query,
                                                           FullInitTag tag, RArgsTuple<RArgs...>&& resultArgs,
                                                           PArgsTuple<PArgs...>&& paramArgs) &
@@ -59,6 +63,38 @@ namespace SuperiorMySqlpp
         return {*this, query};
     }
 
+    template<typename PreparedStatementType>
+    CachedPreparedStatement<PreparedStatementType> Connection::checkoutPreparedStatement(const std::string& query) &
+    {
+        return statementCache.checkout<PreparedStatementType>(driver, query);
+    }
+
+
+    template<typename RBindings,
+             bool storeResult,
+             ValidateMetadataMode validateMode,
+             ValidateMetadataMode warnMode,
+             bool ignoreNullable,
+             typename... Args>
+    CachedPreparedStatement<PreparedStatement<RBindings,
+                                              ParamBindings<std::decay_t<Args>...>,
+                                              storeResult,
+                                              validateMode,
+                                              warnMode,
+                                              ignoreNullable
+                                              >> Connection::makeCachedPreparedStatement(const std::string& query, Args&&... args) &
+    {
+        using PreparedStatementType = PreparedStatement<RBindings, ParamBindings<std::decay_t<Args>...>,
+                                                        storeResult, validateMode, warnMode, ignoreNullable>;
+        auto statement = checkoutPreparedStatement<PreparedStatementType>(query);
+        if (sizeof...(Args) > 0)
+        {
+            statement->getParams() = std::forward_as_tuple(std::forward<Args>(args)...);
+            statement->updateParamsBindings();
+        }
+        return statement;
+    }
+
     template<typename... Args>
     Query Connection::makeQuery(Args&&... args) &
     {
@@ -14,6 +14,8 @@
 #include <superior_mysqlpp/prepared_statement_fwd.hpp>
 #include <superior_mysqlpp/dynamic_prepared_statement_fwd.hpp>
 #include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/load_data.hpp>
+#include <superior_mysqlpp/statement_cache.hpp>
 #include <superior_mysqlpp/types/tags.hpp>
 #include <superior_mysqlpp/types/optional.hpp>
 #include <superior_mysqlpp/config.hpp>
@@ -31,8 +33,20 @@ namespace SuperiorMySqlpp
     {
     protected:
         LowLevel::DBDriver driver;
+        /** Declared after driver, so idle statements are closed while connection is still open. */
+        StatementCache statementCache{};
 
     protected:
+        /**
+         * Statements are bound to MYSQL handle which does not survive the move of driver,
+         * cached ones are closed before.
+         */
+        LowLevel::DBDriver&& releaseDriver() noexcept
+        {
+            statementCache.clear();
+            return std::move(driver);
+        }
+
         inline void setSslConfiguration(const SslConfiguration& sslConfig) noexcept
         {
             driver.setSsl(sslConfig.keyPath, sslConfig.certificatePath, sslConfig.certificationAuthorityPath,
@@ -184,7 +198,10 @@ namespace SuperiorMySqlpp
         Connection(const Connection&) = delete;
         Connection& operator=(const Connection&) = delete;
 
-        Connection(Connection&&) = default;
+        Connection(Connection&& other)
+            : driver{other.releaseDriver()}, statementCache{other.statementCache.getCapacity()}
+        {
+        }
         Connection& operator=(Connection&&) = default;
 
 
@@ -215,13 +232,15 @@ namespace SuperiorMySqlpp
                  ValidateMetadataMode validateMode=detail::PreparedStatementsDefault::getValidateMode(),
                  ValidateMetadataMode warnMode=detail::PreparedStatementsDefault::getWarnMode(),
                  bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable(),
+                 CursorMode cursorMode=detail::PreparedStatementsDefault::getCursorMode(),
                  typename... Args>
         PreparedStatement<RBindings,
                           ParamBindings<std::decay_t<Args>...>,
                           storeResult,
                           validateMode,
                           warnMode,
-                          ignoreNullable
+                          ignoreNullable,
+                          cursorMode
                           > makePreparedStatement(const std::string&, Args&&...) && = delete;
 
         template<typename RBindings=ResultBindings<>,
@@ -229,13 +248,15 @@ namespace SuperiorMySqlpp
                  ValidateMetadataMode validateMode=detail::PreparedStatementsDefault::getValidateMode(),
                  ValidateMetadataMode warnMode=detail::PreparedStatementsDefault::getWarnMode(),
                  bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable(),
+                 CursorMode cursorMode=detail::PreparedStatementsDefault::getCursorMode(),
                  typename... Args>
         PreparedStatement<RBindings,
                           ParamBindings<std::decay_t<Args>...>,
                           storeResult,
                           validateMode,
                           warnMode,
-                          ignoreNullable
+                          ignoreNullable,
+                          cursorMode
                           > makePreparedStatement(const std::string&, Args&&...) &;
 
 
@@ -245,6 +266,7 @@ namespace SuperiorMySqlpp
                  ValidateMetadataMode validateMode=detail::PreparedStatementsDefault::getValidateMode(),
                  ValidateMetadataMode warnMode=detail::PreparedStatementsDefault::getWarnMode(),
                  bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable(),
+                 CursorMode cursorMode=detail::PreparedStatementsDefault::getCursorMode(),
                  template<typename...> class RArgsTuple, template<typename...> class PArgsTuple,
                  typename... RArgs, typename... PArgs
                  >
@@ -253,7 +275,8 @@ namespace SuperiorMySqlpp
                           storeResult,
                           validateMode,
                           warnMode,
-                          ignoreNullable
+                          ignoreNullable,
+                          cursorMode
                           > makePreparedStatement(
                 const std::string&, FullInitTag, RArgsTuple<RArgs...>&&, PArgsTuple<PArgs...>&&) && = delete;
 
@@ -262,6 +285,7 @@ namespace SuperiorMySqlpp
                  ValidateMetadataMode validateMode=detail::PreparedStatementsDefault::getValidateMode(),
                  ValidateMetadataMode warnMode=detail::PreparedStatementsDefault::getWarnMode(),
                  bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable(),
+                 CursorMode cursorMode=detail::PreparedStatementsDefault::getCursorMode(),
                  template<typename...> class RArgsTuple, template<typename...> class PArgsTuple,
                  typename... RArgs, typename... PArgs
                  >
@@ -270,7 +294,8 @@ namespace SuperiorMySqlpp
                           storeResult,
                           validateMode,
                           warnMode,
-                          ignoreNullable
+                          ignoreNullable,
+                          cursorMode
                           > makePreparedStatement(
                 const std::string&, FullInitTag, RArgsTuple<RArgs...>&&, PArgsTuple<PArgs...>&&) &;
 
@@ -290,6 +315,62 @@ namespace SuperiorMySqlpp
         DynamicPreparedStatement<storeResult, validateMode, warnMode, ignoreNullable> makeDynamicPreparedStatement(const std::string& query) &;
 
 
+        /**
+         * Per-connection cache used by cached prepared statements; disabled (capacity 0) by default.
+         */
+        StatementCache& getStatementCache() noexcept
+        {
+            return statementCache;
+        }
+
+        const StatementCache& getStatementCache() const noexcept
+        {
+            return statementCache;
+        }
+
+        /**
+         * Checks out statement of given type from statement cache (prepares new one on miss).
+         * Params of reused statement keep values of its previous use.
+         */
+        template<typename PreparedStatementType>
+        CachedPreparedStatement<PreparedStatementType> checkoutPreparedStatement(const std::string& query) && = delete;
+
+        template<typename PreparedStatementType>
+        CachedPreparedStatement<PreparedStatementType> checkoutPreparedStatement(const std::string& query) &;
+
+        /**
+         * Same as makePreparedStatement, but statement is checked out from statement cache
+         * and returned there when the handle is destroyed; passed params are assigned to the statement.
+         */
+        template<typename RBindings=ResultBindings<>,
+                 bool storeResult=detail::PreparedStatementsDefault::getStoreResult(),
+                 ValidateMetadataMode validateMode=detail::PreparedStatementsDefault::getValidateMode(),
+                 ValidateMetadataMode warnMode=detail::PreparedStatementsDefault::getWarnMode(),
+                 bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable(),
+                 typename... Args>
+        CachedPreparedStatement<PreparedStatement<RBindings,
+                                                  ParamBindings<std::decay_t<Args>...>,
+                                                  storeResult,
+                                                  validateMode,
+                                                  warnMode,
+                                                  ignoreNullable
+                                                  >> makeCachedPreparedStatement(const std::string&, Args&&...) && = delete;
+
+        template<typename RBindings=ResultBindings<>,
+                 bool storeResult=detail::PreparedStatementsDefault::getStoreResult(),
+                 ValidateMetadataMode validateMode=detail::PreparedStatementsDefault::getValidateMode(),
+                 ValidateMetadataMode warnMode=detail::PreparedStatementsDefault::getWarnMode(),
+                 bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable(),
+                 typename... Args>
+        CachedPreparedStatement<PreparedStatement<RBindings,
+                                                  ParamBindings<std::decay_t<Args>...>,
+                                                  storeResult,
+                                                  validateMode,
+                                                  warnMode,
+                                                  ignoreNullable
+                                                  >> makeCachedPreparedStatement(const std::string&, Args&&...) &;
+
+
         template<typename... Args>
         Query makeQuery(Args&&... args) && = delete;
 
@@ -302,6 +383,30 @@ namespace SuperiorMySqlpp
             return driver.escapeString(original);
         }
 
+        /**
+         * Streams rows into LOAD DATA LOCAL INFILE without any temporary file.
+         * Rows are TSV-encoded on the fly, therefore FIELDS and LINES clauses must be left default.
+         * Connection must be created with ConnectionOptions::localInfile enabled, as the capability is negotiated
+         * while connecting. The option may be disabled afterwards, it is enabled only for this statement
+         * and previous state of the option is restored afterwards.
+         *
+         * Example:
+         *   connection.loadDataStream("INTO TABLE `xuser` (`id`, `name`)", [&](LoadDataRowWriter& writer){
+         *       writer.writeRow(id, name);
+         *       return ++id < count;
+         *   });
+         *
+         * @param target Part of LOAD DATA statement following the file name (e.g. "INTO TABLE `xuser`").
+         * @param generator Callable bool(LoadDataRowWriter&); writes rows and returns false when there are no more.
+         * @return Number of affected rows.
+         * @throws MysqlInternalError When statement fails; exception thrown by generator is rethrown instead.
+         */
+        template<typename Generator>
+        auto loadDataStream(const std::string& target, Generator&& generator)
+        {
+            return detail::loadDataStream(driver, target, generator);
+        }
+
         static std::string escapeStringNoConnection(const std::string& original)
         {
             return LowLevel::DBDriver::escapeStringNoConnection(original);
@@ -309,6 +414,8 @@ namespace SuperiorMySqlpp
 
         void changeUser(const char* user, const char* password, const char* database)
         {
+            // Server closes all statements of the session
+            statementCache.clear();
             driver.changeUser(user, password, database);
         }
 
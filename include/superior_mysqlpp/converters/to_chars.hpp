@@ -0,0 +1,591 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <superior_mysqlpp/converters/wide_multiplication.hpp>
+
+
+namespace SuperiorMySqlpp { namespace Converters
+{
+    namespace detail
+    {
+        /**
+         * Decimal digits of numbers 00 to 99 stored by pairs.
+         */
+        constexpr char digitPairs[] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        template<typename T>
+        inline int countDigits(T value) noexcept
+        {
+            int digits = 1;
+            while (value >= 10000)
+            {
+                value /= 10000;
+                digits += 4;
+            }
+            if (value >= 1000)
+            {
+                return digits + 3;
+            }
+            if (value >= 100)
+            {
+                return digits + 2;
+            }
+            if (value >= 10)
+            {
+                return digits + 1;
+            }
+            return digits;
+        }
+
+        /**
+         * Writes unsigned number in decimal form.
+         *
+         * @param first Beginning of the output range; must have room for all digits.
+         * @param value Unsigned value.
+         * @return Pointer one past the last written character.
+         */
+        template<typename T>
+        inline char* writeUnsigned(char* first, T value) noexcept
+        {
+            auto end = first + countDigits(value);
+            auto it = end;
+            while (value >= 100)
+            {
+                auto index = static_cast<std::size_t>(value % 100) * 2;
+                value /= 100;
+                *--it = digitPairs[index + 1];
+                *--it = digitPairs[index];
+            }
+            if (value >= 10)
+            {
+                auto index = static_cast<std::size_t>(value) * 2;
+                *--it = digitPairs[index + 1];
+                *--it = digitPairs[index];
+            }
+            else
+            {
+                *--it = static_cast<char>('0' + value);
+            }
+            return end;
+        }
+
+        template<typename T>
+        constexpr std::enable_if_t<std::is_signed<T>::value, bool> isNegative(T value) noexcept
+        {
+            return value < 0;
+        }
+
+        template<typename T>
+        constexpr std::enable_if_t<!std::is_signed<T>::value, bool> isNegative(T) noexcept
+        {
+            return false;
+        }
+
+        /*
+         * Short representation of float and double is found by Grisu2 algorithm
+         * (Loitsch: Printing floating-point numbers quickly and accurately with integers).
+         * Printed digits are always parsed back to the same value; in rare cases they are
+         * not the shortest such digits.
+         */
+
+        /**
+         * Floating point number f * 2^e with 64-bit significand.
+         */
+        struct DiyFp
+        {
+            std::uint64_t f;
+            int e;
+        };
+
+        /**
+         * @return x * y rounded to 64-bit significand.
+         */
+        inline DiyFp multiply(DiyFp x, DiyFp y) noexcept
+        {
+            auto product = multiplyFull(x.f, y.f);
+            return {product.high + (product.low >> 63), x.e + y.e + 64};
+        }
+
+        inline DiyFp normalize(DiyFp x) noexcept
+        {
+            auto shift = __builtin_clzll(x.f);
+            return {x.f << shift, x.e - shift};
+        }
+
+        /**
+         * Value together with the boundaries of its rounding interval.
+         */
+        struct FloatingPointBoundaries
+        {
+            DiyFp value;
+            DiyFp lower;
+            DiyFp upper;
+        };
+
+        /**
+         * @param value Positive finite value.
+         */
+        template<typename T>
+        inline FloatingPointBoundaries computeBoundaries(T value) noexcept
+        {
+            constexpr int precision = std::numeric_limits<T>::digits;
+            constexpr int bias = std::numeric_limits<T>::max_exponent - 1 + (precision - 1);
+            constexpr int minExponent = 1 - bias;
+            constexpr auto hiddenBit = std::uint64_t{1} << (precision - 1);
+            using Bits = std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+
+            Bits rawBits;
+            std::memcpy(&rawBits, &value, sizeof(rawBits));
+            auto bits = static_cast<std::uint64_t>(rawBits);
+            auto biasedExponent = bits >> (precision - 1);
+            auto fraction = bits & (hiddenBit - 1);
+
+            auto v = biasedExponent == 0? DiyFp{fraction, minExponent}
+                                        : DiyFp{fraction + hiddenBit, static_cast<int>(biasedExponent) - bias};
+
+            // Lower neighbour of powers of two is closer
+            auto lowerIsCloser = fraction == 0 && biasedExponent > 1;
+            auto upper = normalize(DiyFp{2 * v.f + 1, v.e - 1});
+            auto lower = lowerIsCloser? DiyFp{4 * v.f - 1, v.e - 2} : DiyFp{2 * v.f - 1, v.e - 1};
+            lower = DiyFp{lower.f << (lower.e - upper.e), upper.e};
+            return {normalize(v), lower, upper};
+        }
+
+        struct CachedPower
+        {
+            std::uint64_t f;
+            int e;
+            int k;
+        };
+
+        /**
+         * Normalized 64-bit approximations f * 2^e of 10^k.
+         */
+        constexpr CachedPower cachedPowers[] = {
+            {0xFA8FD5A0081C0288u, -1220, -348},
+            {0xBAAEE17FA23EBF76u, -1193, -340},
+            {0x8B16FB203055AC76u, -1166, -332},
+            {0xCF42894A5DCE35EAu, -1140, -324},
+            {0x9A6BB0AA55653B2Du, -1113, -316},
+            {0xE61ACF033D1A45DFu, -1087, -308},
+            {0xAB70FE17C79AC6CAu, -1060, -300},
+            {0xFF77B1FCBEBCDC4Fu, -1034, -292},
+            {0xBE5691EF416BD60Cu, -1007, -284},
+            {0x8DD01FAD907FFC3Cu,  -980, -276},
+            {0xD3515C2831559A83u,  -954, -268},
+            {0x9D71AC8FADA6C9B5u,  -927, -260},
+            {0xEA9C227723EE8BCBu,  -901, -252},
+            {0xAECC49914078536Du,  -874, -244},
+            {0x823C12795DB6CE57u,  -847, -236},
+            {0xC21094364DFB5637u,  -821, -228},
+            {0x9096EA6F3848984Fu,  -794, -220},
+            {0xD77485CB25823AC7u,  -768, -212},
+            {0xA086CFCD97BF97F4u,  -741, -204},
+            {0xEF340A98172AACE5u,  -715, -196},
+            {0xB23867FB2A35B28Eu,  -688, -188},
+            {0x84C8D4DFD2C63F3Bu,  -661, -180},
+            {0xC5DD44271AD3CDBAu,  -635, -172},
+            {0x936B9FCEBB25C996u,  -608, -164},
+            {0xDBAC6C247D62A584u,  -582, -156},
+            {0xA3AB66580D5FDAF6u,  -555, -148},
+            {0xF3E2F893DEC3F126u,  -529, -140},
+            {0xB5B5ADA8AAFF80B8u,  -502, -132},
+            {0x87625F056C7C4A8Bu,  -475, -124},
+            {0xC9BCFF6034C13053u,  -449, -116},
+            {0x964E858C91BA2655u,  -422, -108},
+            {0xDFF9772470297EBDu,  -396, -100},
+            {0xA6DFBD9FB8E5B88Fu,  -369,  -92},
+            {0xF8A95FCF88747D94u,  -343,  -84},
+            {0xB94470938FA89BCFu,  -316,  -76},
+            {0x8A08F0F8BF0F156Bu,  -289,  -68},
+            {0xCDB02555653131B6u,  -263,  -60},
+            {0x993FE2C6D07B7FACu,  -236,  -52},
+            {0xE45C10C42A2B3B06u,  -210,  -44},
+            {0xAA242499697392D3u,  -183,  -36},
+            {0xFD87B5F28300CA0Eu,  -157,  -28},
+            {0xBCE5086492111AEBu,  -130,  -20},
+            {0x8CBCCC096F5088CCu,  -103,  -12},
+            {0xD1B71758E219652Cu,   -77,   -4},
+            {0x9C40000000000000u,   -50,    4},
+            {0xE8D4A51000000000u,   -24,   12},
+            {0xAD78EBC5AC620000u,     3,   20},
+            {0x813F3978F8940984u,    30,   28},
+            {0xC097CE7BC90715B3u,    56,   36},
+            {0x8F7E32CE7BEA5C70u,    83,   44},
+            {0xD5D238A4ABE98068u,   109,   52},
+            {0x9F4F2726179A2245u,   136,   60},
+            {0xED63A231D4C4FB27u,   162,   68},
+            {0xB0DE65388CC8ADA8u,   189,   76},
+            {0x83C7088E1AAB65DBu,   216,   84},
+            {0xC45D1DF942711D9Au,   242,   92},
+            {0x924D692CA61BE758u,   269,  100},
+            {0xDA01EE641A708DEAu,   295,  108},
+            {0xA26DA3999AEF774Au,   322,  116},
+            {0xF209787BB47D6B85u,   348,  124},
+            {0xB454E4A179DD1877u,   375,  132},
+            {0x865B86925B9BC5C2u,   402,  140},
+            {0xC83553C5C8965D3Du,   428,  148},
+            {0x952AB45CFA97A0B3u,   455,  156},
+            {0xDE469FBD99A05FE3u,   481,  164},
+            {0xA59BC234DB398C25u,   508,  172},
+            {0xF6C69A72A3989F5Cu,   534,  180},
+            {0xB7DCBF5354E9BECEu,   561,  188},
+            {0x88FCF317F22241E2u,   588,  196},
+            {0xCC20CE9BD35C78A5u,   614,  204},
+            {0x98165AF37B2153DFu,   641,  212},
+            {0xE2A0B5DC971F303Au,   667,  220},
+            {0xA8D9D1535CE3B396u,   694,  228},
+            {0xFB9B7CD9A4A7443Cu,   720,  236},
+            {0xBB764C4CA7A44410u,   747,  244},
+            {0x8BAB8EEFB6409C1Au,   774,  252},
+            {0xD01FEF10A657842Cu,   800,  260},
+            {0x9B10A4E5E9913129u,   827,  268},
+            {0xE7109BFBA19C0C9Du,   853,  276},
+            {0xAC2820D9623BF429u,   880,  284},
+            {0x80444B5E7AA7CF85u,   907,  292},
+            {0xBF21E44003ACDD2Du,   933,  300},
+            {0x8E679C2F5E44FF8Fu,   960,  308},
+            {0xD433179D9C8CB841u,   986,  316},
+            {0x9E19DB92B4E31BA9u,  1013,  324},
+            {0xEB96BF6EBADF77D9u,  1039,  332},
+            {0xAF87023B9BF0EE6Bu,  1066,  340},
+        };
+
+        constexpr int cachedPowersMinDecimalExponent = -348;
+        constexpr int cachedPowersDecimalStep = 8;
+
+        /**
+         * Range of binary exponents of scaled value; digits are generated from its upper 32 bits.
+         */
+        constexpr int scaledExponentMin = -60;
+        constexpr int scaledExponentMax = -32;
+
+        /**
+         * @return Cached power c such that scaledExponentMin <= c.e + e + 64 <= scaledExponentMax.
+         */
+        inline CachedPower getCachedPower(int e) noexcept
+        {
+            auto f = scaledExponentMin - e - 1;
+            // ceil(f * log10(2))
+            auto k = (f * 78913) / (1 << 18) + static_cast<int>(f > 0);
+            auto index = (k - cachedPowersMinDecimalExponent + cachedPowersDecimalStep - 1) / cachedPowersDecimalStep;
+            return cachedPowers[index];
+        }
+
+        /**
+         * @return Number of decimal digits of n; power is set to 10^(digits-1).
+         */
+        inline int findLargestPowerOfTen(std::uint32_t n, std::uint32_t& power) noexcept
+        {
+            power = 1;
+            int digits = 1;
+            while (digits < 10 && n / power >= 10)
+            {
+                power *= 10;
+                ++digits;
+            }
+            return digits;
+        }
+
+        /**
+         * Moves the last digit closer to the exact value while it stays in the rounding interval.
+         */
+        inline void roundLastDigit(char* buffer, int length, std::uint64_t distance, std::uint64_t delta,
+                                   std::uint64_t rest, std::uint64_t tenToK) noexcept
+        {
+            while (rest < distance && delta - rest >= tenToK
+                   && (rest + tenToK < distance || distance - rest > rest + tenToK - distance))
+            {
+                --buffer[length - 1];
+                rest += tenToK;
+            }
+        }
+
+        /**
+         * Generates the shortest digits of number in [lower, upper] closest to value (all scaled by the same power of ten).
+         */
+        inline void generateDigits(char* buffer, int& length, int& decimalExponent, DiyFp lower, DiyFp value, DiyFp upper) noexcept
+        {
+            auto delta = upper.f - lower.f;
+            auto distance = upper.f - value.f;
+
+            const DiyFp one{std::uint64_t{1} << -upper.e, upper.e};
+            auto integral = static_cast<std::uint32_t>(upper.f >> -one.e);
+            auto fractional = upper.f & (one.f - 1);
+
+            std::uint32_t power;
+            auto n = findLargestPowerOfTen(integral, power);
+            while (n > 0)
+            {
+                buffer[length++] = static_cast<char>('0' + integral / power);
+                integral %= power;
+                --n;
+
+                auto rest = (std::uint64_t{integral} << -one.e) + fractional;
+                if (rest <= delta)
+                {
+                    decimalExponent += n;
+                    roundLastDigit(buffer, length, distance, delta, rest, std::uint64_t{power} << -one.e);
+                    return;
+                }
+                power /= 10;
+            }
+
+            int m = 0;
+            while (true)
+            {
+                fractional *= 10;
+                buffer[length++] = static_cast<char>('0' + (fractional >> -one.e));
+                fractional &= one.f - 1;
+                ++m;
+                delta *= 10;
+                distance *= 10;
+                if (fractional <= delta)
+                {
+                    break;
+                }
+            }
+            decimalExponent -= m;
+            roundLastDigit(buffer, length, distance, delta, fractional, one.f);
+        }
+
+        /**
+         * Writes short digits of positive finite value (see Grisu2 note above); value equals digits * 10^decimalExponent.
+         *
+         * @return Number of written digits (at most 17).
+         */
+        template<typename T>
+        inline int writeShortestDigits(char* buffer, T value, int& decimalExponent) noexcept
+        {
+            auto boundaries = computeBoundaries(value);
+            auto cached = getCachedPower(boundaries.upper.e);
+            const DiyFp power{cached.f, cached.e};
+
+            auto scaled = multiply(boundaries.value, power);
+            auto lower = multiply(boundaries.lower, power);
+            auto upper = multiply(boundaries.upper, power);
+            // Products are inexact by 1 ulp, shrink the interval to be safe
+            ++lower.f;
+            --upper.f;
+
+            int length = 0;
+            decimalExponent = -cached.k;
+            generateDigits(buffer, length, decimalExponent, lower, scaled, upper);
+            return length;
+        }
+
+        /**
+         * Numbers with decimal point position in (minFixedExponent, maxFixedExponent] are written
+         * in fixed notation, others in scientific notation.
+         */
+        constexpr int minFixedExponent = -4;
+        constexpr int maxFixedExponent = 15;
+
+        /**
+         * Formats digits (stored at the beginning of buffer) of value digits * 10^decimalExponent.
+         *
+         * @return Pointer one past the last written character.
+         */
+        inline char* formatDigits(char* buffer, int length, int decimalExponent) noexcept
+        {
+            // Position of decimal point relative to the first digit
+            auto point = length + decimalExponent;
+
+            if (length <= point && point <= maxFixedExponent)
+            {
+                // digits000
+                std::memset(buffer + length, '0', static_cast<std::size_t>(point - length));
+                return buffer + point;
+            }
+
+            if (0 < point && point <= maxFixedExponent)
+            {
+                // dig.its
+                std::memmove(buffer + point + 1, buffer + point, static_cast<std::size_t>(length - point));
+                buffer[point] = '.';
+                return buffer + length + 1;
+            }
+
+            if (minFixedExponent < point && point <= 0)
+            {
+                // 0.000digits
+                std::memmove(buffer + 2 - point, buffer, static_cast<std::size_t>(length));
+                buffer[0] = '0';
+                buffer[1] = '.';
+                std::memset(buffer + 2, '0', static_cast<std::size_t>(-point));
+                return buffer + 2 - point + length;
+            }
+
+            // d.igitse-12
+            auto it = buffer + 1;
+            if (length > 1)
+            {
+                std::memmove(buffer + 2, buffer + 1, static_cast<std::size_t>(length - 1));
+                buffer[1] = '.';
+                it = buffer + length + 1;
+            }
+            *it++ = 'e';
+            auto exponent = point - 1;
+            if (exponent < 0)
+            {
+                *it++ = '-';
+                exponent = -exponent;
+            }
+            return writeUnsigned(it, static_cast<unsigned>(exponent));
+        }
+
+        /**
+         * Longest output of #writeShortest: sign, 17 digits, decimal point and exponent
+         * or sign and 0.000 followed by 17 digits.
+         */
+        constexpr std::size_t maxShortestLength = 25;
+
+        template<typename T>
+        inline char* writeShortest(char* first, T value) noexcept
+        {
+            if (std::signbit(value))
+            {
+                *first++ = '-';
+                value = -value;
+            }
+
+            if (value == 0)
+            {
+                *first++ = '0';
+                return first;
+            }
+            if (std::isnan(value))
+            {
+                std::memcpy(first, "nan", 3);
+                return first + 3;
+            }
+            if (std::isinf(value))
+            {
+                std::memcpy(first, "inf", 3);
+                return first + 3;
+            }
+
+            int decimalExponent;
+            auto length = writeShortestDigits(first, value, decimalExponent);
+            return formatDigits(first, length, decimalExponent);
+        }
+    }
+
+    /**
+     * Buffer size which is always sufficient for #toChars of any integral type, float and double
+     * and of long double values with reasonable magnitude.
+     */
+    constexpr std::size_t toCharsBufferSize = 64;
+
+    /**
+     * Writes decimal representation of integral value (same as std::to_string) into [first, last).
+     * Does not allocate.
+     *
+     * @return Pointer one past the last written character or nullptr when the range is too small.
+     */
+    template<typename T>
+    inline std::enable_if_t<std::is_integral<T>::value, char*> toChars(char* first, char* last, T value) noexcept
+    {
+        using Unsigned = std::make_unsigned_t<std::conditional_t<std::is_same<T, bool>::value, unsigned char, T>>;
+
+        if (last - first < std::numeric_limits<T>::digits10 + 2)
+        {
+            // Range may be still sufficient for this value
+            char buffer[std::numeric_limits<T>::digits10 + 2];
+            auto end = toChars(buffer, buffer + sizeof(buffer), value);
+            auto length = end - buffer;
+            if (length > last - first)
+            {
+                return nullptr;
+            }
+            std::memcpy(first, buffer, length);
+            return first + length;
+        }
+
+        auto magnitude = static_cast<Unsigned>(value);
+        if (detail::isNegative(value))
+        {
+            *first++ = '-';
+            magnitude = static_cast<Unsigned>(0u - magnitude);
+        }
+        return detail::writeUnsigned(first, magnitude);
+    }
+
+    /**
+     * Writes short decimal representation of float or double value which is parsed back
+     * to the same value (e.g. 0.1, 1.5e-7, 1e300) into [first, last). It round-trips, but it is not
+     * always the shortest one (Grisu2 rarely writes one more digit). Output does not depend
+     * on locale, NaN and infinity are written as nan, inf and -inf. Does not allocate.
+     *
+     * @return Pointer one past the last written character or nullptr when the range is too small.
+     */
+    template<typename T>
+    inline std::enable_if_t<std::is_same<T, float>::value || std::is_same<T, double>::value, char*> toChars(char* first, char* last, T value) noexcept
+    {
+        char buffer[detail::maxShortestLength];
+        auto end = detail::writeShortest(buffer, value);
+        auto length = end - buffer;
+        if (length > last - first)
+        {
+            return nullptr;
+        }
+        std::memcpy(first, buffer, static_cast<std::size_t>(length));
+        return first + length;
+    }
+
+    /**
+     * Writes long double value with std::numeric_limits<long double>::max_digits10 significant digits
+     * (printf's %Lg) into [first, last). Decimal point of current C locale (LC_NUMERIC) is replaced by '.',
+     * so output does not depend on locale. Does not allocate.
+     *
+     * @return Pointer one past the last written character or nullptr when the range is too small.
+     */
+    template<typename T>
+    inline std::enable_if_t<std::is_same<T, long double>::value, char*> toChars(char* first, char* last, T value) noexcept
+    {
+        auto size = static_cast<std::size_t>(last - first);
+        auto length = std::snprintf(first, size, "%.*Lg", std::numeric_limits<long double>::max_digits10, value);
+        if (length < 0 || static_cast<std::size_t>(length) >= size)
+        {
+            return nullptr;
+        }
+        auto end = first + length;
+
+        const char* point = std::localeconv()->decimal_point;
+        if (point != nullptr && std::strcmp(point, ".") != 0 && *point != '\0')
+        {
+            auto pointLength = std::strlen(point);
+            auto position = std::search(first, end, point, point + pointLength);
+            if (position != end)
+            {
+                *position = '.';
+                std::memmove(position + 1, position + pointLength, static_cast<std::size_t>(end - position) - pointLength);
+                end -= pointLength - 1;
+            }
+        }
+        return end;
+    }
+}}
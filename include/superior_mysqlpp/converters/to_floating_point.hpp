@@ -5,20 +5,494 @@
 #pragma once
 
 
+#include <cfloat>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
+#include <string>
 
+#include <superior_mysqlpp/converters/power_of_five_table.hpp>
+#include <superior_mysqlpp/converters/wide_multiplication.hpp>
+
+
+/*
+ * Conversion of decimal numbers into floating point values.
+ *
+ * Mantissa (at most 19 significant digits) and decimal exponent are parsed in one pass.
+ * Values which are exact in the target type are computed directly (Clinger's fast path),
+ * all others by Eisel-Lemire algorithm using 128-bit approximation of the power of five.
+ * Numbers with more significant digits, which cannot be decided from the first 19 of them,
+ * and long double are handed over to strtod family in locale independent form.
+ */
 
 namespace SuperiorMySqlpp { namespace Converters
 {
-    /*
-     * TODO: write optimized conversion functions
-     */
-
     namespace detail
     {
+        /**
+         * Value of decimal number is mantissa * 10^exponent.
+         */
+        struct DecimalNumber
+        {
+            std::uint64_t mantissa;
+            std::int64_t exponent;
+            bool negative;
+            /** Some nonzero digits did not fit into mantissa. */
+            bool truncated;
+        };
+
+        constexpr int maxMantissaDigits = 19;
+
+        /**
+         * Explicit exponents stop growing here; such numbers are zero or infinity anyway.
+         */
+        constexpr std::int64_t maxExplicitExponent = 100000000;
+
+        inline bool isDecimalDigit(char character) noexcept
+        {
+            return static_cast<unsigned>(character) - '0' < 10u;
+        }
+
+        /**
+         * Parses [+-]digits[.digits][(e|E)[+-]digits], where at least one mantissa digit is required.
+         *
+         * @return False when the whole range is not a valid number.
+         */
+        inline bool parseDecimal(const char* first, const char* last, DecimalNumber& number) noexcept
+        {
+            number = DecimalNumber{0, 0, false, false};
+            if (first != last && (*first == '-' || *first == '+'))
+            {
+                number.negative = *first == '-';
+                ++first;
+            }
+
+            // Leading zeros are not counted as they do not change mantissa
+            int digits = 0;
+            bool anyDigit = false;
+            for (; first != last && isDecimalDigit(*first); ++first)
+            {
+                anyDigit = true;
+                auto digit = static_cast<unsigned>(*first - '0');
+                if (digits < maxMantissaDigits)
+                {
+                    number.mantissa = number.mantissa * 10 + digit;
+                    digits += number.mantissa != 0;
+                }
+                else
+                {
+                    ++number.exponent;
+                    number.truncated |= digit != 0;
+                }
+            }
+
+            if (first != last && *first == '.')
+            {
+                ++first;
+                for (; first != last && isDecimalDigit(*first); ++first)
+                {
+                    anyDigit = true;
+                    auto digit = static_cast<unsigned>(*first - '0');
+                    if (digits < maxMantissaDigits)
+                    {
+                        number.mantissa = number.mantissa * 10 + digit;
+                        digits += number.mantissa != 0;
+                        --number.exponent;
+                    }
+                    else
+                    {
+                        number.truncated |= digit != 0;
+                    }
+                }
+            }
+
+            if (!anyDigit)
+            {
+                return false;
+            }
+
+            if (first != last && (*first == 'e' || *first == 'E'))
+            {
+                ++first;
+                bool negativeExponent = false;
+                if (first != last && (*first == '-' || *first == '+'))
+                {
+                    negativeExponent = *first == '-';
+                    ++first;
+                }
+                if (first == last || !isDecimalDigit(*first))
+                {
+                    return false;
+                }
+
+                std::int64_t exponent = 0;
+                for (; first != last && isDecimalDigit(*first); ++first)
+                {
+                    if (exponent < maxExplicitExponent)
+                    {
+                        exponent = exponent * 10 + (*first - '0');
+                    }
+                }
+                number.exponent += negativeExponent? -exponent : exponent;
+            }
+
+            return first == last;
+        }
+
+        inline bool equalsIgnoreCase(const char* first, const char* last, const char* lowercase) noexcept
+        {
+            for (; first != last; ++first, ++lowercase)
+            {
+                if (*lowercase == '\0' || (*first | 0x20) != *lowercase)
+                {
+                    return false;
+                }
+            }
+            return *lowercase == '\0';
+        }
+
+        /**
+         * Parses [+-](inf|infinity|nan) ignoring case.
+         */
+        template<typename T>
+        inline bool parseSpecialValue(const char* first, const char* last, T& value) noexcept
+        {
+            bool negative = false;
+            if (first != last && (*first == '-' || *first == '+'))
+            {
+                negative = *first == '-';
+                ++first;
+            }
+
+            if (equalsIgnoreCase(first, last, "inf") || equalsIgnoreCase(first, last, "infinity"))
+            {
+                value = std::numeric_limits<T>::infinity();
+            }
+            else if (equalsIgnoreCase(first, last, "nan"))
+            {
+                value = std::numeric_limits<T>::quiet_NaN();
+            }
+            else
+            {
+                return false;
+            }
+
+            if (negative)
+            {
+                value = -value;
+            }
+            return true;
+        }
+
+
+        template<typename T>
+        struct BinaryFormat;
+
+        template<>
+        struct BinaryFormat<float>
+        {
+            using Bits = std::uint32_t;
+
+            static constexpr int mantissaBits = 23;
+            static constexpr int minimumExponent = -127;
+            static constexpr int infinitePower = 0xFF;
+            /** Range of exponents where ties of Eisel-Lemire result must be rounded to even. */
+            static constexpr int minRoundToEvenExponent = -17;
+            static constexpr int maxRoundToEvenExponent = 10;
+            /** Numbers with lower exponent are always zero and with higher always infinity. */
+            static constexpr int smallestPowerOfTen = -65;
+            static constexpr int largestPowerOfTen = 38;
+            /** Limits of Clinger's fast path. */
+            static constexpr std::uint64_t maxExactMantissa = std::uint64_t{1} << 24;
+            static constexpr int maxExactPowerOfTen = 10;
+
+            static float getExactPowerOfTen(std::int64_t exponent) noexcept
+            {
+                constexpr float powers[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+                return powers[exponent];
+            }
+        };
+
+        template<>
+        struct BinaryFormat<double>
+        {
+            using Bits = std::uint64_t;
+
+            static constexpr int mantissaBits = 52;
+            static constexpr int minimumExponent = -1023;
+            static constexpr int infinitePower = 0x7FF;
+            static constexpr int minRoundToEvenExponent = -4;
+            static constexpr int maxRoundToEvenExponent = 23;
+            static constexpr int smallestPowerOfTen = -342;
+            static constexpr int largestPowerOfTen = 308;
+            static constexpr std::uint64_t maxExactMantissa = std::uint64_t{1} << 53;
+            static constexpr int maxExactPowerOfTen = 22;
+
+            static double getExactPowerOfTen(std::int64_t exponent) noexcept
+            {
+                constexpr double powers[] = {
+                    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+                };
+                return powers[exponent];
+            }
+        };
+
+        /**
+         * Binary significand (without the hidden bit) and biased binary exponent.
+         */
+        struct AdjustedMantissa
+        {
+            std::uint64_t mantissa;
+            int power2;
+
+            bool operator==(const AdjustedMantissa& other) const noexcept
+            {
+                return mantissa == other.mantissa && power2 == other.power2;
+            }
+
+            bool operator!=(const AdjustedMantissa& other) const noexcept
+            {
+                return !(*this == other);
+            }
+        };
+
+        /**
+         * @return floor(log2(10^exponent)) + 63.
+         */
+        inline int getBinaryExponent(int exponent) noexcept
+        {
+            return (((152170 + 65536) * exponent) >> 16) + 63;
+        }
+
+        /**
+         * Computes mantissa * 10^exponent rounded to nearest, ties to even (Eisel-Lemire algorithm).
+         * 128-bit approximation of the power of five always suffices for 64-bit mantissa
+         * (Mushtak, Lemire: Fast number parsing without fallback).
+         */
+        template<typename T>
+        inline AdjustedMantissa computeFloat(std::int64_t exponent, std::uint64_t mantissa) noexcept
+        {
+            using Format = BinaryFormat<T>;
+
+            if (mantissa == 0 || exponent < Format::smallestPowerOfTen)
+            {
+                return {0, 0};
+            }
+            if (exponent > Format::largestPowerOfTen)
+            {
+                return {0, Format::infinitePower};
+            }
+
+            auto q = static_cast<int>(exponent);
+            auto leadingZeros = __builtin_clzll(mantissa);
+            mantissa <<= leadingZeros;
+
+            // Mantissa bits plus hidden bit, rounding bit and one more bit which may be lost by normalization
+            constexpr auto precisionMask = ~std::uint64_t{0} >> (Format::mantissaBits + 3);
+            auto index = 2 * static_cast<std::size_t>(q - smallestPowerOfFive);
+            auto product = multiplyFull(mantissa, powerOfFiveTable[index]);
+            if ((product.high & precisionMask) == precisionMask)
+            {
+                auto lowProduct = multiplyFull(mantissa, powerOfFiveTable[index + 1]);
+                product.low += lowProduct.high;
+                if (lowProduct.high > product.low)
+                {
+                    ++product.high;
+                }
+            }
+
+            auto upperBit = static_cast<int>(product.high >> 63);
+            auto shift = upperBit + 64 - Format::mantissaBits - 3;
+            AdjustedMantissa result{product.high >> shift,
+                                    getBinaryExponent(q) + upperBit - leadingZeros - Format::minimumExponent};
+
+            if (result.power2 <= 0)
+            {
+                // Subnormal number
+                if (-result.power2 + 1 >= 64)
+                {
+                    return {0, 0};
+                }
+                result.mantissa >>= -result.power2 + 1;
+                result.mantissa += result.mantissa & 1;
+                result.mantissa >>= 1;
+                result.power2 = result.mantissa < (std::uint64_t{1} << Format::mantissaBits)? 0 : 1;
+                return result;
+            }
+
+            // Product is exact and lies exactly between two floating point values
+            if (product.low <= 1 && q >= Format::minRoundToEvenExponent && q <= Format::maxRoundToEvenExponent
+                && (result.mantissa & 3) == 1 && (result.mantissa << shift) == product.high)
+            {
+                result.mantissa &= ~std::uint64_t{1};
+            }
+
+            result.mantissa += result.mantissa & 1;
+            result.mantissa >>= 1;
+            if (result.mantissa >= (std::uint64_t{2} << Format::mantissaBits))
+            {
+                result.mantissa = std::uint64_t{1} << Format::mantissaBits;
+                ++result.power2;
+            }
+            result.mantissa &= ~(std::uint64_t{1} << Format::mantissaBits);
+            if (result.power2 >= Format::infinitePower)
+            {
+                return {0, Format::infinitePower};
+            }
+            return result;
+        }
+
+        template<typename T>
+        inline T makeFloatingPoint(AdjustedMantissa value, bool negative) noexcept
+        {
+            using Format = BinaryFormat<T>;
+            using Bits = typename Format::Bits;
+
+            auto bits = value.mantissa | (static_cast<std::uint64_t>(value.power2) << Format::mantissaBits);
+            if (negative)
+            {
+                bits |= std::uint64_t{1} << (sizeof(Bits) * 8 - 1);
+            }
+            auto narrowBits = static_cast<Bits>(bits);
+            T result;
+            std::memcpy(&result, &narrowBits, sizeof(result));
+            return result;
+        }
+
+        /**
+         * Rewrites valid decimal number as [sign]digits"e"exponent. Such string contains no decimal point,
+         * so strtod family parses it the same way in every locale.
+         */
+        inline std::string normalizeDecimal(const char* first, const char* last)
+        {
+            std::string normalized{};
+            normalized.reserve(static_cast<std::size_t>(last - first) + 24);
+
+            std::int64_t exponent = 0;
+            bool fraction = false;
+            for (; first != last && *first != 'e' && *first != 'E'; ++first)
+            {
+                if (*first == '.')
+                {
+                    fraction = true;
+                    continue;
+                }
+                normalized.push_back(*first);
+                if (fraction)
+                {
+                    --exponent;
+                }
+            }
+
+            if (first != last)
+            {
+                ++first;
+                bool negativeExponent = first != last && *first == '-';
+                if (first != last && (*first == '-' || *first == '+'))
+                {
+                    ++first;
+                }
+                std::int64_t explicitExponent = 0;
+                for (; first != last && explicitExponent < maxExplicitExponent; ++first)
+                {
+                    explicitExponent = explicitExponent * 10 + (*first - '0');
+                }
+                exponent += negativeExponent? -explicitExponent : explicitExponent;
+            }
+
+            normalized.push_back('e');
+            normalized += std::to_string(exponent);
+            return normalized;
+        }
+
+        inline void parseNormalizedDecimal(const std::string& normalized, float& value)
+        {
+            value = std::strtof(normalized.c_str(), nullptr);
+        }
+
+        inline void parseNormalizedDecimal(const std::string& normalized, double& value)
+        {
+            value = std::strtod(normalized.c_str(), nullptr);
+        }
+
+        inline void parseNormalizedDecimal(const std::string& normalized, long double& value)
+        {
+            value = std::strtold(normalized.c_str(), nullptr);
+        }
+
+        template<typename T>
+        inline T parseFloatingPointSlow(const char* str, std::size_t length)
+        {
+            T value;
+            parseNormalizedDecimal(normalizeDecimal(str, str + length), value);
+            return value;
+        }
+
+        /**
+         * @return True when number is valid; value is set for special values, otherwise number is filled.
+         * @throws std::domain_error When string is not a valid number.
+         */
+        template<typename T>
+        inline bool parseFloatingPointInput(const char* str, std::size_t length, DecimalNumber& number, T& value)
+        {
+            if (parseDecimal(str, str + length, number))
+            {
+                return true;
+            }
+            if (parseSpecialValue(str, str + length, value))
+            {
+                return false;
+            }
+            throw std::domain_error{"SuperiorMysqlpp::toFloatingPoint"};
+        }
+
+        template<typename T>
+        inline T parseFloatingPoint(const char* str, std::size_t length)
+        {
+            using Format = BinaryFormat<T>;
+
+            DecimalNumber number;
+            T value;
+            if (!parseFloatingPointInput(str, length, number, value))
+            {
+                return value;
+            }
+
+            // Both mantissa and power of ten are exact, so single rounded operation gives correct result
+            if (FLT_EVAL_METHOD == 0 && !number.truncated && number.mantissa <= Format::maxExactMantissa
+                && number.exponent >= -Format::maxExactPowerOfTen && number.exponent <= Format::maxExactPowerOfTen)
+            {
+                value = static_cast<T>(number.mantissa);
+                if (number.exponent < 0)
+                {
+                    value /= Format::getExactPowerOfTen(-number.exponent);
+                }
+                else
+                {
+                    value *= Format::getExactPowerOfTen(number.exponent);
+                }
+                return number.negative? -value : value;
+            }
+
+            auto adjusted = computeFloat<T>(number.exponent, number.mantissa);
+            // Dropped digits matter only when they could change rounding
+            if (number.truncated && adjusted != computeFloat<T>(number.exponent, number.mantissa + 1))
+            {
+                return parseFloatingPointSlow<T>(str, length);
+            }
+            return makeFloatingPoint<T>(adjusted, number.negative);
+        }
     }
 
+    /**
+     * Converts decimal number ([+-]digits[.digits][(e|E)[+-]digits]), inf or nan into floating point type.
+     * Result is correctly rounded and does not depend on locale.
+     *
+     * @throws std::domain_error When string is not a valid number.
+     */
     template<typename T>
     inline T toFloatingPoint(const char* str, std::size_t length) = delete;
 
@@ -26,30 +500,25 @@ namespace SuperiorMySqlpp { namespace Converters
     template<>
     inline float toFloatingPoint(const char* str, std::size_t length)
     {
-        if (length == 0)
-        {
-            throw std::domain_error{"SuperiorMysqlpp::toFloatingPoint"};
-        }
-        return std::strtof(str, nullptr);
+        return detail::parseFloatingPoint<float>(str, length);
     }
 
     template<>
     inline double toFloatingPoint(const char* str, std::size_t length)
     {
-        if (length == 0)
-        {
-            throw std::domain_error{"SuperiorMysqlpp::toFloatingPoint"};
-        }
-        return std::strtod(str, nullptr);
+        return detail::parseFloatingPoint<double>(str, length);
     }
 
     template<>
     inline long double toFloatingPoint(const char* str, std::size_t length)
     {
-        if (length == 0)
+        // Format of long double differs between platforms, it is always converted by strtold
+        detail::DecimalNumber number;
+        long double value;
+        if (!detail::parseFloatingPointInput(str, length, number, value))
         {
-            throw std::domain_error{"SuperiorMysqlpp::toFloatingPoint"};
+            return value;
         }
-        return std::strtold(str, nullptr);
+        return detail::parseFloatingPointSlow<long double>(str, length);
     }
 }}
@@ -0,0 +1,279 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+
+namespace SuperiorMySqlpp { namespace Converters
+{
+    /**
+     * Result of conversion of single field by #toIntegerBatch.
+     */
+    enum class IntegerParseStatus : std::uint8_t
+    {
+        ok,
+        /** Field is NULL; value is set to 0. */
+        null,
+        /** Field is empty or contains other characters than digits (and leading minus for signed types). */
+        invalid,
+        /** Field is a number out of range of the target type. */
+        overflow,
+    };
+
+    /**
+     * Summary of #toIntegerBatch.
+     */
+    struct IntegerBatchReport
+    {
+        std::size_t nullCount = 0;
+        std::size_t invalidCount = 0;
+        std::size_t overflowCount = 0;
+        /** Index of the first invalid or overflowing field; equals count when all fields are fine. */
+        std::size_t firstErrorIndex = 0;
+
+        bool isOk() const noexcept
+        {
+            return invalidCount == 0 && overflowCount == 0;
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * Longest digit string parsed at once; longer strings are accepted only with leading zeros
+         * (e.g. ZEROFILL columns), which are skipped first.
+         */
+        constexpr std::size_t maxBatchDigits = 24;
+
+        constexpr std::uint64_t swarOnes = 0x0101010101010101u;
+
+        /**
+         * Checks that all 8 bytes of word are ASCII digits.
+         */
+        inline bool areEightDigits(std::uint64_t word) noexcept
+        {
+            return (((word & 0xF0F0F0F0F0F0F0F0u) | (((word + 0x0606060606060606u) & 0xF0F0F0F0F0F0F0F0u) >> 4)) == 0x3333333333333333u);
+        }
+
+        /**
+         * Converts 8 ASCII digits (first digit in the lowest byte) into number;
+         * digits are combined by pairs, quadruples and octets in one register.
+         */
+        inline std::uint32_t parseEightDigits(std::uint64_t word) noexcept
+        {
+            word -= 0x30 * swarOnes;
+            word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFu;
+            word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFu;
+            word = (word * 10000 + (word >> 32)) & 0x00000000FFFFFFFFu;
+            return static_cast<std::uint32_t>(word);
+        }
+
+        inline std::uint64_t loadLittleEndian(const char* data) noexcept
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            word = __builtin_bswap64(word);
+#endif
+            return word;
+        }
+
+        /**
+         * Loads at most 8 characters right-aligned into word padded by '0' characters
+         * (first character in the lowest used byte), so the word can be passed to parseEightDigits.
+         */
+        inline std::uint64_t loadDigits(const char* data, std::size_t length) noexcept
+        {
+            if (length == 8)
+            {
+                return loadLittleEndian(data);
+            }
+
+            auto word = 0x30 * swarOnes;
+            for (std::size_t i=0; i<length; ++i)
+            {
+                word = (word >> 8) | (std::uint64_t{static_cast<unsigned char>(data[i])} << 56);
+            }
+            return word;
+        }
+
+        /**
+         * Parses unsigned digit string by 8 digits at once.
+         */
+        inline IntegerParseStatus parseUnsignedDigits(const char* data, std::size_t length, std::uint64_t& result) noexcept
+        {
+            if (length == 0)
+            {
+                return IntegerParseStatus::invalid;
+            }
+
+            while (length > maxBatchDigits && *data == '0')
+            {
+                ++data;
+                --length;
+            }
+            if (length > maxBatchDigits)
+            {
+                for (std::size_t i=0; i<length; ++i)
+                {
+                    if (data[i] < '0' || data[i] > '9')
+                    {
+                        return IntegerParseStatus::invalid;
+                    }
+                }
+                return IntegerParseStatus::overflow;
+            }
+
+            if (length <= 8)
+            {
+                auto word = loadDigits(data, length);
+                if (!areEightDigits(word))
+                {
+                    return IntegerParseStatus::invalid;
+                }
+                result = parseEightDigits(word);
+                return IntegerParseStatus::ok;
+            }
+
+            if (length <= 16)
+            {
+                auto high = loadDigits(data, length - 8);
+                auto low = loadLittleEndian(data + length - 8);
+                if (!areEightDigits(high) || !areEightDigits(low))
+                {
+                    return IntegerParseStatus::invalid;
+                }
+                result = std::uint64_t{parseEightDigits(high)} * 100000000u + parseEightDigits(low);
+                return IntegerParseStatus::ok;
+            }
+
+            auto high = loadDigits(data, length - 16);
+            auto middle = loadLittleEndian(data + length - 16);
+            auto low = loadLittleEndian(data + length - 8);
+            if (!areEightDigits(high) || !areEightDigits(middle) || !areEightDigits(low))
+            {
+                return IntegerParseStatus::invalid;
+            }
+
+            // 16 digits always fit, the highest octet may overflow
+            auto value = std::uint64_t{parseEightDigits(middle)} * 100000000u + parseEightDigits(low);
+            std::uint64_t scaled;
+            if (__builtin_mul_overflow(std::uint64_t{parseEightDigits(high)}, std::uint64_t{10000000000000000u}, &scaled)
+                || __builtin_add_overflow(scaled, value, &value))
+            {
+                return IntegerParseStatus::overflow;
+            }
+            result = value;
+            return IntegerParseStatus::ok;
+        }
+
+        template<typename T>
+        inline std::enable_if_t<std::is_unsigned<T>::value, IntegerParseStatus> parseIntegerField(const char* data, std::size_t length, T& result) noexcept
+        {
+            std::uint64_t value = 0;
+            auto status = parseUnsignedDigits(data, length, value);
+            if (status == IntegerParseStatus::ok && value > std::numeric_limits<T>::max())
+            {
+                status = IntegerParseStatus::overflow;
+            }
+            result = status == IntegerParseStatus::ok? static_cast<T>(value) : 0;
+            return status;
+        }
+
+        template<typename T>
+        inline std::enable_if_t<std::is_signed<T>::value, IntegerParseStatus> parseIntegerField(const char* data, std::size_t length, T& result) noexcept
+        {
+            bool negative = length != 0 && *data == '-';
+            if (negative)
+            {
+                ++data;
+                --length;
+            }
+
+            std::uint64_t magnitude = 0;
+            auto status = parseUnsignedDigits(data, length, magnitude);
+            using Unsigned = std::make_unsigned_t<T>;
+            auto limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (negative? 1u : 0u);
+            if (status == IntegerParseStatus::ok && magnitude > limit)
+            {
+                status = IntegerParseStatus::overflow;
+            }
+            if (status != IntegerParseStatus::ok)
+            {
+                result = 0;
+            }
+            else
+            {
+                // Two's complement negation in unsigned arithmetic handles the minimum
+                auto bits = static_cast<Unsigned>(magnitude);
+                result = static_cast<T>(negative? static_cast<Unsigned>(0u - bits) : bits);
+            }
+            return status;
+        }
+    }
+
+    /**
+     * Converts column of text protocol fields (as returned by mysql_fetch_row and mysql_fetch_lengths)
+     * into integers. Unlike #toInteger all fields are validated and out of range values are reported.
+     *
+     * @param values Pointers to fields; nullptr represents NULL.
+     * @param lengths Lengths of fields.
+     * @param count Number of fields.
+     * @param output Converted values; 0 for NULL and erroneous fields.
+     * @param statuses Optional per-field status.
+     * @return Summary of conversion.
+     */
+    template<typename T>
+    inline IntegerBatchReport toIntegerBatch(const char* const* values, const unsigned long* lengths, std::size_t count,
+                                             T* output, IntegerParseStatus* statuses=nullptr) noexcept
+    {
+        static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "Target type must be integer!");
+        static_assert(sizeof(T) <= sizeof(std::uint64_t), "Target type must have at most 64 bits!");
+
+        IntegerBatchReport report{};
+        report.firstErrorIndex = count;
+        for (std::size_t i=0; i<count; ++i)
+        {
+            IntegerParseStatus status;
+            if (values[i] == nullptr)
+            {
+                output[i] = 0;
+                status = IntegerParseStatus::null;
+                ++report.nullCount;
+            }
+            else
+            {
+                status = detail::parseIntegerField(values[i], lengths[i], output[i]);
+                if (status != IntegerParseStatus::ok)
+                {
+                    if (status == IntegerParseStatus::invalid)
+                    {
+                        ++report.invalidCount;
+                    }
+                    else
+                    {
+                        ++report.overflowCount;
+                    }
+                    if (report.firstErrorIndex == count)
+                    {
+                        report.firstErrorIndex = i;
+                    }
+                }
+            }
+
+            if (statuses != nullptr)
+            {
+                statuses[i] = status;
+            }
+        }
+        return report;
+    }
+}}
@@ -0,0 +1,406 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_chars.hpp>
+#include <superior_mysqlpp/converters/to_integer_batch.hpp>
+#include <superior_mysqlpp/types/date.hpp>
+#include <superior_mysqlpp/types/time.hpp>
+#include <superior_mysqlpp/types/datetime.hpp>
+
+
+/*
+ * Conversions of temporal values in text protocol format:
+ *   DATE                 YYYY-MM-DD
+ *   TIME                 [-]hh:mm:ss[.f], hours have 2 or 3 digits
+ *   DATETIME, TIMESTAMP  YYYY-MM-DD hh:mm:ss[.f]
+ * where fraction of second has 1 to 6 digits.
+ *
+ * Layout is fixed, so parsers check 8 characters at once against a mask of digits
+ * and separators and take the digits from the same register without branching.
+ */
+
+namespace SuperiorMySqlpp { namespace Converters
+{
+    namespace detail
+    {
+        /**
+         * Pattern of 8 characters; digit positions hold '0' in pattern and 9 as limit, separators hold themselves and 0.
+         */
+        struct TemporalLayout
+        {
+            std::uint64_t pattern;
+            std::uint64_t limits;
+        };
+
+        /**
+         * @param layout 8 characters; '#' stands for a digit, other characters must match exactly.
+         */
+        constexpr TemporalLayout makeTemporalLayout(const char* layout)
+        {
+            TemporalLayout result{0, 0};
+            for (int i=0; i<8; ++i)
+            {
+                auto isDigit = layout[i] == '#';
+                result.pattern |= std::uint64_t{static_cast<unsigned char>(isDigit? '0' : layout[i])} << (8 * i);
+                result.limits |= std::uint64_t{isDigit? 9u : 0u} << (8 * i);
+            }
+            return result;
+        }
+
+        /**
+         * Loads 8 characters and checks them against layout.
+         *
+         * @param digits Values of digits at digit positions, zeros elsewhere.
+         * @return True when characters match layout.
+         */
+        inline bool matchTemporalLayout(const char* data, TemporalLayout layout, std::uint64_t& digits) noexcept
+        {
+            // Digits XOR '0' give 0-9, any other character gives more; matching separators give 0
+            digits = loadLittleEndian(data) ^ layout.pattern;
+            // Byte exceeding its limit (or having the highest bit set) sets the highest bit
+            auto overflow = (digits + (0x7F7F7F7F7F7F7F7Fu - layout.limits)) | digits;
+            return (overflow & 0x8080808080808080u) == 0;
+        }
+
+        inline unsigned getLayoutDigit(std::uint64_t digits, int index) noexcept
+        {
+            return static_cast<unsigned>(digits >> (8 * index)) & 0xFFu;
+        }
+
+        inline unsigned getLayoutNumber(std::uint64_t digits, int index) noexcept
+        {
+            return getLayoutDigit(digits, index) * 10 + getLayoutDigit(digits, index + 1);
+        }
+
+        /**
+         * Parses 1 to 6 digits of fraction of second into microseconds.
+         */
+        inline bool parseSecondFraction(const char* data, std::size_t length, unsigned long& microseconds) noexcept
+        {
+            constexpr unsigned scales[] = {1000000, 100000, 10000, 1000, 100, 10, 1};
+            if (length == 0 || length > 6)
+            {
+                return false;
+            }
+            auto word = loadDigits(data, length);
+            microseconds = static_cast<unsigned long>(parseEightDigits(word)) * scales[length];
+            return areEightDigits(word);
+        }
+
+        /**
+         * Parses optional ".f" suffix.
+         */
+        inline bool parseOptionalSecondFraction(const char* data, std::size_t length, unsigned long& microseconds) noexcept
+        {
+            microseconds = 0;
+            if (length == 0)
+            {
+                return true;
+            }
+            return *data == '.' && parseSecondFraction(data + 1, length - 1, microseconds);
+        }
+
+        inline bool parseDate(const char* data, std::size_t length, unsigned& year, unsigned& month, unsigned& day) noexcept
+        {
+            constexpr auto yearMonthLayout = makeTemporalLayout("####-##-");
+            constexpr auto monthDayLayout = makeTemporalLayout("##-##-##");
+
+            if (length < 10)
+            {
+                return false;
+            }
+
+            std::uint64_t yearMonth, monthDay;
+            auto valid = matchTemporalLayout(data, yearMonthLayout, yearMonth);
+            valid &= matchTemporalLayout(data + 2, monthDayLayout, monthDay);
+
+            year = getLayoutNumber(yearMonth, 0) * 100 + getLayoutNumber(yearMonth, 2);
+            month = getLayoutNumber(yearMonth, 5);
+            day = getLayoutNumber(monthDay, 6);
+            return valid & (month <= 12) & (day <= 31);
+        }
+
+        /**
+         * Parses hh:mm:ss at data.
+         */
+        inline bool parseClock(const char* data, unsigned& hour, unsigned& minute, unsigned& second) noexcept
+        {
+            constexpr auto clockLayout = makeTemporalLayout("##:##:##");
+
+            std::uint64_t clock;
+            auto valid = matchTemporalLayout(data, clockLayout, clock);
+            hour = getLayoutNumber(clock, 0);
+            minute = getLayoutNumber(clock, 3);
+            second = getLayoutNumber(clock, 6);
+            return valid & (minute <= 59) & (second <= 59);
+        }
+
+        /**
+         * Parses hh:mm:ss or hhh:mm:ss at data.
+         */
+        inline bool parseTimeClock(const char* data, unsigned hourDigits, unsigned& hour, unsigned& minute, unsigned& second) noexcept
+        {
+            auto valid = parseClock(data + hourDigits - 2, hour, minute, second);
+            if (hourDigits == 3)
+            {
+                valid &= isDecimalDigit(*data);
+                hour += static_cast<unsigned>(*data - '0') * 100;
+            }
+            return valid;
+        }
+
+        inline std::domain_error makeTemporalError(const char* type, const char* data, std::size_t length)
+        {
+            return std::domain_error{std::string{"SuperiorMysqlpp: \""} + std::string(data, length) + "\" is not a valid " + type + "!"};
+        }
+
+        template<typename T>
+        inline T parseDatetime(const char* data, std::size_t length)
+        {
+            unsigned year, month, day, hour, minute, second;
+            unsigned long secondFraction;
+            auto valid = length >= 19;
+            if (valid)
+            {
+                valid = parseDate(data, length, year, month, day) & (data[10] == ' ')
+                        & parseClock(data + 11, hour, minute, second) & (hour <= 23)
+                        & parseOptionalSecondFraction(data + 19, length - 19, secondFraction);
+            }
+            if (!valid)
+            {
+                throw makeTemporalError("datetime", data, length);
+            }
+
+            T value{};
+            value.setYear(year);
+            value.setMonth(month);
+            value.setDay(day);
+            value.setHour(hour);
+            value.setMinute(minute);
+            value.setSecond(second);
+            value.setSecondFraction(secondFraction);
+            return value;
+        }
+
+        inline char* writeTwoDigits(char* first, unsigned value) noexcept
+        {
+            std::memcpy(first, digitPairs + (value % 100) * 2, 2);
+            return first + 2;
+        }
+
+        inline char* writeDate(char* first, unsigned year, unsigned month, unsigned day) noexcept
+        {
+            if (year < 10000)
+            {
+                first = writeTwoDigits(first, year / 100);
+                first = writeTwoDigits(first, year);
+            }
+            else
+            {
+                first = writeUnsigned(first, year);
+            }
+            *first++ = '-';
+            first = writeTwoDigits(first, month);
+            *first++ = '-';
+            return writeTwoDigits(first, day);
+        }
+
+        inline char* writeClock(char* first, unsigned hour, unsigned minute, unsigned second, unsigned long secondFraction) noexcept
+        {
+            first = hour < 100? writeTwoDigits(first, hour) : writeUnsigned(first, hour);
+            *first++ = ':';
+            first = writeTwoDigits(first, minute);
+            *first++ = ':';
+            first = writeTwoDigits(first, second);
+            if (secondFraction != 0)
+            {
+                auto microseconds = static_cast<unsigned>(secondFraction % 1000000);
+                *first++ = '.';
+                first = writeTwoDigits(first, microseconds / 10000);
+                first = writeTwoDigits(first, microseconds / 100);
+                first = writeTwoDigits(first, microseconds);
+            }
+            return first;
+        }
+
+        template<typename F>
+        inline char* writeTemporal(char* first, char* last, F&& write) noexcept
+        {
+            char buffer[toCharsBufferSize];
+            auto end = write(buffer);
+            auto length = end - buffer;
+            if (length > last - first)
+            {
+                return nullptr;
+            }
+            std::memcpy(first, buffer, static_cast<std::size_t>(length));
+            return first + length;
+        }
+
+        /**
+         * True for Date, Time, Datetime and Timestamp.
+         */
+        template<typename T>
+        struct IsTemporal : std::integral_constant<bool, std::is_base_of<Date, T>::value
+                                                         || std::is_base_of<Time, T>::value
+                                                         || std::is_base_of<Datetime, T>::value>
+        {
+        };
+    }
+
+
+    /**
+     * Parses DATE column (YYYY-MM-DD).
+     * @throws std::domain_error When value does not have DATE format.
+     */
+    inline Date toDate(const char* data, std::size_t length)
+    {
+        unsigned year, month, day;
+        if (length != 10 || !detail::parseDate(data, length, year, month, day))
+        {
+            throw detail::makeTemporalError("date", data, length);
+        }
+
+        Date value{};
+        value.setYear(year);
+        value.setMonth(month);
+        value.setDay(day);
+        return value;
+    }
+
+    /**
+     * Parses TIME column ([-]hh:mm:ss[.f]); hours may have 3 digits.
+     * @throws std::domain_error When value does not have TIME format.
+     */
+    inline Time toTime(const char* data, std::size_t length)
+    {
+        auto negative = length != 0 && *data == '-';
+        auto clock = data + negative;
+        auto clockLength = length - negative;
+
+        // Clock is always the 8 characters ending by seconds
+        auto hourDigits = clockLength >= 9 && clock[3] == ':'? 3u : 2u;
+        unsigned hour, minute, second;
+        unsigned long secondFraction;
+        auto valid = clockLength >= hourDigits + 6
+                     && detail::parseTimeClock(clock, hourDigits, hour, minute, second)
+                     && detail::parseOptionalSecondFraction(clock + hourDigits + 6, clockLength - hourDigits - 6, secondFraction);
+        if (!valid)
+        {
+            throw detail::makeTemporalError("time", data, length);
+        }
+
+        Time value{};
+        value.setHour(hour);
+        value.setMinute(minute);
+        value.setSecond(second);
+        value.setSecondFraction(secondFraction);
+        value.setSign(negative);
+        return value;
+    }
+
+    /**
+     * Parses DATETIME column (YYYY-MM-DD hh:mm:ss[.f]).
+     * @throws std::domain_error When value does not have DATETIME format.
+     */
+    inline Datetime toDatetime(const char* data, std::size_t length)
+    {
+        return detail::parseDatetime<Datetime>(data, length);
+    }
+
+    /**
+     * Parses TIMESTAMP column (same format as DATETIME).
+     * @throws std::domain_error When value does not have DATETIME format.
+     */
+    inline Timestamp toTimestamp(const char* data, std::size_t length)
+    {
+        return detail::parseDatetime<Timestamp>(data, length);
+    }
+
+
+    template<>
+    struct To<Date>
+    {
+        Date operator()(const char* str, unsigned int length)
+        {
+            return toDate(str, length);
+        }
+    };
+
+    template<>
+    struct To<Time>
+    {
+        Time operator()(const char* str, unsigned int length)
+        {
+            return toTime(str, length);
+        }
+    };
+
+    template<>
+    struct To<Datetime>
+    {
+        Datetime operator()(const char* str, unsigned int length)
+        {
+            return toDatetime(str, length);
+        }
+    };
+
+    template<>
+    struct To<Timestamp>
+    {
+        Timestamp operator()(const char* str, unsigned int length)
+        {
+            return toTimestamp(str, length);
+        }
+    };
+
+
+    /**
+     * Writes date as YYYY-MM-DD into [first, last).
+     * @return Pointer one past the last written character or nullptr when the range is too small.
+     */
+    inline char* toChars(char* first, char* last, const Date& value) noexcept
+    {
+        return detail::writeTemporal(first, last, [&](char* it){
+            return detail::writeDate(it, value.getYear(), value.getMonth(), value.getDay());
+        });
+    }
+
+    /**
+     * Writes time as [-]hh:mm:ss, followed by .ffffff when fraction of second is not zero, into [first, last).
+     * @return Pointer one past the last written character or nullptr when the range is too small.
+     */
+    inline char* toChars(char* first, char* last, const Time& value) noexcept
+    {
+        return detail::writeTemporal(first, last, [&](char* it){
+            if (value.isNegative())
+            {
+                *it++ = '-';
+            }
+            return detail::writeClock(it, value.getHour(), value.getMinute(), value.getSecond(), value.getSecondFraction());
+        });
+    }
+
+    /**
+     * Writes datetime as YYYY-MM-DD hh:mm:ss, followed by .ffffff when fraction of second is not zero, into [first, last).
+     * @return Pointer one past the last written character or nullptr when the range is too small.
+     */
+    inline char* toChars(char* first, char* last, const Datetime& value) noexcept
+    {
+        return detail::writeTemporal(first, last, [&](char* it){
+            it = detail::writeDate(it, value.getYear(), value.getMonth(), value.getDay());
+            *it++ = ' ';
+            return detail::writeClock(it, value.getHour(), value.getMinute(), value.getSecond(), value.getSecondFraction());
+        });
+    }
+}}
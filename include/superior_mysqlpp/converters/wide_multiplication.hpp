@@ -0,0 +1,44 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <cstdint>
+
+
+namespace SuperiorMySqlpp { namespace Converters { namespace detail
+{
+    struct UInt128
+    {
+        std::uint64_t high;
+        std::uint64_t low;
+    };
+
+    /**
+     * @return Full 128-bit product of two 64-bit numbers.
+     */
+    inline UInt128 multiplyFull(std::uint64_t a, std::uint64_t b) noexcept
+    {
+#ifdef __SIZEOF_INT128__
+        __extension__ typedef unsigned __int128 Product;
+        auto product = static_cast<Product>(a) * b;
+        return {static_cast<std::uint64_t>(product >> 64), static_cast<std::uint64_t>(product)};
+#else
+        auto aLow = a & 0xFFFFFFFFu;
+        auto aHigh = a >> 32;
+        auto bLow = b & 0xFFFFFFFFu;
+        auto bHigh = b >> 32;
+
+        auto lowLow = aLow * bLow;
+        auto lowHigh = aLow * bHigh;
+        auto highLow = aHigh * bLow;
+        auto highHigh = aHigh * bHigh;
+
+        auto middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFu) + (highLow & 0xFFFFFFFFu);
+        return {highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32),
+                (middle << 32) | (lowLow & 0xFFFFFFFFu)};
+#endif
+    }
+}}}
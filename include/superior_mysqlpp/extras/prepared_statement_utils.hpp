@@ -22,7 +22,7 @@ namespace SuperiorMySqlpp
         struct ToPreparedStatement<ParamsTuple<ParamsArgs...>, ResultTuple<ResultArgs...>>
         {
             /**
-             * Constructs prepared statement
+             * Checks out prepared statement from connection's statement cache
              * @param connection Connection handle into database
              * @param query Query for prepared statement
              * @tparam storeResult Boolean indicating if results will be in `store` or `use` mode
@@ -33,8 +33,8 @@ namespace SuperiorMySqlpp
             template <bool storeResult, ValidateMetadataMode validateMode, ValidateMetadataMode warnMode, bool ignoreNullable>
             static inline auto generate(Connection &connection, const std::string &query)
             {
-                return PreparedStatement<ResultBindings<ResultArgs...>, ParamBindings<ParamsArgs...>, storeResult, validateMode, warnMode, ignoreNullable>
-                    { connection, query };
+                using PreparedStatementType = PreparedStatement<ResultBindings<ResultArgs...>, ParamBindings<ParamsArgs...>, storeResult, validateMode, warnMode, ignoreNullable>;
+                return connection.template checkoutPreparedStatement<PreparedStatementType>(query);
             }
         };
 
@@ -115,7 +115,8 @@ namespace SuperiorMySqlpp
         static constexpr bool hasParamCallback = !std::is_same<ParamCallable, EmptyParamCallback>::value;
         static constexpr bool hasResultCallback = !std::is_same<ResultCallable, EmptyResultCallback>::value;
 
-        auto ps = detail::generatePreparedStatement<storeResult, validateMode, warnMode, ignoreNullable>(connection, query, paramsSetter, processingFunction);
+        auto cachedPs = detail::generatePreparedStatement<storeResult, validateMode, warnMode, ignoreNullable>(connection, query, paramsSetter, processingFunction);
+        auto& ps = *cachedPs;
 
         do {
             if (hasParamCallback)
@@ -251,7 +252,7 @@ namespace SuperiorMySqlpp
              typename ConnType>
     void psReadValues(const std::string &query, ConnType &&connection, Args&... values)
     {
-        detail::psReadValuesImpl(connection.template makePreparedStatement<ResultBindings<Args...>, storeResult, validateMode, warnMode, ignoreNullable>(query), values...);
+        detail::psReadValuesImpl(*connection.template makeCachedPreparedStatement<ResultBindings<Args...>, storeResult, validateMode, warnMode, ignoreNullable>(query), values...);
     }
 }
 
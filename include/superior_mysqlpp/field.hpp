@@ -9,6 +9,7 @@
 #include <ostream>
 
 #include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_temporal.hpp>
 #include <superior_mysqlpp/types/string_view.hpp>
 
 
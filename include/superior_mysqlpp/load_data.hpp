@@ -0,0 +1,368 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <exception>
+#include <type_traits>
+
+#include <mysql/errmsg.h>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_chars.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/types/nullable.hpp>
+#include <superior_mysqlpp/types/string_view.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Encodes rows into the default text format of LOAD DATA INFILE
+     * (fields terminated by '\t', lines terminated by '\n', escaped by '\\').
+     * NULL values are written as \N.
+     */
+    class LoadDataRowWriter
+    {
+    private:
+        std::string buffer{};
+        bool rowOpened = false;
+
+    private:
+        void beginField()
+        {
+            if (rowOpened)
+            {
+                buffer.push_back('\t');
+            }
+            else
+            {
+                rowOpened = true;
+            }
+        }
+
+        void appendEscaped(const char* data, std::size_t length)
+        {
+            auto runBegin = data;
+            auto end = data + length;
+            for (auto it=data; it!=end; ++it)
+            {
+                char replacement;
+                switch (*it)
+                {
+                    case '\0':   replacement = '0'; break;
+                    case '\t':   replacement = 't'; break;
+                    case '\n':   replacement = 'n'; break;
+                    case '\r':   replacement = 'r'; break;
+                    case '\\':   replacement = '\\'; break;
+                    case '\x1a': replacement = 'Z'; break;
+                    default:
+                        continue;
+                }
+                buffer.append(runBegin, it);
+                buffer.push_back('\\');
+                buffer.push_back(replacement);
+                runBegin = it + 1;
+            }
+            buffer.append(runBegin, end);
+        }
+
+        void writeRowFields()
+        {
+        }
+
+        template<typename Arg, typename... Args>
+        void writeRowFields(const Arg& arg, const Args&... args)
+        {
+            writeField(arg);
+            writeRowFields(args...);
+        }
+
+    public:
+        LoadDataRowWriter& writeNull()
+        {
+            beginField();
+            buffer.append("\\N", 2);
+            return *this;
+        }
+
+        LoadDataRowWriter& writeField(std::nullptr_t)
+        {
+            return writeNull();
+        }
+
+        LoadDataRowWriter& writeField(const char* data, std::size_t length)
+        {
+            beginField();
+            appendEscaped(data, length);
+            return *this;
+        }
+
+        LoadDataRowWriter& writeField(const char* value)
+        {
+            return writeField(value, std::strlen(value));
+        }
+
+        LoadDataRowWriter& writeField(const std::string& value)
+        {
+            return writeField(value.data(), value.size());
+        }
+
+        LoadDataRowWriter& writeField(StringView value)
+        {
+            return writeField(value.data(), value.size());
+        }
+
+        template<typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value, LoadDataRowWriter&> writeField(T value)
+        {
+            beginField();
+            // Textual representation of numbers never needs escaping
+            char number[Converters::toCharsBufferSize];
+            auto end = Converters::toChars(number, number + sizeof(number), value);
+            if (end != nullptr)
+            {
+                buffer.append(number, end);
+            }
+            else
+            {
+                buffer += Converters::toString(value);
+            }
+            return *this;
+        }
+
+        template<typename T>
+        LoadDataRowWriter& writeField(const Nullable<T>& value)
+        {
+            if (value.isValid())
+            {
+                return writeField(*value);
+            }
+            else
+            {
+                return writeNull();
+            }
+        }
+
+        /**
+         * Terminates current row.
+         */
+        void endRow()
+        {
+            buffer.push_back('\n');
+            rowOpened = false;
+        }
+
+        /**
+         * Writes all arguments as fields of single row and terminates it.
+         */
+        template<typename... Args>
+        void writeRow(const Args&... args)
+        {
+            writeRowFields(args...);
+            endRow();
+        }
+
+        bool isRowOpened() const noexcept
+        {
+            return rowOpened;
+        }
+
+        const std::string& getBuffer() const noexcept
+        {
+            return buffer;
+        }
+
+        void clear() noexcept
+        {
+            buffer.clear();
+        }
+    };
+
+
+    namespace detail
+    {
+        /**
+         * Adapts row generator to LOAD DATA LOCAL INFILE callbacks.
+         * Exceptions thrown by generator are stored and rethrown after the statement fails,
+         * because they must not propagate through C code.
+         */
+        template<typename Generator>
+        class LoadDataStreamSource
+        {
+        private:
+            Generator& generator;
+            LoadDataRowWriter writer{};
+            std::size_t position = 0;
+            bool finished = false;
+            std::exception_ptr exception{};
+            std::string errorMessage{};
+
+        private:
+            int fill(char* destination, std::size_t length)
+            {
+                std::size_t written = 0;
+                while (written < length)
+                {
+                    const auto& pending = writer.getBuffer();
+                    if (position == pending.size())
+                    {
+                        if (finished)
+                        {
+                            break;
+                        }
+
+                        writer.clear();
+                        position = 0;
+                        // Let the generator produce at least one buffer worth of data
+                        while (!finished && pending.size() < length)
+                        {
+                            finished = !generator(writer);
+                            if (writer.isRowOpened())
+                            {
+                                throw LogicError{"LOAD DATA generator returned in the middle of a row!"};
+                            }
+                        }
+                        continue;
+                    }
+
+                    auto chunkSize = std::min(length - written, pending.size() - position);
+                    std::memcpy(destination + written, pending.data() + position, chunkSize);
+                    written += chunkSize;
+                    position += chunkSize;
+                }
+                return static_cast<int>(written);
+            }
+
+            static int init(void** sourcePtr, const char*, void* userData) noexcept
+            {
+                *sourcePtr = userData;
+                return 0;
+            }
+
+            static int read(void* sourcePtr, char* buffer, unsigned int length) noexcept
+            {
+                auto& source = *static_cast<LoadDataStreamSource*>(sourcePtr);
+                try
+                {
+                    return source.fill(buffer, length);
+                }
+                catch (const std::exception& e)
+                {
+                    source.exception = std::current_exception();
+                    source.errorMessage = e.what();
+                }
+                catch (...)
+                {
+                    source.exception = std::current_exception();
+                    source.errorMessage = "Unknown exception thrown by LOAD DATA generator!";
+                }
+                return -1;
+            }
+
+            static void end(void*) noexcept
+            {
+            }
+
+            static int error(void* sourcePtr, char* buffer, unsigned int length) noexcept
+            {
+                auto& source = *static_cast<LoadDataStreamSource*>(sourcePtr);
+                auto messageLength = std::min<std::size_t>(source.errorMessage.size(), length - 1);
+                std::memcpy(buffer, source.errorMessage.data(), messageLength);
+                buffer[messageLength] = '\0';
+                return CR_UNKNOWN_ERROR;
+            }
+
+        public:
+            LoadDataStreamSource(Generator& generator)
+                : generator{generator}
+            {
+            }
+
+            LoadDataStreamSource(const LoadDataStreamSource&) = delete;
+            LoadDataStreamSource& operator=(const LoadDataStreamSource&) = delete;
+
+            void install(LowLevel::DBDriver& driver) noexcept
+            {
+                driver.setLocalInfileHandler(&init, &read, &end, &error, this);
+            }
+
+            void rethrowIfFailed() const
+            {
+                if (exception)
+                {
+                    std::rethrow_exception(exception);
+                }
+            }
+        };
+
+
+        /**
+         * Executes LOAD DATA LOCAL INFILE statement fed by #generator.
+         *
+         * @param driver Connected driver.
+         * @param target Part of LOAD DATA statement following the file name.
+         * @param generator Callable bool(LoadDataRowWriter&) returning false when there are no more rows.
+         * @return Number of affected rows.
+         */
+        template<typename Generator>
+        LowLevel::DBDriver::RowCount loadDataStream(LowLevel::DBDriver& driver, const std::string& target, Generator& generator)
+        {
+            /**
+             * Enables LOAD DATA LOCAL INFILE on client side only for this statement (server accepts it only when
+             * the option was set before connecting). Previous state of the option is restored
+             * together with default handler, so that server can't request client files afterwards.
+             */
+            class LocalInfileGuard
+            {
+            private:
+                LowLevel::DBDriver& driver;
+                unsigned int previousLocalInfile = 0;
+
+            public:
+                LocalInfileGuard(LowLevel::DBDriver& driver)
+                    : driver{driver}
+                {
+                    driver.getDriverOption(LowLevel::DBDriver::DriverOptions::localInfile, &previousLocalInfile);
+                    unsigned int enableLocalInfile = 1;
+                    driver.setDriverOption(LowLevel::DBDriver::DriverOptions::localInfile, &enableLocalInfile);
+                }
+
+                ~LocalInfileGuard()
+                {
+                    driver.setLocalInfileDefault();
+                    try
+                    {
+                        driver.setDriverOption(LowLevel::DBDriver::DriverOptions::localInfile, &previousLocalInfile);
+                    }
+                    catch (...)
+                    {
+                        // Destructor must not throw
+                    }
+                }
+            };
+
+            LoadDataStreamSource<Generator> source{generator};
+            LocalInfileGuard guard{driver};
+            source.install(driver);
+
+            try
+            {
+                driver.execute("LOAD DATA LOCAL INFILE 'superior_mysqlpp_stream' " + target);
+            }
+            catch (const MysqlInternalError&)
+            {
+                // Prefer the original cause of failure
+                source.rethrowIfFailed();
+                throw;
+            }
+            return driver.affectedRows();
+        }
+    }
+}
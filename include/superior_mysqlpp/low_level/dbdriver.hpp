@@ -25,6 +25,7 @@
 #include <superior_mysqlpp/utils.hpp>
 #include <superior_mysqlpp/types/string_view.hpp>
 #include <superior_mysqlpp/low_level/mysql_hacks.hpp>
+#include <superior_mysqlpp/low_level/escape.hpp>
 
 
 // MariaDB connector/C is supported since version 10.2.
@@ -291,10 +292,11 @@ namespace SuperiorMySqlpp { namespace LowLevel
         template<typename T>
         std::string escapeString(const char* original, T originalLength)
         {
-            auto buffer = std::make_unique<char[]>(originalLength*2 + 1);
-            auto length = mysql_real_escape_string(getMysqlPtr(), buffer.get(), original, originalLength);
+            std::string result(originalLength*2 + 1, '\0');
+            auto length = escapeStringInto(&result.front(), original, originalLength);
+            result.resize(length);
 
-            return std::string(buffer.get(), length);
+            return result;
         }
 
         /**
@@ -311,6 +313,34 @@ namespace SuperiorMySqlpp { namespace LowLevel
             return escapeString(original.c_str(), original.length());
         }
 
+        /**
+         * Escapes string directly into caller's buffer without any allocation.
+         * It using charset from MySQL's connection.
+         * Output is identical to mysql_real_escape_string, but common charsets (latin1, utf8, utf8mb4)
+         * are processed by vectorized code.
+         * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-real-escape-string.html
+         *
+         * @param destination Output buffer; must have room for at least originalLength*2 + 1 characters.
+         * @param original C-style string.
+         * @param originalLength String length.
+         * @return Length of escaped string (without terminating null character).
+         */
+        FieldSize escapeStringInto(char* destination, const char* original, FieldSize originalLength) noexcept
+        {
+            auto escapeByLibrary = [this](char* to, const char* from, std::size_t fromLength){
+                return mysql_real_escape_string(getMysqlPtr(), to, from, fromLength);
+            };
+
+            if (getMysql().server_status & SERVER_STATUS_NO_BACKSLASH_ESCAPES)
+            {
+                // Quotes are doubled instead of escaping by backslash
+                return escapeByLibrary(destination, original, originalLength);
+            }
+
+            return detail::escapeString(destination, original, originalLength,
+                                        detail::getEscapeCharset(getCharacterSetName()), escapeByLibrary);
+        }
+
         /**
          * Escapes string to be legal for using in SQL statements.
          * It doesn't have information about used charset!
@@ -325,10 +355,15 @@ namespace SuperiorMySqlpp { namespace LowLevel
         template<typename T>
         static std::string escapeStringNoConnection(const char* original, T originalLength)
         {
-            auto buffer = std::make_unique<char[]>(originalLength*2 + 1);
-            auto length = mysql_escape_string(buffer.get(), original, originalLength);
+            std::string result(originalLength*2 + 1, '\0');
+            // mysql_escape_string uses library's default charset (latin1)
+            auto length = detail::escapeString(&result.front(), original, originalLength, detail::EscapeCharset::singleByte,
+                [](char* to, const char* from, std::size_t fromLength){
+                    return mysql_escape_string(to, from, fromLength);
+                });
+            result.resize(length);
 
-            return std::string(buffer.get(), length);
+            return result;
         }
 
         /**
@@ -786,6 +821,57 @@ namespace SuperiorMySqlpp { namespace LowLevel
             return mysql_get_client_version();
         }
 
+        /**
+         * Initializes thread-specific variables of library for calling thread.
+         * Must be called by every thread (other than the one which created connection)
+         * before it uses any connection and paired with #threadEnd.
+         * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-thread-init.html
+         *
+         * @throws MysqlInternalError When thread could not be initialized.
+         */
+        static void threadInit()
+        {
+            if (mysql_thread_init())
+            {
+                throw MysqlInternalError("Could not initialize MYSQL thread. (mysql_thread_init failed)");
+            }
+        }
+
+        /**
+         * Releases thread-specific variables allocated by #threadInit.
+         * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-thread-end.html
+         */
+        static void threadEnd() noexcept
+        {
+            mysql_thread_end();
+        }
+
+        /**
+         * Keeps library initialized for calling thread (#threadInit) during its lifetime,
+         * e.g. for code using connections on helper thread.
+         */
+        class ThreadGuard
+        {
+        public:
+            /**
+             * @throws MysqlInternalError When thread could not be initialized.
+             */
+            ThreadGuard()
+            {
+                threadInit();
+            }
+
+            ThreadGuard(const ThreadGuard&) = delete;
+            ThreadGuard(ThreadGuard&&) = delete;
+            ThreadGuard& operator=(const ThreadGuard&) = delete;
+            ThreadGuard& operator=(ThreadGuard&&) = delete;
+
+            ~ThreadGuard()
+            {
+                threadEnd();
+            }
+        };
+
         /**
          * Returns a string describing the connection type in use.
          * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-get-host-info.html
@@ -797,6 +883,33 @@ namespace SuperiorMySqlpp { namespace LowLevel
             return mysql_get_host_info(getMysqlPtr());
         }
 
+        /**
+         * Returns server port connection was opened to (0 for local socket).
+         */
+        unsigned int getPort() noexcept
+        {
+            return getMysql().port;
+        }
+
+        /**
+         * Returns user name connection is authenticated as.
+         */
+        std::string getUser()
+        {
+            return getMysql().user == nullptr? "" : getMysql().user;
+        }
+
+        /**
+         * Returns default database of connection. Client library keeps it also when it is changed
+         * by USE statement (server reports change of session schema).
+         *
+         * @return Database name or empty string when no database is selected.
+         */
+        std::string getDatabase()
+        {
+            return getMysql().db == nullptr? "" : getMysql().db;
+        }
+
         /**
          * Provides info about character set on the client.
          * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-get-character-set-info.html
@@ -1002,6 +1115,54 @@ namespace SuperiorMySqlpp { namespace LowLevel
             }
         }
 
+        /**
+         * Reads current value of connect option.
+         * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-get-option.html
+         *
+         * @param option Option to read.
+         * @param argumentPtr Storage of option's type the value is written to.
+         * @throws MysqlInternalError When option can't be read.
+         */
+        void getDriverOption(DriverOptions option, void* argumentPtr)
+        {
+            if (mysql_get_option(getMysqlPtr(), static_cast<mysql_option>(option), argumentPtr))
+            {
+                throw MysqlInternalError("Failed to get option!",
+                    mysql_error(getMysqlPtr()), mysql_errno(getMysqlPtr()));
+            }
+        }
+
+        /** Callback types of LOAD DATA LOCAL INFILE handler. */
+        using LocalInfileInit = int (*)(void**, const char*, void*);
+        using LocalInfileRead = int (*)(void*, char*, unsigned int);
+        using LocalInfileEnd = void (*)(void*);
+        using LocalInfileError = int (*)(void*, char*, unsigned int);
+
+        /**
+         * Installs callbacks which provide data for LOAD DATA LOCAL INFILE instead of reading a file.
+         * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-set-local-infile-handler.html
+         *
+         * @param init Called at the beginning of transfer; allocates the source state.
+         * @param read Fills buffer with data; returns number of bytes, 0 on EOF or negative value on error.
+         * @param end Called at the end of transfer; releases the source state.
+         * @param error Writes error message into buffer; returns error code.
+         * @param userData Pointer passed to #init.
+         */
+        void setLocalInfileHandler(LocalInfileInit init, LocalInfileRead read, LocalInfileEnd end,
+                                   LocalInfileError error, void* userData) noexcept
+        {
+            mysql_set_local_infile_handler(getMysqlPtr(), init, read, end, error, userData);
+        }
+
+        /**
+         * Restores default LOAD DATA LOCAL INFILE callbacks (reading from file system).
+         * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-set-local-infile-default.html
+         */
+        void setLocalInfileDefault() noexcept
+        {
+            mysql_set_local_infile_default(getMysqlPtr());
+        }
+
         /**
          * Checks whether the connection to the server is working.
          * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-ping.html
@@ -1030,6 +1191,18 @@ namespace SuperiorMySqlpp { namespace LowLevel
             return !mysql_ping(getMysqlPtr());
         }
 
+        /**
+         * Returns ID of server thread serving current connection.
+         * The ID changes when the connection is (automatically) reconnected.
+         * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-thread-id.html
+         *
+         * @return Server thread ID.
+         */
+        unsigned long getServerThreadId() noexcept
+        {
+            return mysql_thread_id(getMysqlPtr());
+        }
+
         /**
          * Retrieves additional human-readable information about the most recently executed statement.
          * The statement must be one of the following types: INSERT, LOAD DATA INFILE, ALTER TABLE, UPDATE.
@@ -1314,6 +1487,37 @@ namespace SuperiorMySqlpp { namespace LowLevel
                 return mysql_stmt_free_result(statementPtr);
             }
 
+            /**
+             * Resets statement on server, i.e. discards long data sent so far, result and cursor.
+             * Prepared query and bindings are kept.
+             */
+            void reset()
+            {
+                if (mysql_stmt_reset(statementPtr))
+                {
+                    throw MysqlInternalError("Failed to reset statement!",
+                        mysql_stmt_error(statementPtr), mysql_stmt_errno(statementPtr));
+                }
+            }
+
+            /**
+             * Detects whether result buffers are bound by #bindResult.
+             * Client library keeps them across executions, but may drop them when it reallocates result metadata.
+             */
+            bool isResultBound() noexcept
+            {
+                return statementPtr->bind_result_done;
+            }
+
+            /**
+             * Detects whether server signaled change of result metadata in response to last execution,
+             * e.g. when statement was automatically reprepared after referenced table was altered.
+             */
+            bool isResultMetadataChanged() noexcept
+            {
+                return statementPtr->mysql != nullptr && (statementPtr->mysql->server_status & SERVER_STATUS_METADATA_CHANGED);
+            }
+
             FieldCount fieldCount() noexcept
             {
                 static_assert(std::is_same<decltype(mysql_stmt_field_count(statementPtr)), FieldCount>::value,
@@ -1398,56 +1602,73 @@ namespace SuperiorMySqlpp { namespace LowLevel
                         return false;
 
                     case FetchStatus::DataTruncated:
-                        throw MysqlDataTruncatedError{"Data truncated while fetching statement!" + [&](){
-                            // Identify truncated columns
-                            auto&& resultBindingsPtr = statementPtr->bind;
-                            auto resultBindingsSize = statementPtr->field_count;
-                            assert(resultBindingsSize > 0u);
-
-                            std::vector<std::size_t> truncatedColumns{};
-                            std::vector<std::size_t> undetectedColumns{};
-                            std::size_t index = 0;
-                            for (auto it=resultBindingsPtr; it!=resultBindingsPtr+resultBindingsSize; ++it)
-                            {
-                                if (it->error == &it->error_value)
-                                {
-                                    if (it->error_value)
-                                    {
-                                        truncatedColumns.emplace_back(index);
-                                    }
-                                }
-                                else
-                                {
-                                    undetectedColumns.emplace_back(index);
-                                }
-                                ++index;
-                            }
+                        throwDataTruncatedError();
 
-                            std::string result{" Truncated columns: "};
-                            if (truncatedColumns.size() == 0)
-                            {
-                                result += "None.";
-                            }
-                            else
-                            {
-                                result += "[";
-                                result += toString(truncatedColumns);
-                                result += "].";
-                            }
+                    default:
+                        throw LogicError{"Internal error!"};
+                }
+            }
 
-                            if (undetectedColumns.size() > 0)
+            /**
+             * Throws MysqlDataTruncatedError identifying columns truncated by last fetch.
+             */
+            [[noreturn]] void throwDataTruncatedError()
+            {
+                throw MysqlDataTruncatedError{"Data truncated while fetching statement!" + [&](){
+                    // Identify truncated columns
+                    auto&& resultBindingsPtr = statementPtr->bind;
+                    auto resultBindingsSize = statementPtr->field_count;
+                    assert(resultBindingsSize > 0u);
+
+                    std::vector<std::size_t> truncatedColumns{};
+                    std::vector<std::size_t> undetectedColumns{};
+                    std::size_t index = 0;
+                    for (auto it=resultBindingsPtr; it!=resultBindingsPtr+resultBindingsSize; ++it)
+                    {
+                        if (it->error == &it->error_value)
+                        {
+                            if (it->error_value)
                             {
-                                result += " Following columns truncation state could not have been detected since you have set custom error pointer: ";
-                                result += toString(undetectedColumns);
-                                result += "!!!";
+                                truncatedColumns.emplace_back(index);
                             }
+                        }
+                        else
+                        {
+                            undetectedColumns.emplace_back(index);
+                        }
+                        ++index;
+                    }
 
-                            return result;
-                        }()};
+                    std::string result{" Truncated columns: "};
+                    if (truncatedColumns.size() == 0)
+                    {
+                        result += "None.";
+                    }
+                    else
+                    {
+                        result += "[";
+                        result += toString(truncatedColumns);
+                        result += "].";
+                    }
 
-                    default:
-                        throw LogicError{"Internal error!"};
-                }
+                    if (undetectedColumns.size() > 0)
+                    {
+                        result += " Following columns truncation state could not have been detected since you have set custom error pointer: ";
+                        result += toString(undetectedColumns);
+                        result += "!!!";
+                    }
+
+                    return result;
+                }()};
+            }
+
+            /**
+             * Returns true if value of column didn't fit into result binding buffer on last fetch.
+             */
+            bool isColumnTruncated(unsigned int column) const noexcept
+            {
+                auto& binding = statementPtr->bind[column];
+                return binding.error != nullptr && *binding.error;
             }
 
             void fetchColumn(MYSQL_BIND* bindings, unsigned int column, unsigned long offset)
@@ -1486,7 +1707,7 @@ namespace SuperiorMySqlpp { namespace LowLevel
             {
                 if (mysql_stmt_send_long_data(statementPtr, paramNumber, data, length))
                 {
-                    throw MysqlInternalError("Failed to store statement's result!",
+                    throw MysqlInternalError("Failed to send statement's long data!",
                         mysql_stmt_error(statementPtr), mysql_stmt_errno(statementPtr));
                 }
             }
@@ -1501,6 +1722,21 @@ namespace SuperiorMySqlpp { namespace LowLevel
                 return mysql_stmt_sqlstate(statementPtr);
             }
 
+#if defined(MARIADB_PACKAGE_VERSION)
+            /**
+             * Detects whether server supports MariaDB bulk execution (Attributes::arraySize).
+             */
+            bool isBulkExecuteSupported() noexcept
+            {
+                unsigned long capabilities = 0;
+                if (mariadb_get_infov(statementPtr->mysql, MARIADB_CONNECTION_EXTENDED_SERVER_CAPABILITIES, &capabilities))
+                {
+                    return false;
+                }
+                return (capabilities & (MARIADB_CLIENT_STMT_BULK_OPERATIONS >> 32)) != 0;
+            }
+#endif
+
             /**
              * Seeks to an arbitrary row in a statement result set.
              * @see https://dev.mysql.com/doc/refman/5.7/en/mysql-stmt-data-seek.html
@@ -1555,6 +1791,9 @@ namespace SuperiorMySqlpp { namespace LowLevel
                 updateMaxLength = STMT_ATTR_UPDATE_MAX_LENGTH,
                 cursorType = STMT_ATTR_CURSOR_TYPE,
                 prefetchRows = STMT_ATTR_PREFETCH_ROWS,
+#if defined(MARIADB_PACKAGE_VERSION)
+                arraySize = STMT_ATTR_ARRAY_SIZE,
+#endif
             };
 
             template<typename T>
@@ -0,0 +1,372 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+/*
+ * Vectorized replacement of mysql_real_escape_string for charsets in which
+ * every ASCII byte always represents itself (latin1, ascii, binary, utf8, utf8mb4).
+ *
+ * Input is scanned by 32 (AVX2) or 16 (SSE2) bytes for characters which need escaping
+ * and clean spans are copied at once. In UTF-8 charsets the clean spans are copied only
+ * when they are valid UTF-8; malformed sequences are passed to the C API, so the output
+ * is byte-for-byte identical to the one produced by the C API.
+ */
+
+namespace SuperiorMySqlpp { namespace LowLevel { namespace detail
+{
+    /**
+     * Classification of connection charsets for escaping purposes.
+     */
+    enum class EscapeCharset
+    {
+        /** Charset with multi-byte sequences containing ASCII bytes; C API must be used. */
+        generic,
+        /** Every byte is a character (latin1, ascii, binary). */
+        singleByte,
+        /** UTF-8 with at most 3 bytes per character (utf8, utf8mb3). */
+        utf8mb3,
+        /** UTF-8 with at most 4 bytes per character. */
+        utf8mb4,
+    };
+
+    /**
+     * Classifies charset by its name (as returned by mysql_character_set_name).
+     */
+    inline EscapeCharset getEscapeCharset(const char* name) noexcept
+    {
+        if (name == nullptr)
+        {
+            return EscapeCharset::generic;
+        }
+        if (std::strcmp(name, "utf8mb4") == 0)
+        {
+            return EscapeCharset::utf8mb4;
+        }
+        if (std::strcmp(name, "utf8") == 0 || std::strcmp(name, "utf8mb3") == 0)
+        {
+            return EscapeCharset::utf8mb3;
+        }
+        if (std::strcmp(name, "latin1") == 0 || std::strcmp(name, "ascii") == 0 || std::strcmp(name, "binary") == 0)
+        {
+            return EscapeCharset::singleByte;
+        }
+        return EscapeCharset::generic;
+    }
+
+    struct EscapeTable
+    {
+        /** Character following backslash in escape sequence; 0 when byte is not escaped. */
+        char values[256];
+    };
+
+    constexpr EscapeTable makeEscapeTable()
+    {
+        EscapeTable table{};
+        table.values[static_cast<unsigned char>('\0')] = '0';
+        table.values[static_cast<unsigned char>('\n')] = 'n';
+        table.values[static_cast<unsigned char>('\r')] = 'r';
+        table.values[static_cast<unsigned char>('\\')] = '\\';
+        table.values[static_cast<unsigned char>('\'')] = '\'';
+        table.values[static_cast<unsigned char>('"')] = '"';
+        table.values[static_cast<unsigned char>('\x1a')] = 'Z';
+        return table;
+    }
+
+    inline const EscapeTable& getEscapeTable() noexcept
+    {
+        static constexpr EscapeTable table = makeEscapeTable();
+        return table;
+    }
+
+    /**
+     * Finds first byte which needs escaping.
+     * @return Pointer to found byte or end.
+     */
+    inline const char* findEscapeCandidateScalar(const char* it, const char* end) noexcept
+    {
+        const auto& table = getEscapeTable();
+        while (it != end && table.values[static_cast<unsigned char>(*it)] == 0)
+        {
+            ++it;
+        }
+        return it;
+    }
+
+#if defined(__AVX2__)
+    inline const char* findEscapeCandidateAvx2(const char* it, const char* end) noexcept
+    {
+        const auto zero = _mm256_setzero_si256();
+        const auto newLine = _mm256_set1_epi8('\n');
+        const auto carriageReturn = _mm256_set1_epi8('\r');
+        const auto backslash = _mm256_set1_epi8('\\');
+        const auto quote = _mm256_set1_epi8('\'');
+        const auto doubleQuote = _mm256_set1_epi8('"');
+        const auto substitute = _mm256_set1_epi8('\x1a');
+
+        for (; end - it >= 32; it += 32)
+        {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+            auto special = _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, zero), _mm256_cmpeq_epi8(block, newLine)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, carriageReturn), _mm256_cmpeq_epi8(block, backslash))),
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, doubleQuote)),
+                    _mm256_cmpeq_epi8(block, substitute)));
+
+            auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(special));
+            if (mask != 0)
+            {
+                return it + __builtin_ctz(mask);
+            }
+        }
+        return it;
+    }
+#endif
+
+#if defined(__SSE2__)
+    inline const char* findEscapeCandidateSse2(const char* it, const char* end) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto newLine = _mm_set1_epi8('\n');
+        const auto carriageReturn = _mm_set1_epi8('\r');
+        const auto backslash = _mm_set1_epi8('\\');
+        const auto quote = _mm_set1_epi8('\'');
+        const auto doubleQuote = _mm_set1_epi8('"');
+        const auto substitute = _mm_set1_epi8('\x1a');
+
+        for (; end - it >= 16; it += 16)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+            auto special = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(block, zero), _mm_cmpeq_epi8(block, newLine)),
+                    _mm_or_si128(_mm_cmpeq_epi8(block, carriageReturn), _mm_cmpeq_epi8(block, backslash))),
+                _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, doubleQuote)),
+                    _mm_cmpeq_epi8(block, substitute)));
+
+            auto mask = static_cast<unsigned int>(_mm_movemask_epi8(special));
+            if (mask != 0)
+            {
+                return it + __builtin_ctz(mask);
+            }
+        }
+        return it;
+    }
+#endif
+
+    /**
+     * Finds first byte which needs escaping using the widest instruction set enabled at compile time.
+     */
+    template<bool vectorized=true>
+    inline const char* findEscapeCandidate(const char* it, const char* end) noexcept
+    {
+        if (vectorized)
+        {
+#if defined(__AVX2__)
+            it = findEscapeCandidateAvx2(it, end);
+            if (end - it >= 32)
+            {
+                return it;
+            }
+#endif
+#if defined(__SSE2__)
+            it = findEscapeCandidateSse2(it, end);
+            if (end - it >= 16)
+            {
+                return it;
+            }
+#endif
+        }
+        return findEscapeCandidateScalar(it, end);
+    }
+
+    /**
+     * Checks whether [it, end) is well-formed UTF-8 consisting of characters
+     * not longer than maxLength bytes (surrogates and overlong forms are rejected).
+     */
+    inline bool isValidUtf8(const unsigned char* it, const unsigned char* end, int maxLength) noexcept
+    {
+        while (it != end)
+        {
+            // Skip ASCII by words
+            std::uint64_t word;
+            while (end - it >= 8 && (std::memcpy(&word, it, 8), (word & 0x8080808080808080u) == 0))
+            {
+                it += 8;
+            }
+            if (it == end)
+            {
+                break;
+            }
+
+            auto lead = *it;
+            int length;
+            unsigned char secondMin = 0x80;
+            unsigned char secondMax = 0xBF;
+            if (lead < 0x80)
+            {
+                length = 1;
+            }
+            else if (lead < 0xC2)
+            {
+                return false;
+            }
+            else if (lead < 0xE0)
+            {
+                length = 2;
+            }
+            else if (lead < 0xF0)
+            {
+                length = 3;
+                if (lead == 0xE0)
+                {
+                    secondMin = 0xA0;
+                }
+                else if (lead == 0xED)
+                {
+                    secondMax = 0x9F;
+                }
+            }
+            else if (lead < 0xF5)
+            {
+                length = 4;
+                if (lead == 0xF0)
+                {
+                    secondMin = 0x90;
+                }
+                else if (lead == 0xF4)
+                {
+                    secondMax = 0x8F;
+                }
+            }
+            else
+            {
+                return false;
+            }
+
+            if (length > maxLength || end - it < length)
+            {
+                return false;
+            }
+            if (length > 1)
+            {
+                if (it[1] < secondMin || it[1] > secondMax)
+                {
+                    return false;
+                }
+                for (int i=2; i<length; ++i)
+                {
+                    if ((it[i] & 0xC0) != 0x80)
+                    {
+                        return false;
+                    }
+                }
+            }
+            it += length;
+        }
+        return true;
+    }
+
+    /**
+     * Copies span without characters to be escaped which contains malformed UTF-8.
+     * Valid non-ASCII runs are copied, malformed ones are escaped by the C API.
+     * Splitting input before an ASCII byte does not change output of the C API.
+     *
+     * @return Pointer past the last written character.
+     */
+    template<typename Fallback>
+    inline char* copyMalformedUtf8(char* to, const char* it, const char* end, int maxLength, Fallback& fallback)
+    {
+        while (it != end)
+        {
+            auto runBegin = it;
+            while (it != end && static_cast<unsigned char>(*it) < 0x80)
+            {
+                ++it;
+            }
+            std::memcpy(to, runBegin, it - runBegin);
+            to += it - runBegin;
+
+            runBegin = it;
+            while (it != end && static_cast<unsigned char>(*it) >= 0x80)
+            {
+                ++it;
+            }
+            if (isValidUtf8(reinterpret_cast<const unsigned char*>(runBegin), reinterpret_cast<const unsigned char*>(it), maxLength))
+            {
+                std::memcpy(to, runBegin, it - runBegin);
+                to += it - runBegin;
+            }
+            else
+            {
+                to += fallback(to, runBegin, it - runBegin);
+            }
+        }
+        return to;
+    }
+
+    /**
+     * Escapes string in the same way as mysql_real_escape_string does (without NO_BACKSLASH_ESCAPES).
+     *
+     * @tparam vectorized Use SIMD scanning; false is useful for testing and benchmarking only.
+     * @param to Output buffer; must have room for at least length*2 + 1 characters.
+     * @param from Input string.
+     * @param length Length of input string.
+     * @param charset Classification of connection charset.
+     * @param fallback Callable std::size_t(char* to, const char* from, std::size_t length)
+     *                 escaping by the C API; used for generic charsets and malformed UTF-8.
+     * @return Length of escaped string (terminating null character is written but not counted).
+     */
+    template<bool vectorized=true, typename Fallback>
+    inline std::size_t escapeString(char* to, const char* from, std::size_t length, EscapeCharset charset, Fallback&& fallback)
+    {
+        if (charset == EscapeCharset::generic)
+        {
+            return fallback(to, from, length);
+        }
+
+        const auto& table = getEscapeTable();
+        const bool isUtf8 = charset != EscapeCharset::singleByte;
+        const int maxUtf8Length = charset == EscapeCharset::utf8mb4? 4 : 3;
+        const auto begin = to;
+        const auto end = from + length;
+        while (true)
+        {
+            // Multi-byte UTF-8 sequence never contains ASCII byte, so it can not span over escaped character
+            auto next = findEscapeCandidate<vectorized>(from, end);
+            if (isUtf8 && !isValidUtf8(reinterpret_cast<const unsigned char*>(from), reinterpret_cast<const unsigned char*>(next), maxUtf8Length))
+            {
+                to = copyMalformedUtf8(to, from, next, maxUtf8Length, fallback);
+            }
+            else
+            {
+                std::memcpy(to, from, next - from);
+                to += next - from;
+            }
+
+            if (next == end)
+            {
+                break;
+            }
+            *to++ = '\\';
+            *to++ = table.values[static_cast<unsigned char>(*next)];
+            from = next + 1;
+        }
+        *to = '\0';
+        return to - begin;
+    }
+}}}
@@ -0,0 +1,392 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include <superior_mysqlpp/column_name_index.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/field.hpp>
+#include <superior_mysqlpp/query_result.hpp>
+#include <superior_mysqlpp/types/string_view.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Owned copy of result rows stored in single allocation (arena).
+     *
+     * Arena holds rows*fields+1 field offsets, NULL bitmap (bit set for NULL field) and field data.
+     * Rows are accessed through RowView which returns Field like Row does,
+     * so converted values and data stay valid as long as the set exists (unlike rows of result).
+     */
+    class OwnedRowSet
+    {
+    public:
+        class RowView
+        {
+        private:
+            const OwnedRowSet* rowSet;
+            std::size_t first;
+
+        public:
+            RowView(const OwnedRowSet& rowSet, std::size_t row) noexcept
+                : rowSet{&rowSet}, first{row * rowSet.fieldsCount}
+            {
+            }
+
+            unsigned int size() const noexcept
+            {
+                return rowSet->fieldsCount;
+            }
+
+            bool isNull(unsigned int index) const noexcept
+            {
+                return rowSet->isNullField(first + index);
+            }
+
+            Field operator[](unsigned int index) const noexcept
+            {
+                return rowSet->getField(first + index);
+            }
+
+            Field operator[](ColumnHandle column) const noexcept
+            {
+                return (*this)[static_cast<unsigned int>(column.getIndex())];
+            }
+        };
+
+        class Iterator
+        {
+        private:
+            const OwnedRowSet* rowSet;
+            std::size_t row;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = RowView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = RowView;
+
+            Iterator(const OwnedRowSet& rowSet, std::size_t row) noexcept
+                : rowSet{&rowSet}, row{row}
+            {
+            }
+
+            RowView operator*() const noexcept
+            {
+                return {*rowSet, row};
+            }
+
+            Iterator& operator++() noexcept
+            {
+                ++row;
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                auto copy = *this;
+                ++row;
+                return copy;
+            }
+
+            bool operator==(const Iterator& other) const noexcept
+            {
+                return row == other.row;
+            }
+
+            bool operator!=(const Iterator& other) const noexcept
+            {
+                return row != other.row;
+            }
+        };
+
+    private:
+        unsigned int fieldsCount = 0;
+        std::size_t rowsCount = 0;
+        std::vector<std::string> columnNames{};
+        detail::ColumnNameIndex columnNameIndex{};
+
+        std::unique_ptr<char[]> arena{};
+        std::size_t arenaSize = 0;
+        const std::size_t* offsets = nullptr;
+        const std::uint8_t* nullBitmap = nullptr;
+        char* fieldsData = nullptr;
+
+    private:
+        static std::size_t getBitmapSize(std::size_t fields) noexcept
+        {
+            return (fields + 7) / 8;
+        }
+
+        bool isNullField(std::size_t field) const noexcept
+        {
+            return nullBitmap[field / 8] & (1u << (field % 8));
+        }
+
+        Field getField(std::size_t field) const noexcept
+        {
+            if (isNullField(field))
+            {
+                return {nullptr, 0};
+            }
+            return {fieldsData + offsets[field], static_cast<unsigned long>(offsets[field + 1] - offsets[field])};
+        }
+
+        void initializeColumns(const ResultMetadata& metadata)
+        {
+            columnNames.reserve(metadata.size());
+            std::vector<StringView> names{};
+            names.reserve(metadata.size());
+            for (auto&& field: metadata)
+            {
+                columnNames.emplace_back(field.getColumnName());
+            }
+            // Names are referenced after the vector is complete; moving the set keeps them in place
+            for (auto&& name: columnNames)
+            {
+                names.emplace_back(name);
+            }
+            columnNameIndex = detail::ColumnNameIndex{std::move(names)};
+        }
+
+        /**
+         * Allocates arena for given number of rows and data bytes; offsets and bitmap are written by caller.
+         */
+        std::pair<std::size_t*, std::uint8_t*> allocate(std::size_t rows, std::size_t dataSize)
+        {
+            rowsCount = rows;
+            auto fields = rows * fieldsCount;
+            auto offsetsSize = (fields + 1) * sizeof(std::size_t);
+            auto bitmapSize = getBitmapSize(fields);
+            arenaSize = offsetsSize + bitmapSize + dataSize;
+            // new char[] is aligned for any fundamental type, offsets go first
+            arena.reset(new char[arenaSize]);
+
+            auto offsetsPtr = reinterpret_cast<std::size_t*>(arena.get());
+            auto bitmapPtr = reinterpret_cast<std::uint8_t*>(arena.get() + offsetsSize);
+            std::memset(bitmapPtr, 0, bitmapSize);
+            offsets = offsetsPtr;
+            nullBitmap = bitmapPtr;
+            fieldsData = arena.get() + offsetsSize + bitmapSize;
+            return {offsetsPtr, bitmapPtr};
+        }
+
+    public:
+        OwnedRowSet() = default;
+
+        /**
+         * Copies all remaining rows of stored result; the result is read twice
+         * (to compute size of arena and to copy data).
+         */
+        explicit OwnedRowSet(StoreQueryResult& result)
+            : fieldsCount{static_cast<unsigned int>(result.getMetadata().size())}
+        {
+            initializeColumns(result.getMetadata());
+
+            auto& lowLevelResult = result.detail_getResult();
+            auto start = lowLevelResult.tellRowOffset();
+            std::size_t rows = 0;
+            std::size_t dataSize = 0;
+            while (lowLevelResult.fetchRow() != nullptr)
+            {
+                auto lengths = lowLevelResult.fetchLengths();
+                for (unsigned int i=0; i<fieldsCount; ++i)
+                {
+                    dataSize += lengths[i];
+                }
+                ++rows;
+            }
+
+            auto pointers = allocate(rows, dataSize);
+            lowLevelResult.seekRowOffset(start);
+            std::size_t field = 0;
+            std::size_t offset = 0;
+            for (std::size_t r=0; r<rows; ++r)
+            {
+                auto row = lowLevelResult.fetchRow();
+                auto lengths = lowLevelResult.fetchLengths();
+                for (unsigned int i=0; i<fieldsCount; ++i, ++field)
+                {
+                    pointers.first[field] = offset;
+                    if (row[i] == nullptr)
+                    {
+                        pointers.second[field / 8] |= static_cast<std::uint8_t>(1u << (field % 8));
+                    }
+                    else
+                    {
+                        std::memcpy(fieldsData + offset, row[i], lengths[i]);
+                        offset += lengths[i];
+                    }
+                }
+            }
+            pointers.first[field] = offset;
+        }
+
+        explicit OwnedRowSet(StoreQueryResult&& result)
+            : OwnedRowSet{result}
+        {
+        }
+
+        /**
+         * Copies all remaining rows of use result; rows are gathered in temporary buffers
+         * and moved into arena at the end.
+         */
+        explicit OwnedRowSet(UseQueryResult& result)
+            : fieldsCount{static_cast<unsigned int>(result.getMetadata().size())}
+        {
+            initializeColumns(result.getMetadata());
+
+            auto& lowLevelResult = result.detail_getResult();
+            std::string data{};
+            std::vector<std::size_t> fieldOffsets{};
+            std::vector<bool> nulls{};
+            std::size_t rows = 0;
+            while (auto row = lowLevelResult.checkedFetchRow())
+            {
+                auto lengths = lowLevelResult.fetchLengths();
+                for (unsigned int i=0; i<fieldsCount; ++i)
+                {
+                    fieldOffsets.push_back(data.size());
+                    nulls.push_back(row[i] == nullptr);
+                    if (row[i] != nullptr)
+                    {
+                        data.append(row[i], lengths[i]);
+                    }
+                }
+                ++rows;
+            }
+
+            auto pointers = allocate(rows, data.size());
+            std::copy(fieldOffsets.begin(), fieldOffsets.end(), pointers.first);
+            pointers.first[fieldOffsets.size()] = data.size();
+            for (std::size_t field=0; field<nulls.size(); ++field)
+            {
+                if (nulls[field])
+                {
+                    pointers.second[field / 8] |= static_cast<std::uint8_t>(1u << (field % 8));
+                }
+            }
+            std::copy(data.begin(), data.end(), fieldsData);
+        }
+
+        explicit OwnedRowSet(UseQueryResult&& result)
+            : OwnedRowSet{result}
+        {
+        }
+
+        /**
+         * Moved from set is empty. Moving keeps column names in place, so column index stays valid.
+         */
+        OwnedRowSet(OwnedRowSet&& other) noexcept
+            : fieldsCount{std::exchange(other.fieldsCount, 0)},
+              rowsCount{std::exchange(other.rowsCount, 0)},
+              columnNames{std::move(other.columnNames)},
+              columnNameIndex{std::exchange(other.columnNameIndex, detail::ColumnNameIndex{})},
+              arena{std::move(other.arena)},
+              arenaSize{std::exchange(other.arenaSize, 0)},
+              offsets{std::exchange(other.offsets, nullptr)},
+              nullBitmap{std::exchange(other.nullBitmap, nullptr)},
+              fieldsData{std::exchange(other.fieldsData, nullptr)}
+        {
+        }
+
+        OwnedRowSet& operator=(OwnedRowSet&& other) noexcept
+        {
+            fieldsCount = std::exchange(other.fieldsCount, 0);
+            rowsCount = std::exchange(other.rowsCount, 0);
+            columnNames = std::move(other.columnNames);
+            columnNameIndex = std::exchange(other.columnNameIndex, detail::ColumnNameIndex{});
+            arena = std::move(other.arena);
+            arenaSize = std::exchange(other.arenaSize, 0);
+            offsets = std::exchange(other.offsets, nullptr);
+            nullBitmap = std::exchange(other.nullBitmap, nullptr);
+            fieldsData = std::exchange(other.fieldsData, nullptr);
+            return *this;
+        }
+
+        OwnedRowSet(const OwnedRowSet&) = delete;
+        OwnedRowSet& operator=(const OwnedRowSet&) = delete;
+
+        std::size_t getRowsCount() const noexcept
+        {
+            return rowsCount;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return rowsCount;
+        }
+
+        bool empty() const noexcept
+        {
+            return rowsCount == 0;
+        }
+
+        unsigned int getFieldsCount() const noexcept
+        {
+            return fieldsCount;
+        }
+
+        /**
+         * @return Number of bytes of arena (offsets, NULL bitmap and data).
+         */
+        std::size_t getArenaSize() const noexcept
+        {
+            return arenaSize;
+        }
+
+        const std::vector<std::string>& getColumnNames() const noexcept
+        {
+            return columnNames;
+        }
+
+        /**
+         * @throws OutOfRange When there is no column with given name.
+         */
+        std::size_t getColumnIndex(StringView columnName) const
+        {
+            auto index = columnNameIndex.find(columnName);
+            if (index == columnNameIndex.size())
+            {
+                throw OutOfRange{"Column name \"" + std::string(columnName) + "\" not found!"};
+            }
+            return index;
+        }
+
+        /**
+         * @throws OutOfRange When there is no column with given name.
+         */
+        ColumnHandle getColumnHandle(StringView columnName) const
+        {
+            return ColumnHandle{getColumnIndex(columnName)};
+        }
+
+        RowView operator[](std::size_t row) const noexcept
+        {
+            return {*this, row};
+        }
+
+        Iterator begin() const noexcept
+        {
+            return {*this, 0};
+        }
+
+        Iterator end() const noexcept
+        {
+            return {*this, rowsCount};
+        }
+    };
+}
@@ -0,0 +1,278 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <deque>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <functional>
+
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/query_result.hpp>
+#include <superior_mysqlpp/row_batch.hpp>
+#include <superior_mysqlpp/worker_pool.hpp>
+#include <superior_mysqlpp/prepared_statements/prepared_statement_base.hpp>
+#include <superior_mysqlpp/utils.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    namespace detail
+    {
+        /**
+         * Fetches chunks on calling thread and processes them in pool.
+         *
+         * At most 2 chunks per thread are in flight. Chunks are retired in fetch order,
+         * so finish is called in row order (which allows ordered reassembly) and chunks are reused.
+         *
+         * @param fetch bool(Chunk&); refills chunk, returns false when there is no more data.
+         * @param process void(Chunk&); runs in pool.
+         * @param finish void(Chunk&); runs on calling thread.
+         */
+        template<typename Chunk, typename Fetch, typename Process, typename Finish>
+        void processChunksInParallel(WorkerPool& pool, Fetch&& fetch, Process&& process, Finish&& finish)
+        {
+            struct InFlightChunk
+            {
+                std::unique_ptr<Chunk> chunk;
+                std::future<void> processed;
+            };
+
+            // Tasks reference chunks and functions, they must be done before leaving
+            struct InFlightChunks
+            {
+                std::deque<InFlightChunk> chunks{};
+
+                ~InFlightChunks()
+                {
+                    for (auto&& item: chunks)
+                    {
+                        item.processed.wait();
+                    }
+                }
+            } inFlight{};
+
+            const auto maxInFlight = 2 * pool.getThreadsCount();
+            std::vector<std::unique_ptr<Chunk>> freeChunks{};
+
+            auto retireFront = [&](){
+                auto item = std::move(inFlight.chunks.front());
+                inFlight.chunks.pop_front();
+                item.processed.get();
+                finish(*item.chunk);
+                freeChunks.emplace_back(std::move(item.chunk));
+            };
+
+            while (true)
+            {
+                std::unique_ptr<Chunk> chunk{};
+                if (freeChunks.empty())
+                {
+                    chunk.reset(new Chunk{});
+                }
+                else
+                {
+                    chunk = std::move(freeChunks.back());
+                    freeChunks.pop_back();
+                }
+
+                if (!fetch(*chunk))
+                {
+                    break;
+                }
+
+                auto& chunkRef = *chunk;
+                auto processed = pool.submit([&process, &chunkRef](){ process(chunkRef); });
+                inFlight.chunks.push_back({std::move(chunk), std::move(processed)});
+
+                if (inFlight.chunks.size() >= maxInFlight)
+                {
+                    retireFront();
+                }
+            }
+
+            while (!inFlight.chunks.empty())
+            {
+                retireFront();
+            }
+        }
+
+        template<typename Result>
+        struct OrderedRowChunk
+        {
+            RowBatch rows{};
+            std::vector<Result> results{};
+        };
+
+        template<typename Tuple, typename Result>
+        struct OrderedTupleChunk
+        {
+            std::vector<Tuple> rows{};
+            std::vector<Result> results{};
+        };
+
+        inline void checkChunkSize(std::size_t chunkSize)
+        {
+            if (chunkSize == 0)
+            {
+                throw LogicError{"Chunk size must be positive!"};
+            }
+        }
+
+        /**
+         * Copies up to chunkSize rows of prepared statement result into chunk.
+         */
+        template<typename PreparedStatementType, typename Tuple>
+        bool fetchTupleChunk(PreparedStatementType& ps, std::vector<Tuple>& chunk, std::size_t chunkSize, bool& finished)
+        {
+            chunk.clear();
+            while (!finished && chunk.size() < chunkSize)
+            {
+                if (!ps.fetch())
+                {
+                    finished = true;
+                    break;
+                }
+                chunk.push_back(ps.getResult());
+            }
+            return !chunk.empty();
+        }
+
+        template<typename PreparedStatementType>
+        using ResultTuple = std::decay_t<decltype(std::declval<PreparedStatementType&>().getResult())>;
+    }
+
+
+    /**
+     * Calls function(Row&) for every remaining row of result; rows are fetched by chunks
+     * on calling thread and processed concurrently by pool threads, in no particular order.
+     *
+     * @throws LogicError When chunkSize is 0.
+     * @remark Exception thrown by function is rethrown after all chunks in flight are done.
+     */
+    template<typename F>
+    void parallelForEachRow(WorkerPool& pool, UseQueryResult& result, F function, std::size_t chunkSize)
+    {
+        detail::checkChunkSize(chunkSize);
+        detail::processChunksInParallel<RowBatch>(pool,
+            [&](RowBatch& batch){
+                return result.fetchBatch(batch, chunkSize) != 0;
+            },
+            [&](RowBatch& batch){
+                for (std::size_t i=0; i<batch.size(); ++i)
+                {
+                    auto row = batch[i];
+                    function(row);
+                }
+            },
+            [](RowBatch&){}
+        );
+    }
+
+    /**
+     * Ordered variant: function(Row&) runs concurrently in pool and its results are passed
+     * to consumer on calling thread in row order.
+     *
+     * @throws LogicError When chunkSize is 0.
+     */
+    template<typename F, typename Consumer>
+    void parallelForEachRow(WorkerPool& pool, UseQueryResult& result, F function, std::size_t chunkSize, Consumer consumer)
+    {
+        using Result = std::decay_t<decltype(function(std::declval<Row&>()))>;
+        using Chunk = detail::OrderedRowChunk<Result>;
+
+        detail::checkChunkSize(chunkSize);
+        detail::processChunksInParallel<Chunk>(pool,
+            [&](Chunk& chunk){
+                chunk.results.clear();
+                return result.fetchBatch(chunk.rows, chunkSize) != 0;
+            },
+            [&](Chunk& chunk){
+                chunk.results.reserve(chunk.rows.size());
+                for (std::size_t i=0; i<chunk.rows.size(); ++i)
+                {
+                    auto row = chunk.rows[i];
+                    chunk.results.emplace_back(function(row));
+                }
+            },
+            [&](Chunk& chunk){
+                for (auto&& value: chunk.results)
+                {
+                    consumer(std::move(value));
+                }
+            }
+        );
+    }
+
+    /**
+     * Calls function with values of every remaining row of executed prepared statement
+     * (same signature as psQuery processing function); rows are copied by chunks
+     * on calling thread and processed concurrently by pool threads, in no particular order.
+     *
+     * @throws LogicError When chunkSize is 0.
+     */
+    template<typename PreparedStatementType, typename F,
+             typename = std::enable_if_t<std::is_base_of<detail::StatementBase, PreparedStatementType>::value>>
+    void parallelForEachRow(WorkerPool& pool, PreparedStatementType& ps, F function, std::size_t chunkSize)
+    {
+        using Chunk = std::vector<detail::ResultTuple<PreparedStatementType>>;
+
+        detail::checkChunkSize(chunkSize);
+        bool finished = false;
+        detail::processChunksInParallel<Chunk>(pool,
+            [&](Chunk& chunk){
+                return detail::fetchTupleChunk(ps, chunk, chunkSize, finished);
+            },
+            [&](Chunk& chunk){
+                for (auto&& values: chunk)
+                {
+                    invokeViaTuple(std::ref(function), values);
+                }
+            },
+            [](Chunk&){}
+        );
+    }
+
+    /**
+     * Ordered variant for prepared statement; results of function are passed
+     * to consumer on calling thread in row order.
+     *
+     * @throws LogicError When chunkSize is 0.
+     */
+    template<typename PreparedStatementType, typename F, typename Consumer,
+             typename = std::enable_if_t<std::is_base_of<detail::StatementBase, PreparedStatementType>::value>>
+    void parallelForEachRow(WorkerPool& pool, PreparedStatementType& ps, F function, std::size_t chunkSize, Consumer consumer)
+    {
+        using Tuple = detail::ResultTuple<PreparedStatementType>;
+        using Result = std::decay_t<decltype(invokeViaTuple(std::ref(function), std::declval<Tuple&>()))>;
+        using Chunk = detail::OrderedTupleChunk<Tuple, Result>;
+
+        detail::checkChunkSize(chunkSize);
+        bool finished = false;
+        detail::processChunksInParallel<Chunk>(pool,
+            [&](Chunk& chunk){
+                chunk.results.clear();
+                return detail::fetchTupleChunk(ps, chunk.rows, chunkSize, finished);
+            },
+            [&](Chunk& chunk){
+                chunk.results.reserve(chunk.rows.size());
+                for (auto&& values: chunk.rows)
+                {
+                    chunk.results.emplace_back(invokeViaTuple(std::ref(function), values));
+                }
+            },
+            [&](Chunk& chunk){
+                for (auto&& value: chunk.results)
+                {
+                    consumer(std::move(value));
+                }
+            }
+        );
+    }
+}
@@ -14,10 +14,15 @@
 #include <cstring>
 #include <cinttypes>
 #include <memory>
+#include <iterator>
 
 #include <superior_mysqlpp/prepared_statements/initialize_bindings.hpp>
+#include <superior_mysqlpp/prepared_statements/bulk_params_bindings.hpp>
+#include <superior_mysqlpp/prepared_statements/fetch_truncated_columns.hpp>
+#include <superior_mysqlpp/prepared_statements/send_long_data_params.hpp>
 #include <superior_mysqlpp/prepared_statements/prepared_statement_base.hpp>
 #include <superior_mysqlpp/prepared_statements/default_initialize_result.hpp>
+#include <superior_mysqlpp/struct_mapping.hpp>
 #include <superior_mysqlpp/low_level/dbdriver.hpp>
 #include <superior_mysqlpp/connection_def.hpp>
 #include <superior_mysqlpp/metadata.hpp>
@@ -85,12 +90,41 @@
  * // Optional step - if we decide to change parameters (shall happen before execution)
  * ``` c++
  * preparedStatement.setParams(123,StringData{"Xyzzy"});
- * preparedStatement.updateParamsBindings(); // Updates binding information, required step for most nontrivial parameter types
+ * preparedStatement.updateParamsBindings(); // Updates binding information, required for std::string, C strings and Nullables becoming non-null
  * preparedStatement.execute(); // Statement is performed now
- * preparedStatement.setParams(666,StringData{"Elbereth"});
- * preparedStatement.updateParamsBindings();
+ * preparedStatement.setParams(666,StringData{"Elbereth"}); // Numbers and StringData are just stored, binding is not affected
  * preparedStatement.execute(); // Statement is performed again, now with different parameters
  * ```
+ *
+ * // Optional - reading huge result through server-side cursor (rows are transferred in chunks as they are fetched)
+ * ``` c++
+ * auto preparedStatement = connection.makePreparedStatement<ResultBindings<Sql::Int>, false,
+ *         ValidateMetadataMode::ArithmeticPromotions, ValidateMetadataMode::Same, false, CursorMode::ReadOnly>(
+ *     "SELECT `id` FROM `transactions`"
+ * );
+ * preparedStatement.setPrefetchRowCount(4096);
+ * ```
+ *
+ * // Optional step - executing statement (without result) for many sets of parameters at once
+ * ``` c++
+ * std::vector<std::tuple<int, StringData>> rows{...};
+ * auto affectedRows = preparedStatement.executeBulk(rows);
+ * ```
+ *
+ * // Optional - uploading huge blob without loading it into memory (sent in chunks on execution)
+ * ``` c++
+ * std::ifstream file{"image.png", std::ios::binary};
+ * preparedStatement.setParams(42, LongDataSource::fromStream(file));
+ * preparedStatement.execute();
+ * ```
+ *
+ * // Optional - rows as structs with members declared by SUPERIOR_MYSQLPP_MEMBERS, fetched without copying
+ * ``` c++
+ * auto preparedStatement = PreparedStatement<StructResultBindings<Transaction>, ParamBindings<>>(connection, "SELECT ...");
+ * preparedStatement.execute();
+ * std::vector<Transaction> transactions{};
+ * preparedStatement.fetchAllInto(transactions);
+ * ```
  **/
 
 
@@ -144,10 +178,14 @@ namespace SuperiorMySqlpp
         /**
          * Updates bindings to properly reflect on data.
          * Is fundamental for useability of Bindings and is thus called during initialization.
+         * @return True if buffer address, type or length/null indicator pointer of any binding changed
+         *         (or buffer length of result binding), i.e. bindings have to be passed to C client again.
          */
-        void update()
+        bool update()
         {
+            auto previous = bindings;
             detail::initializeBindings<IsParamBinding>(bindings, data);
+            return detail::isRebindRequired<IsParamBinding>(previous, bindings);
         }
     };
 
@@ -185,10 +223,16 @@ namespace SuperiorMySqlpp
      * @tparam warnMode Defines level of conversion that triggers warning, but is still acceptable.
      * @tparam ignoreNullable If true, one can store nullable data of type T from database to result storage of type T (directly withnout SuperiorMySqlpp::Nullable).
      *                      If the nullable is in null state, nothing will be assigned to given result field.
+     * @tparam cursorMode If CursorMode::ReadOnly, execute opens read-only cursor on server and rows are transferred
+     *                    in chunks of prefetch row count (see setPrefetchRowCount) as they are fetched.
+     *                    Client memory is bounded and remaining rows are not transferred when result is freed early.
+     *                    Requires use mode (storeResult=false).
      */
-    template<typename ResultBindings, typename ParamBindings, bool storeResult, ValidateMetadataMode validateMode, ValidateMetadataMode warnMode, bool ignoreNullable>
+    template<typename ResultBindings, typename ParamBindings, bool storeResult, ValidateMetadataMode validateMode, ValidateMetadataMode warnMode, bool ignoreNullable, CursorMode cursorMode>
     class PreparedStatement : public detail::PreparedStatementBase<storeResult, validateMode, warnMode, ignoreNullable>
     {
+        static_assert(cursorMode == CursorMode::Disabled || !storeResult, "Cursor can be used only in use mode (storeResult=false)!");
+
     private:
         ResultBindings resultBindings;
         static_assert(!ResultBindings::isParamBinding, "Result bindings are not of type ResultBindings<Args...>!");
@@ -196,9 +240,134 @@ namespace SuperiorMySqlpp
         ParamBindings paramsBindings;
         static_assert(ParamBindings::isParamBinding, "Param bindings are not of type ParamBindings<Args...>!");
 
-        bool hasValidatedResultMetadata = false;
+        /**
+         * Result field count was checked, metadata validated and result bound.
+         * Bound state is kept by client library across executions, so it is repeated only when server
+         * signals metadata change or when bindings array moved (statement was moved).
+         */
+        bool isResultChecked = false;
+
+        /** Result bindings array bound when result was checked. */
+        const MYSQL_BIND* boundResultBindings = nullptr;
+
+        /**
+         * Params bindings array passed to C client; lengths and null flags are read through pointers
+         * on every execution, so params are bound again only when some buffer moves or bindings array moved.
+         */
+        const MYSQL_BIND* boundParamsBindings = nullptr;
+
+        /** Bindings pointing to members of struct row, see #fetchInto. */
+        std::array<MYSQL_BIND, ResultBindings::kArgumentsCount> rowResultBindings{{}};
+
+        /** Result is bound to members of struct row instead of #resultBindings. */
+        bool isResultBoundToRow = false;
 
     private:
+        template<typename Container>
+        LowLevel::DBDriver::RowCount executeBulkSequentially(const Container& rows)
+        {
+            LowLevel::DBDriver::RowCount affectedRows = 0;
+            for (auto&& row: rows)
+            {
+                paramsBindings.data = detail::toParamsRow(row);
+                updateParamsBindings();
+                execute();
+                affectedRows += this->statement.affectedRows();
+            }
+            return affectedRows;
+        }
+
+        /**
+         * Checks result field count, validates result metadata and binds result.
+         */
+        void bindResult()
+        {
+            if (isResultChecked)
+            {
+                this->invalidateResultMetadata();
+                isResultChecked = false;
+            }
+            // Bindings may point to storage of statement this one was moved from
+            resultBindings.update();
+
+            auto fieldCount = this->statement.fieldCount();
+            if (fieldCount != resultBindings.kArgumentsCount)
+            {
+                throw PreparedStatementTypeError{"Result types count (" + std::to_string(resultBindings.kArgumentsCount) +
+                        ") in query doesn't match number of returned fields (" + std::to_string(fieldCount) + ")!"};
+            }
+
+            if (decltype(resultBindings)::kArgumentsCount > 0)
+            {
+                this->validateResultMetadata(resultBindings.bindings);
+                this->statement.bindResult(resultBindings.bindings.data());
+            }
+            boundResultBindings = resultBindings.bindings.data();
+            isResultChecked = true;
+            isResultBoundToRow = false;
+        }
+
+        /**
+         * Binds result to #resultBindings again after rows were fetched into structs.
+         */
+        void restoreResultBindings()
+        {
+            if (isResultBoundToRow)
+            {
+                this->statement.bindResult(resultBindings.bindings.data());
+                isResultBoundToRow = false;
+            }
+        }
+
+#if defined(MARIADB_PACKAGE_VERSION)
+        template<typename Container>
+        LowLevel::DBDriver::RowCount executeBulkInArrays(const Container& rows, std::size_t batchSize)
+        {
+            using Attributes = LowLevel::DBDriver::Statement::Attributes;
+
+            auto restoreParamsBindings = [&](){
+                this->statement.setAttribute(Attributes::arraySize, 0u);
+                this->statement.bindParam(paramsBindings.bindings.data());
+            };
+
+            detail::BulkParamsBindings<decltype(paramsBindings.data)> bulkBindings{};
+            LowLevel::DBDriver::RowCount affectedRows = 0;
+            try
+            {
+                auto it = std::begin(rows);
+                auto end = std::end(rows);
+                while (it != end)
+                {
+                    bulkBindings.clear();
+                    for (std::size_t i=0; i<batchSize && it!=end; ++i, ++it)
+                    {
+                        bulkBindings.addRow(*it);
+                    }
+
+                    this->statement.setAttribute(Attributes::arraySize, static_cast<unsigned int>(bulkBindings.getRowsCount()));
+                    this->statement.bindParam(bulkBindings.update());
+                    this->statement.execute();
+                    affectedRows += this->statement.affectedRows();
+                }
+            }
+            catch (...)
+            {
+                try
+                {
+                    restoreParamsBindings();
+                }
+                catch (...)
+                {
+                    // Original error is more important
+                }
+                throw;
+            }
+
+            restoreParamsBindings();
+            return affectedRows;
+        }
+#endif
+
         /**
          * @brief Constructor for PreparedStatement.
          * This overload is designated by SuperiorMySqlpp::fullInitTag and specifies both parameters and results as tuples.
@@ -234,6 +403,14 @@ namespace SuperiorMySqlpp
             {
                 this->statement.bindParam(paramsBindings.bindings.data());
             }
+            boundParamsBindings = paramsBindings.bindings.data();
+
+            if (cursorMode == CursorMode::ReadOnly)
+            {
+                using Attributes = LowLevel::DBDriver::Statement::Attributes;
+                this->statement.setAttribute(Attributes::cursorType, static_cast<unsigned long>(CURSOR_TYPE_READ_ONLY));
+                this->setPrefetchRowCount(detail::PreparedStatementsDefault::getCursorPrefetchRowCount());
+            }
         }
 
     public:
@@ -280,6 +457,8 @@ namespace SuperiorMySqlpp
               }
         {
             InitializeResult(resultBindings.data);
+            // Result storage may be reallocated by initialization
+            resultBindings.update();
         }
 
         /**
@@ -325,6 +504,8 @@ namespace SuperiorMySqlpp
               }
         {
             InitializeResult(resultBindings.data);
+            // Result storage may be reallocated by initialization
+            resultBindings.update();
         }
 
         PreparedStatement(const PreparedStatement&) = default;
@@ -339,18 +520,23 @@ namespace SuperiorMySqlpp
          * Call this function before execute if the values of parameters changed after construction.
          * It works in two phases - first it updates the binding structures to reflect on current
          * values (and calls some unique initialization for given type, if exist), then it updates
-         * the bindings in underlying C client. This step is crucial, as some versions apparently
-         * may keep own internal copy of binding structures.
-         * @remark In theory, shall only be required when some parameter size or memory address has changed since creation.
-         *         In practice, it is needed for non-POD types - {@link SuperiorMySqlpp::ArrayBase Array} based types change
-         *         their size and {@link SuperiorMySqlpp::Nullable Nullables} require binding initialization.
+         * the bindings in underlying C client, which keeps own internal copy of binding structures.
+         * The second phase is skipped unless some buffer address or type changed, because C client
+         * reads lengths and null flags through pointers on every execution.
+         * @remark Required only when some parameter memory address or size (without own length counter) changed.
+         *         It is not needed for numbers, temporal types, {@link SuperiorMySqlpp::ArrayBase Array} based types
+         *         (they keep their length in place) and non-null {@link SuperiorMySqlpp::Nullable Nullables} of them.
+         *         It is needed for std::string, C strings and Nullables becoming non-null.
          */
         void updateParamsBindings()
         {
             if (decltype(paramsBindings)::kArgumentsCount > 0)
             {
-                paramsBindings.update();
-                this->statement.bindParam(paramsBindings.bindings.data());
+                if (paramsBindings.update() || boundParamsBindings != paramsBindings.bindings.data())
+                {
+                    this->statement.bindParam(paramsBindings.bindings.data());
+                    boundParamsBindings = paramsBindings.bindings.data();
+                }
             }
         }
 
@@ -393,13 +579,24 @@ namespace SuperiorMySqlpp
         /**
          * Convenience function to replace values of query parameters.
          * @param args Forwarded new data to replace currenly stored values used for query parameters.
-         * @remark You usually want to call #updateParamsBindings afterwards, see that function for explanation.
+         * @remark You may need to call #updateParamsBindings afterwards, see that function for explanation.
          */
         template<typename... Args>
         void setParams(Args&&... args)
         {
             paramsBindings.data = std::forward_as_tuple(std::forward<Args>(args)...);
+        }
 
+        /**
+         * Replaces values of query parameters by members of struct declared by SUPERIOR_MYSQLPP_MEMBERS.
+         * @remark You may need to call #updateParamsBindings afterwards, see that function for explanation.
+         */
+        template<typename T>
+        void setParamsFrom(const T& row)
+        {
+            static_assert(std::is_same<detail::StructMembersTuple<T>, decltype(paramsBindings.data)>::value,
+                          "Struct members don't match param bindings, use StructParamBindings!");
+            paramsBindings.data = detail::tieMembers(row);
         }
 
         /**
@@ -418,36 +615,180 @@ namespace SuperiorMySqlpp
             return decltype(resultBindings)::kArgumentsCount;
         }
 
+        /**
+         * @brief Executes statement without result once for every set of parameters.
+         * With MariaDB client library and server, rows are sent using bulk protocol (STMT_ATTR_ARRAY_SIZE),
+         * i.e. one round trip per batch. Otherwise, statement is executed for each row separately.
+         * Values of params stored in the statement are unspecified afterwards.
+         * @param rows Container (e.g. std::vector or array) of tuples assignable to params
+         *             or of structs with members declared by SUPERIOR_MYSQLPP_MEMBERS.
+         * @param batchSize Maximal number of rows sent at once.
+         * @return Total number of affected rows.
+         * @throws LogicError If batchSize is 0.
+         */
+        template<typename Container>
+        LowLevel::DBDriver::RowCount executeBulk(const Container& rows, std::size_t batchSize=1000)
+        {
+            static_assert(decltype(resultBindings)::kArgumentsCount == 0, "Bulk execution is supported only for statements without result!");
+
+            if (batchSize == 0)
+            {
+                throw LogicError{"Bulk execution batch size must be positive!"};
+            }
+
+#if defined(MARIADB_PACKAGE_VERSION)
+            // Long data are sent per execution, so such statements are executed row by row
+            if (decltype(paramsBindings)::kArgumentsCount > 0 && !detail::HasLongDataParams<decltype(paramsBindings.data)>::value &&
+                this->statement.isBulkExecuteSupported())
+            {
+                return executeBulkInArrays(rows, batchSize);
+            }
+#endif
+            return executeBulkSequentially(rows);
+        }
+
         /**
          * @brief Executes prepared statement.
+         * Values of LongDataSource params are streamed to server in chunks first.
          * This method starts by executing the query (actually performing it), then it
-         * validates metadata for its result (if any). Finally, it calls #PreparedStatement's equivalent of
+         * validates metadata for its result (if any) and binds result -- only on first execution
+         * or when server signals metadata change. Finally, it calls #PreparedStatement's equivalent of
          * SuperiorMySqlpp::Query::use() or SuperiorMySqlpp::Query::store(), depending on #storeResult flag.
          */
         void execute()
         {
+            if (decltype(paramsBindings)::kArgumentsCount > 0 && boundParamsBindings != paramsBindings.bindings.data())
+            {
+                // Statement was moved, bound params point to previous storage
+                updateParamsBindings();
+            }
+
+            if (detail::HasLongDataParams<decltype(paramsBindings.data)>::value)
+            {
+                // Long data can't be sent while rows of previous result are pending
+                this->statement.freeResult();
+                detail::sendLongDataParams(this->statement, paramsBindings.data);
+            }
+
             this->statement.execute();
 
-            auto fieldCount = this->statement.fieldCount();
-            if (fieldCount != resultBindings.kArgumentsCount)
+            if (!isResultChecked || boundResultBindings != resultBindings.bindings.data() || this->statement.isResultMetadataChanged() ||
+                (decltype(resultBindings)::kArgumentsCount > 0 && !this->statement.isResultBound()))
             {
-                throw PreparedStatementTypeError{"Result types count (" + std::to_string(resultBindings.kArgumentsCount) +
-                        ") in query doesn't match number of returned fields (" + std::to_string(fieldCount) + ")!"};
+                bindResult();
             }
 
-            if (decltype(resultBindings)::kArgumentsCount > 0)
+            this->storeOrUse();
+        }
+
+        /**
+         * Perform fetch of next row of result set, returning status.
+         * Values longer than buffers of growable result storage (GrowableStringData, GrowableBlobData)
+         * are completed: buffer is grown and only the rest of the value is fetched.
+         * BlobStream result storage is attached to fetched row, its value is read later in chunks.
+         * Truncation of other values is not an error.
+         * @return enum #FetchStatus - contains results of mysql_stmt_fetch except
+         *                            error ones - those are thrown.
+         */
+        LowLevel::DBDriver::Statement::FetchStatus fetchWithStatus()
+        {
+            using FetchStatus = LowLevel::DBDriver::Statement::FetchStatus;
+
+            restoreResultBindings();
+            auto status = detail::PreparedStatementBase<storeResult, validateMode, warnMode, ignoreNullable>::fetchWithStatus();
+            if (status == FetchStatus::DataTruncated)
             {
-                if (!hasValidatedResultMetadata)
+                auto completed = detail::fetchTruncatedColumns(this->statement, resultBindings.bindings, resultBindings.data);
+                if (resultBindings.update())
                 {
-                    this->validateResultMetadata(resultBindings.bindings);
-                    this->hasValidatedResultMetadata = true;
+                    // Grown buffers are used for next rows
+                    this->statement.bindResult(resultBindings.bindings.data());
                 }
+                if (completed)
+                {
+                    status = FetchStatus::Ok;
+                }
+            }
+            return status;
+        }
 
-                // TODO: check if this might be cached when calling execute multiple times
-                this->statement.bindResult(resultBindings.bindings.data());
+        /**
+         * Perform fetch of next row of result set, returning status.
+         * Values of growable result storage are completed (see #fetchWithStatus), truncation of other values counts as unsuccessful.
+         * @return Whether the fetch was successful or not.
+         * @throws MysqlDataTruncatedError If value didn't fit into fixed size result storage.
+         */
+        bool fetch()
+        {
+            using FetchStatus = LowLevel::DBDriver::Statement::FetchStatus;
+
+            auto status = fetchWithStatus();
+            if (status == FetchStatus::DataTruncated)
+            {
+                this->statement.throwDataTruncatedError();
             }
+            return status == FetchStatus::Ok;
+        }
 
-            this->storeOrUse();
+        /**
+         * Fetches next row directly into members of struct declared by SUPERIOR_MYSQLPP_MEMBERS,
+         * i.e. result is bound to the struct, so values are not copied from result storage.
+         * Values of growable storage are completed as in #fetchWithStatus. Result storage (#getResult) is not changed.
+         * @return Whether the fetch was successful or not.
+         * @throws MysqlDataTruncatedError If value didn't fit into fixed size storage.
+         */
+        template<typename T>
+        bool fetchInto(T& row)
+        {
+            using FetchStatus = LowLevel::DBDriver::Statement::FetchStatus;
+            static_assert(std::is_same<detail::StructMembersTuple<T>, decltype(resultBindings.data)>::value,
+                          "Struct members don't match result bindings, use StructResultBindings!");
+
+            auto members = detail::tieMembers(row);
+            rowResultBindings.fill(MYSQL_BIND{});
+            detail::initializeBindings<false>(rowResultBindings, members);
+            this->statement.bindResult(rowResultBindings.data());
+            isResultBoundToRow = true;
+
+            auto status = detail::PreparedStatementBase<storeResult, validateMode, warnMode, ignoreNullable>::fetchWithStatus();
+            if (status == FetchStatus::DataTruncated)
+            {
+                if (!detail::fetchTruncatedColumns(this->statement, rowResultBindings, members))
+                {
+                    this->statement.throwDataTruncatedError();
+                }
+                status = FetchStatus::Ok;
+            }
+            return status == FetchStatus::Ok;
+        }
+
+        /**
+         * Fetches all remaining rows into structs appended to container (e.g. std::vector<T>), see #fetchInto.
+         * Each row is fetched directly into its element, so no row is copied.
+         * @return Number of fetched rows.
+         */
+        template<typename Container>
+        std::size_t fetchAllInto(Container& rows)
+        {
+            std::size_t count = 0;
+            while (true)
+            {
+                rows.emplace_back();
+                try
+                {
+                    if (!fetchInto(rows.back()))
+                    {
+                        rows.pop_back();
+                        return count;
+                    }
+                }
+                catch (...)
+                {
+                    rows.pop_back();
+                    throw;
+                }
+                ++count;
+            }
         }
     };
 }
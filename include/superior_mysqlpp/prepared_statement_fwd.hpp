@@ -5,6 +5,7 @@
 #pragma once
 
 #include <superior_mysqlpp/prepared_statements/validate_metadata_modes.hpp>
+#include <superior_mysqlpp/prepared_statements/cursor_modes.hpp>
 
 /*
  * This file contains only forward declarations for PreparedStatement related types,
@@ -51,6 +52,20 @@ namespace SuperiorMySqlpp
             {
                 return false;
             }
+
+            constexpr auto getCursorMode()
+            {
+                return CursorMode::Disabled;
+            }
+
+            /**
+             * Returns prefetch row count set for statements with cursor.
+             * Default of C API (1 row per fetch) would make a round trip for every row.
+             */
+            constexpr unsigned long getCursorPrefetchRowCount()
+            {
+                return 1024;
+            }
         }
     }
 
@@ -62,7 +77,8 @@ namespace SuperiorMySqlpp
              bool storeResult=detail::PreparedStatementsDefault::getStoreResult(),
              ValidateMetadataMode validateMode=detail::PreparedStatementsDefault::getValidateMode(),
              ValidateMetadataMode warnMode=detail::PreparedStatementsDefault::getWarnMode(),
-             bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable()>
+             bool ignoreNullable=detail::PreparedStatementsDefault::getIgnoreNullable(),
+             CursorMode cursorMode=detail::PreparedStatementsDefault::getCursorMode()>
     class PreparedStatement;
 }
 
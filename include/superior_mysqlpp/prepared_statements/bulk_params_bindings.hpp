@@ -0,0 +1,205 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <array>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/prepared_statements/initialize_bindings.hpp>
+#include <superior_mysqlpp/struct_mapping.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+
+
+// Bulk (array) execution is MariaDB extension of the protocol.
+#if defined(MARIADB_PACKAGE_VERSION)
+namespace SuperiorMySqlpp
+{
+    namespace detail
+    {
+        template<typename ParamsTuple>
+        class BulkParamsBindings;
+
+        /**
+         * Column-wise param bindings for MariaDB bulk execution (STMT_ATTR_ARRAY_SIZE).
+         * Numbers are gathered into contiguous arrays, other types (strings, decimals, blobs,
+         * temporal types) are passed as arrays of pointers into the rows and lengths.
+         * Nulls are passed as indicators.
+         *
+         * @remark Rows are referenced, not copied (unless they have to be converted),
+         *         so they must not change until the statement is executed.
+         */
+        template<typename... Types>
+        class BulkParamsBindings<std::tuple<Types...>>
+        {
+        private:
+            using ParamsTuple = std::tuple<Types...>;
+
+            struct Column
+            {
+                enum_field_types type = MYSQL_TYPE_NULL;
+                bool isUnsigned = false;
+                bool hasNulls = false;
+                std::vector<char> values{};
+                std::vector<const void*> pointers{};
+                std::vector<unsigned long> lengths{};
+                std::vector<char> indicators{};
+            };
+
+            std::array<Column, sizeof...(Types)> columns{};
+            std::array<MYSQL_BIND, sizeof...(Types)> bindings{{}};
+            /** Rows of other types converted to params tuple; deque keeps them in place. */
+            std::deque<ParamsTuple> convertedRows{};
+            std::size_t rowsCount = 0;
+
+            /**
+             * Returns size of values which are passed in contiguous array, 0 for values passed by pointer.
+             */
+            static std::size_t getValueSize(enum_field_types type) noexcept
+            {
+                // Not switch, enum_field_types differs between client libraries (-Wswitch-enum)
+                if (type == MYSQL_TYPE_TINY)
+                {
+                    return 1;
+                }
+                if (type == MYSQL_TYPE_SHORT || type == MYSQL_TYPE_YEAR)
+                {
+                    return 2;
+                }
+                if (type == MYSQL_TYPE_LONG || type == MYSQL_TYPE_INT24)
+                {
+                    return 4;
+                }
+                if (type == MYSQL_TYPE_LONGLONG)
+                {
+                    return 8;
+                }
+                if (type == MYSQL_TYPE_FLOAT)
+                {
+                    return sizeof(float);
+                }
+                if (type == MYSQL_TYPE_DOUBLE)
+                {
+                    return sizeof(double);
+                }
+                return 0;
+            }
+
+        public:
+            BulkParamsBindings() = default;
+
+            BulkParamsBindings(const BulkParamsBindings&) = delete;
+            BulkParamsBindings& operator=(const BulkParamsBindings&) = delete;
+
+            std::size_t getRowsCount() const noexcept
+            {
+                return rowsCount;
+            }
+
+            /**
+             * Removes all rows; allocated memory is kept for next batch.
+             */
+            void clear() noexcept
+            {
+                for (auto&& column: columns)
+                {
+                    column.type = MYSQL_TYPE_NULL;
+                    column.isUnsigned = false;
+                    column.hasNulls = false;
+                    column.values.clear();
+                    column.pointers.clear();
+                    column.lengths.clear();
+                    column.indicators.clear();
+                }
+                convertedRows.clear();
+                rowsCount = 0;
+            }
+
+            void addRow(const ParamsTuple& row)
+            {
+                // Binding initialization only takes addresses of the values
+                auto& data = const_cast<ParamsTuple&>(row);
+                std::array<MYSQL_BIND, sizeof...(Types)> rowBindings{{}};
+                initializeBindings<true>(rowBindings, data);
+
+                for (std::size_t i=0; i<sizeof...(Types); ++i)
+                {
+                    auto& binding = rowBindings[i];
+                    auto& column = columns[i];
+
+                    bool isNull = binding.is_null != nullptr && *binding.is_null;
+                    if (!isNull)
+                    {
+                        if (column.type == MYSQL_TYPE_NULL)
+                        {
+                            column.type = binding.buffer_type;
+                            column.isUnsigned = binding.is_unsigned;
+                        }
+                        else if (column.type != binding.buffer_type)
+                        {
+                            throw LogicError{"Bulk param " + std::to_string(i) + " has different types in rows!"};
+                        }
+                    }
+
+                    column.pointers.push_back(isNull? nullptr : binding.buffer);
+                    column.lengths.push_back(isNull? 0 : binding.buffer_length);
+                    column.indicators.push_back(isNull? STMT_INDICATOR_NULL : STMT_INDICATOR_NONE);
+                    column.hasNulls |= isNull;
+                }
+                ++rowsCount;
+            }
+
+            template<typename Row>
+            void addRow(const Row& row)
+            {
+                convertedRows.emplace_back(toParamsRow(row));
+                addRow(static_cast<const ParamsTuple&>(convertedRows.back()));
+            }
+
+            /**
+             * Fills bindings of added rows.
+             * @return Bindings array for DBDriver::Statement::bindParam.
+             */
+            MYSQL_BIND* update()
+            {
+                for (std::size_t i=0; i<sizeof...(Types); ++i)
+                {
+                    auto& column = columns[i];
+                    auto& binding = bindings[i];
+                    binding = MYSQL_BIND{};
+                    binding.buffer_type = column.type;
+                    binding.is_unsigned = column.isUnsigned;
+                    binding.u.indicator = column.hasNulls? column.indicators.data() : nullptr;
+
+                    auto valueSize = getValueSize(column.type);
+                    if (valueSize > 0)
+                    {
+                        column.values.assign(rowsCount * valueSize, 0);
+                        for (std::size_t row=0; row<rowsCount; ++row)
+                        {
+                            if (column.pointers[row] != nullptr)
+                            {
+                                std::memcpy(column.values.data() + row * valueSize, column.pointers[row], valueSize);
+                            }
+                        }
+                        binding.buffer = column.values.data();
+                    }
+                    else
+                    {
+                        binding.buffer = column.pointers.data();
+                        binding.length = column.lengths.data();
+                    }
+                }
+                return bindings.data();
+            }
+        };
+    }
+}
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+#include <stdexcept>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Enumeration of ways how server sends result rows of prepared statement.
+     */
+    enum class CursorMode
+    {
+        Disabled = 0, ///< Server sends all rows right after execution (store or use mode)
+        ReadOnly, ///< Server keeps rows in read-only cursor and sends them in chunks of prefetch row count on fetch
+    };
+
+    /**
+     * Function returning stringified CursorMode enum.
+     */
+    inline const char* getCursorModeName(CursorMode cursorMode)
+    {
+        switch (cursorMode)
+        {
+            case CursorMode::Disabled:
+                return "Disabled";
+
+            case CursorMode::ReadOnly:
+                return "ReadOnly";
+
+            default:
+                throw std::logic_error{"The Universe is falling apart!"};
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/prepared_statements/get_binding_type.hpp>
+#include <superior_mysqlpp/types/blob_stream.hpp>
+#include <superior_mysqlpp/types/growable_data.hpp>
+#include <superior_mysqlpp/types/nullable.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    namespace detail
+    {
+        /**
+         * Completes truncated value of result field after fetch.
+         * Generic variant, values of fixed size storage can't be completed.
+         * @return False if value is truncated.
+         */
+        template<typename T>
+        inline bool fetchTruncatedColumn(LowLevel::DBDriver::Statement& statement, unsigned int column, const MYSQL_BIND&, T&)
+        {
+            return !statement.isColumnTruncated(column);
+        }
+
+        /**
+         * Grows buffer of growable storage and fetches the rest of the value (already fetched part is kept).
+         * Fetched part is given by bound buffer length, buffer may have been grown (in place) after binding.
+         */
+        template<BindingTypes bindingType>
+        inline bool fetchTruncatedColumn(LowLevel::DBDriver::Statement& statement, unsigned int column, const MYSQL_BIND& bound,
+                                         GrowableDataBase<bindingType>& value)
+        {
+            auto fetchedSize = static_cast<std::size_t>(bound.buffer_length);
+            auto valueSize = static_cast<std::size_t>(value.counterRef());
+            if (valueSize <= fetchedSize)
+            {
+                return true;
+            }
+
+            value.detail_grow(valueSize);
+
+            unsigned long tailLength = 0;
+            MYSQL_BIND binding{};
+            binding.buffer = value.data() + fetchedSize;
+            binding.buffer_type = detail::toMysqlEnum(bindingType == BindingTypes::Blob? FieldTypes::Blob : FieldTypes::String);
+            binding.buffer_length = valueSize - fetchedSize;
+            binding.length = &tailLength;
+            statement.fetchColumn(&binding, column, fetchedSize);
+            return true;
+        }
+
+        /**
+         * Attaches blob stream to fetched row, value is read later in chunks.
+         */
+        inline bool fetchTruncatedColumn(LowLevel::DBDriver::Statement& statement, unsigned int column, const MYSQL_BIND&, BlobStream& stream)
+        {
+            stream.detail_attach(statement, column);
+            return true;
+        }
+
+        /**
+         * Variant for SuperiorMySqlpp::Nullable, payload is always constructed in result storage.
+         */
+        template<typename T>
+        inline bool fetchTruncatedColumn(LowLevel::DBDriver::Statement& statement, unsigned int column, const MYSQL_BIND& bound, Nullable<T>& nullable)
+        {
+            if (nullable.detail_getNullRef())
+            {
+                return true;
+            }
+            return fetchTruncatedColumn(statement, column, bound, nullable.detail_getPayloadRef());
+        }
+
+        template<typename... Types, std::size_t... I>
+        inline bool fetchTruncatedColumns(LowLevel::DBDriver::Statement& statement, const std::array<MYSQL_BIND, sizeof...(Types)>& bound,
+                                          std::tuple<Types...>& data, std::index_sequence<I...>)
+        {
+            // All columns must be completed, even when some of them can't be
+            bool results[] = {true, fetchTruncatedColumn(statement, static_cast<unsigned int>(I), std::get<I>(bound), std::get<I>(data))...};
+            for (auto result: results)
+            {
+                if (!result)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Completes values of fetched row that were truncated because they didn't fit into result storage.
+         * Only growable storage (GrowableStringData, GrowableBlobData) can be completed,
+         * BlobStream is attached to the row to be read later.
+         * @param bound Result bindings passed to C client for the fetch.
+         * @return False if some value remains truncated.
+         */
+        template<typename... Types>
+        inline bool fetchTruncatedColumns(LowLevel::DBDriver::Statement& statement, const std::array<MYSQL_BIND, sizeof...(Types)>& bound,
+                                          std::tuple<Types...>& data)
+        {
+            return fetchTruncatedColumns(statement, bound, data, std::index_sequence_for<Types...>{});
+        }
+    }
+}
@@ -4,11 +4,19 @@
 
 #pragma once
 
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
 #include <superior_mysqlpp/prepared_statements/get_binding_type.hpp>
 #include <superior_mysqlpp/prepared_statements/binding_types.hpp>
 #include <superior_mysqlpp/types/blob_data.hpp>
+#include <superior_mysqlpp/types/blob_stream.hpp>
 #include <superior_mysqlpp/types/string_data.hpp>
 #include <superior_mysqlpp/types/decimal_data.hpp>
+#include <superior_mysqlpp/types/growable_data.hpp>
+#include <superior_mysqlpp/types/long_data_source.hpp>
 #include <superior_mysqlpp/types/nullable.hpp>
 
 namespace SuperiorMySqlpp
@@ -52,6 +60,47 @@ namespace SuperiorMySqlpp
             binding.is_null = reinterpret_cast<my_bool*>(&nullable.detail_getNullRef());
         }
 
+        /**
+         * Initializes length of variable length param so that C client reads it through pointer
+         * on every execution; length of types with own counter (StringData, DecimalData, BlobData)
+         * is then updated in place, without rebinding.
+         */
+        template<typename T, typename std::enable_if<std::is_same<decltype(std::declval<T&>().counterRef()), unsigned long&>::value, int>::type=0>
+        inline void initializeParamLength(MYSQL_BIND& binding, T& value)
+        {
+            binding.length = &value.counterRef();
+        }
+
+        /**
+         * Length initialization for types without own counter, length is read from the binding itself.
+         */
+        template<typename T, typename... Ts>
+        inline void initializeParamLength(MYSQL_BIND& binding, T&, Ts...)
+        {
+            binding.length = &binding.buffer_length;
+        }
+
+        /**
+         * Returns true if bindings differ in what C client keeps after binding (buffer address, type
+         * and pointers to length and null indicator; for result bindings also buffer length,
+         * which limits fetched values), i.e. if they have to be bound again.
+         */
+        template<bool IsParamBinding, std::size_t N>
+        inline bool isRebindRequired(const std::array<MYSQL_BIND, N>& bound, const std::array<MYSQL_BIND, N>& current) noexcept
+        {
+            for (std::size_t i=0; i<N; ++i)
+            {
+                if (bound[i].buffer != current[i].buffer || bound[i].buffer_type != current[i].buffer_type ||
+                    bound[i].is_unsigned != current[i].is_unsigned ||
+                    bound[i].length != current[i].length || bound[i].is_null != current[i].is_null ||
+                    (!IsParamBinding && bound[i].buffer_length != current[i].buffer_length))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
         /**
          * Param binding initialization specialization for integers.
          */
@@ -93,6 +142,7 @@ namespace SuperiorMySqlpp
             binding.buffer = const_cast<void*>(reinterpret_cast<const void*>(string.data()));
             binding.buffer_type = detail::toMysqlEnum(FieldTypes::String);
             binding.buffer_length = string.length();
+            initializeParamLength(binding, string);
         }
 
         /**
@@ -104,6 +154,7 @@ namespace SuperiorMySqlpp
             binding.buffer = decimal.data();
             binding.buffer_type = detail::toMysqlEnum(FieldTypes::NewDecimal);
             binding.buffer_length = decimal.length();
+            initializeParamLength(binding, decimal);
         }
 
         /**
@@ -115,6 +166,7 @@ namespace SuperiorMySqlpp
             binding.buffer = blob.data();
             binding.buffer_type = detail::toMysqlEnum(FieldTypes::Blob);
             binding.buffer_length = blob.size();
+            initializeParamLength(binding, blob);
         }
 
         /**
@@ -165,6 +217,7 @@ namespace SuperiorMySqlpp
             binding.buffer = const_cast<void*>(reinterpret_cast<const void*>(string));
             binding.buffer_type = detail::toMysqlEnum(FieldTypes::String);
             binding.buffer_length = std::strlen(string);
+            binding.length = &binding.buffer_length;
         }
 
         /**
@@ -177,6 +230,7 @@ namespace SuperiorMySqlpp
             binding.buffer_type = detail::toMysqlEnum(FieldTypes::String);
             static_assert(N>0, "The Universe is falling apart :(");
             binding.buffer_length = N-1;
+            binding.length = &binding.buffer_length;
         }
 
         /**
@@ -291,7 +345,9 @@ namespace SuperiorMySqlpp
         inline void initializeResultBinding(MYSQL_BIND& binding, T& nullable)
         {
             initializeNullable(binding, nullable);
-            // Note that initialization of payload is here unconditional, unlike in initializeParamBinding version
+            // Note that initialization of payload is here unconditional, unlike in initializeParamBinding version,
+            // so payload must exist (storage like GrowableStringData owns its buffer)
+            nullable.detail_constructPayload();
             initializeResultBinding(binding, *nullable);
         }
 
@@ -186,6 +186,17 @@ namespace SuperiorMySqlpp
         private:
             Optional<ResultMetadata> resultMetadata;
 
+        protected:
+            /**
+             * Drops cached result metadata, so they are read again, e.g. after server signaled their change.
+             */
+            void invalidateResultMetadata() noexcept
+            {
+                resultMetadata = nullopt;
+            }
+
+        private:
+
             /**
              * This method is needed, because when SuperiorMySqlpp::Nullable type is created and
              * initialised using operator* in dynamic prepared statement,
@@ -291,11 +302,9 @@ namespace SuperiorMySqlpp
              * Sets how many rows shall be prefetched in single fetch call.
              * @param count Amount of rows to be prefetched in single fetch. Is of type
              *              unsigned long, matching the required type in C MySQL client.
-             *              Default value (if not set otherwise) is 1.
-             * @remark This function does seem to only have purpose in use() subclass (see #StoreOrUseResultBase),
-             *         consider moving it in the future.
-             *         Also, according to MySql 5.7 documentation, it requires using cursor to take effect.
-             *         However, at this time we are not exposing such functionality.
+             *              Default value (if not set otherwise) is 1,
+             *              PreparedStatement with cursor uses PreparedStatementsDefault::getCursorPrefetchRowCount().
+             * @remark It takes effect only when cursor is used (see PreparedStatement's CursorMode).
              */
             void setPrefetchRowCount(unsigned long count)
             {
@@ -312,6 +321,15 @@ namespace SuperiorMySqlpp
                 return result;
             }
 
+            /**
+             * Frees result of last execution; open cursor is closed, so remaining rows are not transferred.
+             * In use mode without cursor, remaining rows are read and discarded.
+             */
+            void freeResult() noexcept
+            {
+                this->statement.freeResult();
+            }
+
             /**
              * If related attribute is set to true, the metadata for result field's maximum length is updated on store().
              * Field's maximum length is the length in bytes of the longest field value for the rows actually in the result set.
@@ -0,0 +1,101 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/types/long_data_source.hpp>
+#include <superior_mysqlpp/types/nullable.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    namespace detail
+    {
+        /**
+         * Detects whether param storage is sent as long data.
+         */
+        template<typename T>
+        struct IsLongDataParam : std::false_type {};
+
+        template<>
+        struct IsLongDataParam<LongDataSource> : std::true_type {};
+
+        template<typename T>
+        struct IsLongDataParam<Nullable<T>> : IsLongDataParam<T> {};
+
+        template<typename ParamsTuple>
+        struct HasLongDataParams;
+
+        template<typename... Types>
+        struct HasLongDataParams<std::tuple<Types...>>
+            : std::integral_constant<bool, !std::is_same<std::integer_sequence<bool, false, IsLongDataParam<Types>::value...>,
+                                                         std::integer_sequence<bool, IsLongDataParam<Types>::value..., false>>::value> {};
+
+
+        /**
+         * Sends param as long data before execution.
+         * Generic variant, values of other storage are sent with execution.
+         */
+        template<typename T>
+        inline void sendLongDataParam(LowLevel::DBDriver::Statement&, unsigned int, T&)
+        {
+        }
+
+        inline void sendLongDataParam(LowLevel::DBDriver::Statement& statement, unsigned int paramNumber, LongDataSource& source)
+        {
+            source.detail_send(statement, paramNumber);
+        }
+
+        /**
+         * Variant for SuperiorMySqlpp::Nullable, nothing is sent for null value.
+         */
+        template<typename T>
+        inline void sendLongDataParam(LowLevel::DBDriver::Statement& statement, unsigned int paramNumber, Nullable<T>& nullable)
+        {
+            if (nullable)
+            {
+                sendLongDataParam(statement, paramNumber, *nullable);
+            }
+        }
+
+        template<typename... Types, std::size_t... I>
+        inline void sendLongDataParams(LowLevel::DBDriver::Statement& statement, std::tuple<Types...>& data, std::index_sequence<I...>)
+        {
+            // Initializer list guarantees left-to-right evaluation
+            int dummy[] = {0, (sendLongDataParam(statement, static_cast<unsigned int>(I), std::get<I>(data)), 0)...};
+            (void) dummy;
+        }
+
+        /**
+         * Sends values of long data params (LongDataSource) in chunks, params must be bound already.
+         * Long data sent so far are discarded on server when some source fails.
+         */
+        template<typename... Types>
+        inline void sendLongDataParams(LowLevel::DBDriver::Statement& statement, std::tuple<Types...>& data)
+        {
+            try
+            {
+                sendLongDataParams(statement, data, std::index_sequence_for<Types...>{});
+            }
+            catch (...)
+            {
+                try
+                {
+                    statement.reset();
+                }
+                catch (...)
+                {
+                    // Original error is more important
+                }
+                throw;
+            }
+        }
+    }
+}
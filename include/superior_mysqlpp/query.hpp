@@ -11,7 +11,12 @@
 
 #include <superior_mysqlpp/connection_def.hpp>
 #include <superior_mysqlpp/query_result.hpp>
+#include <superior_mysqlpp/parallel_for_each_row.hpp>
 #include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/converters/to_chars.hpp>
+#include <superior_mysqlpp/converters/to_temporal.hpp>
+#include <superior_mysqlpp/sql_template.hpp>
+#include <superior_mysqlpp/store_in.hpp>
 #include <superior_mysqlpp/types/string_view.hpp>
 #include <superior_mysqlpp/uncaught_exception_counter.hpp>
 
@@ -35,6 +40,182 @@ namespace SuperiorMySqlpp
             escapeNext = false;
         }
 
+        template<typename T>
+        void appendNumber(T value)
+        {
+            char buffer[Converters::toCharsBufferSize];
+            auto end = Converters::toChars(buffer, buffer + sizeof(buffer), value);
+            if (end != nullptr)
+            {
+                query.append(buffer, end);
+            }
+            else
+            {
+                query.append(std::to_string(value));
+            }
+        }
+
+        template<typename T>
+        void appendTemporal(const T& value)
+        {
+            char buffer[Converters::toCharsBufferSize];
+            query.append(buffer, Converters::toChars(buffer, buffer + sizeof(buffer), value));
+        }
+
+        void appendEscaped(const char* data, std::size_t length)
+        {
+            // Escape directly into query buffer; no allocation while capacity suffices
+            auto offset = query.size();
+            query.resize(offset + length*2 + 1);
+            auto escapedLength = driver.escapeStringInto(&query[offset], data, length);
+            query.resize(offset + escapedLength);
+        }
+
+        template<typename T>
+        void appendEscaped(const T& value, std::true_type /*isStringView*/)
+        {
+            StringView view{value};
+            appendEscaped(view.data(), view.size());
+        }
+
+        template<typename T>
+        void appendEscaped(const T& value, std::false_type /*isStringView*/)
+        {
+            query.append(driver.escapeString(value));
+        }
+
+        template<typename T>
+        void appendRaw(const T& value, std::true_type /*isStringView*/)
+        {
+            StringView view{value};
+            query.append(view.data(), view.size());
+        }
+
+        template<typename T>
+        void appendRaw(const T& value, std::false_type /*isStringView*/)
+        {
+            query.append(value);
+        }
+
+        template<typename T>
+        static std::size_t getSqlArgumentSizeHint(const T& value, std::true_type /*isStringView*/)
+        {
+            // Every character may be escaped, plus quotes
+            return StringView{value}.size()*2 + 2;
+        }
+
+        template<typename T>
+        static std::size_t getSqlArgumentSizeHint(const T&, std::false_type /*isStringView*/)
+        {
+            return Converters::toCharsBufferSize;
+        }
+
+        static std::size_t getSqlArgumentsSizeHint()
+        {
+            return 0;
+        }
+
+        template<typename Arg, typename... Args>
+        static std::size_t getSqlArgumentsSizeHint(const Arg& arg, const Args&... args)
+        {
+            return getSqlArgumentSizeHint(arg, std::is_convertible<const Arg&, StringView>{}) + getSqlArgumentsSizeHint(args...);
+        }
+
+        template<SqlPlaceholder placeholder, typename T>
+        void appendSqlArgument(const T& value)
+        {
+            static_assert(detail::GetSqlArgumentCategory<T>::value != detail::SqlArgumentCategory::unsupported,
+                          "Argument type is not supported by SQL template!");
+            static_assert(detail::isSqlArgumentAllowed(placeholder, detail::GetSqlArgumentCategory<T>::value),
+                          "Argument type does not match SQL template placeholder!");
+            appendSqlArgument<placeholder>(value, std::integral_constant<detail::SqlArgumentCategory, detail::GetSqlArgumentCategory<T>::value>{});
+        }
+
+        template<SqlPlaceholder placeholder>
+        void appendSqlArgument(std::nullptr_t, std::integral_constant<detail::SqlArgumentCategory, detail::SqlArgumentCategory::null>)
+        {
+            query.append("NULL", 4);
+        }
+
+        template<SqlPlaceholder placeholder, typename T>
+        void appendSqlArgument(const Nullable<T>& value, std::integral_constant<detail::SqlArgumentCategory, detail::SqlArgumentCategory::nullable>)
+        {
+            if (value.isValid())
+            {
+                appendSqlArgument<placeholder>(*value);
+            }
+            else
+            {
+                query.append("NULL", 4);
+            }
+        }
+
+        template<SqlPlaceholder placeholder, typename T>
+        void appendSqlArgument(T value, std::integral_constant<detail::SqlArgumentCategory, detail::SqlArgumentCategory::integral>)
+        {
+            appendNumber(value);
+        }
+
+        template<SqlPlaceholder placeholder, typename T>
+        void appendSqlArgument(T value, std::integral_constant<detail::SqlArgumentCategory, detail::SqlArgumentCategory::floatingPoint>)
+        {
+            appendNumber(value);
+        }
+
+        template<SqlPlaceholder placeholder, typename T>
+        void appendSqlArgument(const T& value, std::integral_constant<detail::SqlArgumentCategory, detail::SqlArgumentCategory::temporal>)
+        {
+            query.push_back('\'');
+            appendTemporal(value);
+            query.push_back('\'');
+        }
+
+        template<SqlPlaceholder placeholder, typename T>
+        void appendSqlArgument(const T& value, std::integral_constant<detail::SqlArgumentCategory, detail::SqlArgumentCategory::string>)
+        {
+            StringView view{value};
+            if (placeholder == SqlPlaceholder::identifier)
+            {
+                query.push_back('`');
+                for (auto character: view)
+                {
+                    if (character == '`')
+                    {
+                        query.push_back('`');
+                    }
+                    query.push_back(character);
+                }
+                query.push_back('`');
+            }
+            else
+            {
+                query.push_back('\'');
+                appendEscaped(view.data(), view.size());
+                query.push_back('\'');
+            }
+        }
+
+        template<typename Template, std::size_t index>
+        void appendSqlSegment()
+        {
+            constexpr auto segment = Template::getSegment(index);
+            query.append(segment.data(), segment.size());
+        }
+
+        template<typename Template, std::size_t index>
+        void appendSqlArguments()
+        {
+            appendSqlSegment<Template, index>();
+        }
+
+        template<typename Template, std::size_t index, typename Arg, typename... Args>
+        void appendSqlArguments(const Arg& arg, const Args&... args)
+        {
+            appendSqlSegment<Template, index>();
+            appendSqlArgument<Template::format.placeholders[index]>(arg);
+            appendSqlArguments<Template, index + 1>(args...);
+        }
+
     public:
         Query(LowLevel::DBDriver& driver)
             : driver{driver}, query{}
@@ -46,6 +227,15 @@ namespace SuperiorMySqlpp
         {
         }
 
+        /**
+         * Takes over the buffer of initialQuery including its capacity.
+         * Allows to reuse one buffer for building many queries (see #releaseBuffer).
+         */
+        Query(LowLevel::DBDriver& driver, std::string&& initialQuery)
+            : driver{driver}, query{std::move(initialQuery)}
+        {
+        }
+
         Query(Connection& connection)
             : driver{connection.detail_getDriver()}, query{}
         {
@@ -56,6 +246,25 @@ namespace SuperiorMySqlpp
         {
         }
 
+        Query(Connection& connection, std::string&& initialQuery)
+            : driver{connection.detail_getDriver()}, query{std::move(initialQuery)}
+        {
+        }
+
+        template<typename Literal, typename... Args>
+        Query(LowLevel::DBDriver& driver, SqlTemplate<Literal> sqlTemplate, const Args&... args)
+            : driver{driver}, query{}
+        {
+            format(sqlTemplate, args...);
+        }
+
+        template<typename Literal, typename... Args>
+        Query(Connection& connection, SqlTemplate<Literal> sqlTemplate, const Args&... args)
+            : driver{connection.detail_getDriver()}, query{}
+        {
+            format(sqlTemplate, args...);
+        }
+
         Query(Query&& other)
             : driver{std::move(other).driver},
               query{std::move(other).query},
@@ -135,6 +344,68 @@ namespace SuperiorMySqlpp
             return query;
         }
 
+        /**
+         * Preallocates query buffer.
+         */
+        void reserve(std::size_t capacity)
+        {
+            query.reserve(capacity);
+        }
+
+        /**
+         * Empties the query so the same object (and its buffer capacity) can be used for next statement.
+         *
+         * @throws LogicError When result sets of executed query were not read.
+         */
+        void clear()
+        {
+            if (executed && hasMoreResults())
+            {
+                throw LogicError{"Some result sets had not been read!"};
+            }
+
+            query.clear();
+            executed = false;
+            resetNextState();
+        }
+
+        /**
+         * Moves query buffer out of this object. Together with constructor taking std::string&&
+         * it allows to build queries without allocation in steady state.
+         *
+         * Example:
+         *   std::string buffer{};
+         *   for (...)
+         *   {
+         *       buffer.clear();
+         *       auto query = connection.makeQuery(std::move(buffer));
+         *       ...
+         *       buffer = query.releaseBuffer();
+         *   }
+         */
+        std::string releaseBuffer()
+        {
+            std::string buffer{std::move(query)};
+            query = std::string{};
+            return buffer;
+        }
+
+        /**
+         * Appends query template (see SUPERIOR_MYSQLPP_SQL) rendered with given arguments.
+         * Number and types of arguments are checked at compile time.
+         */
+        template<typename Literal, typename... Args>
+        Query& format(SqlTemplate<Literal>, const Args&... args)
+        {
+            using Template = SqlTemplate<Literal>;
+            static_assert(sizeof...(Args) == Template::placeholdersCount,
+                          "Number of arguments does not match number of placeholders in SQL template!");
+
+            query.reserve(query.size() + Template::format.textLength + getSqlArgumentsSizeHint(args...));
+            appendSqlArguments<Template, 0>(args...);
+            return *this;
+        }
+
         void execute()
         {
             driver.execute(query);
@@ -171,11 +442,6 @@ namespace SuperiorMySqlpp
             }
         }
 
-        // TODO: add support for template queries (like printf)
-        // (do type check {parse format string} in compile time)
-//        template<typename... Args>
-//        void execute(Args... args) = delete;
-
         auto store()
         {
             if (!executed)
@@ -218,20 +484,79 @@ namespace SuperiorMySqlpp
             }
         }
 
-        /*
-         * TODO: Implement functions below.
-         * (Find column type, call to<type>(), validate metadata.
-         * Allow user specializations using "to<>" or operator T()".)
+        /**
+         * Like #forEachRow, but rows are fetched by chunks of chunkSize rows
+         * and function is called concurrently by pool threads, in no particular order.
+         * @see SuperiorMySqlpp::parallelForEachRow
          */
+        template<typename F>
+        void parallelForEachRow(WorkerPool& pool, F function, std::size_t chunkSize)
+        {
+            UseQueryResult result{use()};
+            SuperiorMySqlpp::parallelForEachRow(pool, result, std::move(function), chunkSize);
+        }
 
-//        template<typename Container, typename F>
-//        void storeIf(Container& container, F&& function) = delete;
+        /**
+         * Ordered variant; values returned by function are passed to consumer in row order.
+         * @see SuperiorMySqlpp::parallelForEachRow
+         */
+        template<typename F, typename Consumer>
+        void parallelForEachRow(WorkerPool& pool, F function, std::size_t chunkSize, Consumer consumer)
+        {
+            UseQueryResult result{use()};
+            SuperiorMySqlpp::parallelForEachRow(pool, result, std::move(function), chunkSize, std::move(consumer));
+        }
 
-//        template<typename Sequence>
-//        void storeInSequence(Sequence& container) = delete;
+        /**
+         * Stores all rows of the result into container (appends them).
+         * Columns are converted by Converters::to<T> chosen by the container's value type:
+         *  - std::tuple / std::pair: columns are taken by position,
+         *  - other types without mappings: result must have exactly one column,
+         *  - any default constructible type with mappings (see mapColumn): columns are found by name.
+         * NULL is allowed only in Nullable elements / members.
+         *
+         * Column order is resolved once and capacity is reserved when container supports it.
+         *
+         * @throws LogicError When result columns do not match the value type.
+         */
+        template<typename Container, typename... Ts, typename... Members>
+        void storeIn(Container& container, const ColumnMapping<Ts, Members>&... mappings)
+        {
+            auto result = store();
+            detail::storeRowsIn(result, container, [](auto&&){ return true; }, mappings...);
+        }
 
-        // TODO: storeIn specialize for vector, set, ...
+        /**
+         * @overload
+         */
+        template<typename Container, typename... Ts, typename... Members>
+        Container storeIn(const ColumnMapping<Ts, Members>&... mappings)
+        {
+            Container container{};
+            storeIn(container, mappings...);
+            return container;
+        }
 
+        /**
+         * Same as #storeIn, but container must be a sequence (rows keep the result order).
+         */
+        template<typename Sequence, typename... Ts, typename... Members>
+        void storeInSequence(Sequence& sequence, const ColumnMapping<Ts, Members>&... mappings)
+        {
+            static_assert(decltype(detail::isSequence<Sequence>(0))::value, "Container must be a sequence supporting emplace_back!");
+            storeIn(sequence, mappings...);
+        }
+
+        /**
+         * Same as #storeIn, but stores only rows for which function returns true.
+         * @param function Predicate taking converted value.
+         */
+        template<typename Container, typename F, typename... Ts, typename... Members>
+        void storeIf(Container& container, F&& function, const ColumnMapping<Ts, Members>&... mappings)
+        {
+            auto result = store();
+            detail::storeRowsIn(result, container, std::forward<F>(function), mappings...);
+        }
 
         operator std::string() const
         {
@@ -243,14 +568,37 @@ namespace SuperiorMySqlpp
         {
             if (quoteNext)
             {
-                query.append("'");
+                query.push_back('\'');
+            }
+
+            appendNumber(value);
+
+            if (quoteNext)
+            {
+                query.push_back('\'');
+            }
+
+            resetNextState();
+
+            return *this;
+        }
+
+        /**
+         * Writes Date, Time or Datetime in MySQL format; use quoteOnly to get a literal.
+         */
+        template<typename T>
+        std::enable_if_t<Converters::detail::IsTemporal<T>::value, Query>& operator<<(const T& value)
+        {
+            if (quoteNext)
+            {
+                query.push_back('\'');
             }
 
-            query.append(std::to_string(value));
+            appendTemporal(value);
 
             if (quoteNext)
             {
-                query.append("'");
+                query.push_back('\'');
             }
 
             resetNextState();
@@ -259,25 +607,25 @@ namespace SuperiorMySqlpp
         }
 
         template<typename T>
-        std::enable_if_t<!std::is_arithmetic<T>::value, Query>& operator<<(const T& value)
+        std::enable_if_t<!std::is_arithmetic<T>::value && !Converters::detail::IsTemporal<T>::value, Query>& operator<<(const T& value)
         {
             if (quoteNext)
             {
-                query.append("'");
+                query.push_back('\'');
             }
 
             if (escapeNext)
             {
-                query.append(driver.escapeString(value));
+                appendEscaped(value, std::is_convertible<const T&, StringView>{});
             }
             else
             {
-                query.append(value);
+                appendRaw(value, std::is_convertible<const T&, StringView>{});
             }
 
             if (quoteNext)
             {
-                query.append("'");
+                query.push_back('\'');
             }
 
             resetNextState();
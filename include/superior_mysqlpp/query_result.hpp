@@ -5,12 +5,13 @@
 #pragma once
 
 
+#include <vector>
 #include <utility>
-#include <cstring>
-#include <algorithm>
 
 #include <superior_mysqlpp/low_level/dbdriver.hpp>
 #include <superior_mysqlpp/row.hpp>
+#include <superior_mysqlpp/row_batch.hpp>
+#include <superior_mysqlpp/column_name_index.hpp>
 #include <superior_mysqlpp/metadata.hpp>
 #include <superior_mysqlpp/types/string_view.hpp>
 #include <superior_mysqlpp/types/optional.hpp>
@@ -25,7 +26,7 @@ namespace SuperiorMySqlpp
         protected:
             unsigned int fieldsCount;
             ResultMetadata resultMetadata;
-            Optional<std::vector<std::tuple<StringView, std::size_t>>> optionalColumnNameMappings;
+            Optional<ColumnNameIndex> optionalColumnNameIndex;
 
         protected:
             LowLevel::DBDriver::Result& getResult() && = delete;
@@ -41,25 +42,20 @@ namespace SuperiorMySqlpp
                 return resultMetadata.detail_getResult();
             }
 
-            auto& getColumnNameMappingsRef()
+            const ColumnNameIndex& getColumnNameIndexRef()
             {
-                if (!optionalColumnNameMappings)
+                if (!optionalColumnNameIndex)
                 {
-                    optionalColumnNameMappings.emplace();
-                    optionalColumnNameMappings->reserve(resultMetadata.size());
-
-                    std::size_t i = 0;
+                    std::vector<StringView> columnNames{};
+                    columnNames.reserve(resultMetadata.size());
                     for (auto&& item: resultMetadata)
                     {
-                        optionalColumnNameMappings->emplace_back(std::make_tuple(item.getColumnNameView(), i++));
+                        columnNames.emplace_back(item.getColumnNameView());
                     }
-
-                    using std::begin;
-                    using std::end;
-                    std::sort(begin(*optionalColumnNameMappings), end(*optionalColumnNameMappings));
+                    optionalColumnNameIndex.emplace(std::move(columnNames));
                 }
 
-                return *optionalColumnNameMappings;
+                return *optionalColumnNameIndex;
             }
 
         public:
@@ -96,22 +92,13 @@ namespace SuperiorMySqlpp
              */
             std::size_t getColumnIndex(StringView columnName)
             {
-                auto& columnNameMappings = getColumnNameMappingsRef();
-
-                using std::begin;
-                using std::end;
-                auto it = std::lower_bound(begin(columnNameMappings), end(columnNameMappings), columnName, [](auto&& elem, auto&& value){
-                    return std::get<0>(elem) < value;
-                });
-
-                if (it != end(columnNameMappings) && !(columnName < std::get<0>(*it)))
-                {
-                    return std::get<1>(*it);
-                }
-                else
+                auto& columnNameIndex = getColumnNameIndexRef();
+                auto index = columnNameIndex.find(columnName);
+                if (index == columnNameIndex.size())
                 {
                     throw OutOfRange{"Column name \"" + std::string(columnName) + "\" not found!"};
                 }
+                return index;
             }
 
             /*
@@ -124,6 +111,21 @@ namespace SuperiorMySqlpp
                 return getColumnIndex({columnName, L-1});
             }
 
+            /**
+             * Resolves column name once; use the handle instead of name in row loops.
+             * @throws OutOfRange When there is no column with given name.
+             */
+            ColumnHandle getColumnHandle(StringView columnName)
+            {
+                return ColumnHandle{getColumnIndex(columnName)};
+            }
+
+            template<std::size_t L>
+            ColumnHandle getColumnHandle(const char (& columnName)[L])
+            {
+                return ColumnHandle{getColumnIndex(columnName)};
+            }
+
 
 
             /*
@@ -166,6 +168,25 @@ namespace SuperiorMySqlpp
             auto mysqlRow = getResult().checkedFetchRow();
             return {getResult(), mysqlRow, fieldsCount};
         }
+
+        /**
+         * Copies at most maxRows following rows into batch, reusing its buffers.
+         * @return Number of fetched rows; less than maxRows means end of result.
+         */
+        std::size_t fetchBatch(RowBatch& batch, std::size_t maxRows) &
+        {
+            return batch.detail_fetch(getResult(), fieldsCount, maxRows);
+        }
+
+        /**
+         * @see fetchBatch(RowBatch&, std::size_t)
+         */
+        RowBatch fetchBatch(std::size_t maxRows) &
+        {
+            RowBatch batch{};
+            fetchBatch(batch, maxRows);
+            return batch;
+        }
     };
 
 
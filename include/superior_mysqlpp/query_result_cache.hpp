@@ -0,0 +1,641 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <chrono>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <superior_mysqlpp/connection.hpp>
+#include <superior_mysqlpp/converters/to_chars.hpp>
+#include <superior_mysqlpp/converters/to_temporal.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/owned_row_set.hpp>
+#include <superior_mysqlpp/prepared_statement.hpp>
+#include <superior_mysqlpp/types/array.hpp>
+#include <superior_mysqlpp/types/nullable.hpp>
+#include <superior_mysqlpp/types/string_view.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    namespace detail
+    {
+        /**
+         * Size of value accounted by QueryResultCache; overload it for types owning dynamic memory.
+         */
+        template<typename T>
+        std::size_t getCachedSize(const T&) noexcept
+        {
+            return sizeof(T);
+        }
+
+        inline std::size_t getCachedSize(const OwnedRowSet& rows) noexcept
+        {
+            auto size = sizeof(rows) + rows.getArenaSize();
+            for (auto&& name: rows.getColumnNames())
+            {
+                size += sizeof(name) + name.size();
+            }
+            return size;
+        }
+
+        /**
+         * Rows of prepared statements have fixed size (strings are stored in arrays).
+         */
+        template<typename T>
+        std::size_t getCachedSize(const std::vector<T>& rows) noexcept
+        {
+            return sizeof(rows) + rows.capacity() * sizeof(T);
+        }
+    }
+
+
+    /**
+     * Thread safe in-process cache of query results.
+     *
+     * Values are immutable and shared (std::shared_ptr<const T>), so returned results stay valid
+     * after eviction. Cache provides:
+     *  - time to live of every entry,
+     *  - least recently used eviction bounded by total size of values in bytes,
+     *  - invalidation of single key or of all entries with given tag,
+     *  - single flight loading: concurrent misses of the same key wait for one loader.
+     *
+     * Values loaded while any invalidation happened are returned but not cached,
+     * so invalidation is never lost. Misses after invalidation do not wait for loadings started before it.
+     *
+     * @see cachedQuery, cachedPsQuery
+     */
+    class QueryResultCache
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Duration = Clock::duration;
+
+        struct Statistics
+        {
+            std::size_t hits = 0;
+            std::size_t misses = 0;
+            /** Misses which waited for loading started by another caller. */
+            std::size_t coalescedMisses = 0;
+            std::size_t expirations = 0;
+            std::size_t evictions = 0;
+            std::size_t invalidations = 0;
+            std::size_t entriesCount = 0;
+            std::size_t bytes = 0;
+        };
+
+    private:
+        using Value = std::shared_ptr<const void>;
+
+        struct Entry
+        {
+            Value value;
+            std::type_index type;
+            std::size_t size;
+            Clock::time_point expiration;
+            std::vector<std::string> tags;
+            std::list<std::string>::iterator lruPosition;
+        };
+
+        struct Loading
+        {
+            std::shared_future<Value> future;
+            std::type_index type;
+            /** Invalidation epoch when loading started. */
+            std::size_t epoch;
+        };
+
+        const std::size_t maxBytes;
+        const Duration defaultTtl;
+
+        mutable std::mutex mutex{};
+        std::unordered_map<std::string, Entry> entries{};
+        /** Keys from the most recently used. */
+        std::list<std::string> lru{};
+        std::unordered_map<std::string, std::unordered_set<std::string>> taggedKeys{};
+        std::unordered_map<std::string, Loading> loadings{};
+        std::size_t bytes = 0;
+        std::size_t invalidationEpoch = 0;
+        Statistics statistics{};
+
+    private:
+        /**
+         * Loading of key can be replaced by newer one after invalidation, so only own one is erased.
+         */
+        void eraseLoading(const std::string& key, std::size_t epoch)
+        {
+            auto loading = loadings.find(key);
+            if (loading != loadings.end() && loading->second.epoch == epoch)
+            {
+                loadings.erase(loading);
+            }
+        }
+
+        static void checkType(const std::type_index& stored, const std::type_index& requested)
+        {
+            if (stored != requested)
+            {
+                throw LogicError{"Cached value has different type than requested!"};
+            }
+        }
+
+        void erase(std::unordered_map<std::string, Entry>::iterator it)
+        {
+            for (auto&& tag: it->second.tags)
+            {
+                auto tagged = taggedKeys.find(tag);
+                if (tagged != taggedKeys.end())
+                {
+                    tagged->second.erase(it->first);
+                    if (tagged->second.empty())
+                    {
+                        taggedKeys.erase(tagged);
+                    }
+                }
+            }
+            lru.erase(it->second.lruPosition);
+            bytes -= it->second.size;
+            entries.erase(it);
+        }
+
+        void insert(const std::string& key, Value value, std::type_index type, std::size_t size,
+                    Clock::time_point expiration, const std::vector<std::string>& tags)
+        {
+            if (size > maxBytes)
+            {
+                return;
+            }
+
+            auto existing = entries.find(key);
+            if (existing != entries.end())
+            {
+                erase(existing);
+            }
+            while (bytes + size > maxBytes && !lru.empty())
+            {
+                erase(entries.find(lru.back()));
+                ++statistics.evictions;
+            }
+
+            lru.push_front(key);
+            entries.emplace(key, Entry{std::move(value), type, size, expiration, tags, lru.begin()});
+            for (auto&& tag: tags)
+            {
+                taggedKeys[tag].insert(key);
+            }
+            bytes += size;
+        }
+
+    public:
+        /**
+         * @param maxBytes Limit of total size of cached values.
+         * @param defaultTtl Time to live of entries loaded without explicit one.
+         */
+        QueryResultCache(std::size_t maxBytes, Duration defaultTtl)
+            : maxBytes{maxBytes}, defaultTtl{defaultTtl}
+        {
+        }
+
+        QueryResultCache(const QueryResultCache&) = delete;
+        QueryResultCache(QueryResultCache&&) = delete;
+        QueryResultCache& operator=(const QueryResultCache&) = delete;
+        QueryResultCache& operator=(QueryResultCache&&) = delete;
+
+        Duration getDefaultTtl() const noexcept
+        {
+            return defaultTtl;
+        }
+
+        /**
+         * Returns cached value or loads it by loader (T(), called without lock held).
+         *
+         * @param tags Tags for #invalidateTag.
+         * @param ttl Time to live; non-positive value means default.
+         * @throws LogicError When key is cached (or being loaded) with different type.
+         * @remark Exception thrown by loader is rethrown to all callers waiting for it; nothing is cached.
+         */
+        template<typename T, typename Loader>
+        std::shared_ptr<const T> getOrLoad(const std::string& key, const std::vector<std::string>& tags, Duration ttl, Loader&& loader)
+        {
+            const std::type_index type{typeid(T)};
+            std::promise<Value> promise{};
+            std::size_t epoch = 0;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                auto it = entries.find(key);
+                if (it != entries.end())
+                {
+                    if (Clock::now() < it->second.expiration)
+                    {
+                        checkType(it->second.type, type);
+                        ++statistics.hits;
+                        lru.splice(lru.begin(), lru, it->second.lruPosition);
+                        return std::static_pointer_cast<const T>(it->second.value);
+                    }
+                    erase(it);
+                    ++statistics.expirations;
+                }
+
+                ++statistics.misses;
+                epoch = invalidationEpoch;
+                auto loading = loadings.find(key);
+                if (loading != loadings.end())
+                {
+                    checkType(loading->second.type, type);
+                    // Loading started before invalidation may return stale value
+                    if (loading->second.epoch == epoch)
+                    {
+                        ++statistics.coalescedMisses;
+                        auto future = loading->second.future;
+                        lock.unlock();
+                        return std::static_pointer_cast<const T>(future.get());
+                    }
+                    loading->second = Loading{promise.get_future().share(), type, epoch};
+                }
+                else
+                {
+                    loadings.emplace(key, Loading{promise.get_future().share(), type, epoch});
+                }
+            }
+
+            std::shared_ptr<const T> value{};
+            try
+            {
+                value = std::make_shared<const T>(loader());
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    eraseLoading(key, epoch);
+                }
+                promise.set_exception(std::current_exception());
+                throw;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                eraseLoading(key, epoch);
+                if (epoch == invalidationEpoch)
+                {
+                    using detail::getCachedSize;
+                    insert(key, value, type, getCachedSize(*value), Clock::now() + (ttl > Duration::zero()? ttl : defaultTtl), tags);
+                }
+            }
+            promise.set_value(value);
+            return value;
+        }
+
+        /**
+         * @return True if key was cached.
+         */
+        bool invalidate(const std::string& key)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            ++invalidationEpoch;
+            auto it = entries.find(key);
+            if (it == entries.end())
+            {
+                return false;
+            }
+            erase(it);
+            ++statistics.invalidations;
+            return true;
+        }
+
+        /**
+         * @return Number of invalidated entries.
+         */
+        std::size_t invalidateTag(const std::string& tag)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            ++invalidationEpoch;
+            auto tagged = taggedKeys.find(tag);
+            if (tagged == taggedKeys.end())
+            {
+                return 0;
+            }
+
+            // Erasing entries modifies the set
+            std::vector<std::string> keys{tagged->second.begin(), tagged->second.end()};
+            for (auto&& key: keys)
+            {
+                erase(entries.find(key));
+            }
+            statistics.invalidations += keys.size();
+            return keys.size();
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            ++invalidationEpoch;
+            statistics.invalidations += entries.size();
+            entries.clear();
+            lru.clear();
+            taggedKeys.clear();
+            bytes = 0;
+        }
+
+        Statistics getStatistics() const
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            auto result = statistics;
+            result.entriesCount = entries.size();
+            result.bytes = bytes;
+            return result;
+        }
+    };
+
+
+    /**
+     * Normalizes query text for use in cache key: runs of whitespace outside of quoted
+     * strings, identifiers and comments are replaced by single space, leading and trailing whitespace is removed.
+     * Comments are kept as they are; newline ending line comment ("-- ", "#") is kept instead of space.
+     */
+    inline std::string normalizeQueryText(StringView query)
+    {
+        auto isSpace = [](char c){
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+        };
+
+        std::string result{};
+        result.reserve(query.size());
+        // Opening quote, or '-' for line comment and '*' for block comment
+        char quote = '\0';
+        char pendingSeparator = '\0';
+        for (std::size_t i=0; i<query.size(); ++i)
+        {
+            auto c = query[i];
+            if (quote == '\0')
+            {
+                if (isSpace(c))
+                {
+                    if (pendingSeparator != '\n' && !result.empty())
+                    {
+                        pendingSeparator = ' ';
+                    }
+                    continue;
+                }
+                if (pendingSeparator != '\0')
+                {
+                    result.push_back(pendingSeparator);
+                    pendingSeparator = '\0';
+                }
+                if (c == '\'' || c == '"' || c == '`')
+                {
+                    quote = c;
+                }
+                else if (c == '#')
+                {
+                    quote = '-';
+                }
+                else if (c == '-' && i + 1 < query.size() && query[i + 1] == '-'
+                         && (i + 2 == query.size() || static_cast<unsigned char>(query[i + 2]) <= ' '))
+                {
+                    // "--" starts comment only when followed by whitespace or control character
+                    quote = '-';
+                }
+                else if (c == '/' && i + 1 < query.size() && query[i + 1] == '*')
+                {
+                    quote = '*';
+                    result.push_back(c);
+                    c = query[++i];
+                }
+                result.push_back(c);
+            }
+            else if (quote == '-')
+            {
+                if (c == '\n')
+                {
+                    quote = '\0';
+                    pendingSeparator = '\n';
+                }
+                else
+                {
+                    result.push_back(c);
+                }
+            }
+            else if (quote == '*')
+            {
+                result.push_back(c);
+                if (c == '*' && i + 1 < query.size() && query[i + 1] == '/')
+                {
+                    result.push_back(query[++i]);
+                    quote = '\0';
+                }
+            }
+            else
+            {
+                result.push_back(c);
+                if (c == '\\' && quote != '`' && i + 1 < query.size())
+                {
+                    result.push_back(query[++i]);
+                }
+                else if (c == quote)
+                {
+                    quote = '\0';
+                }
+            }
+        }
+        return result;
+    }
+
+
+    namespace detail
+    {
+        /*
+         * Parameters are appended as "<length>:<text>" so that keys are unambiguous.
+         */
+        inline void appendCacheKeyPart(std::string& key, StringView text)
+        {
+            key += std::to_string(text.size());
+            key += ':';
+            key.append(text.data(), text.size());
+        }
+
+        template<typename T>
+        inline std::enable_if_t<std::is_arithmetic<T>::value> appendCacheKey(std::string& key, const T& value)
+        {
+            char buffer[Converters::toCharsBufferSize];
+            auto end = Converters::toChars(buffer, buffer + sizeof(buffer), value);
+            appendCacheKeyPart(key, {buffer, static_cast<std::size_t>(end - buffer)});
+        }
+
+        template<typename T>
+        inline std::enable_if_t<Converters::detail::IsTemporal<T>::value> appendCacheKey(std::string& key, const T& value)
+        {
+            char buffer[64];
+            auto end = Converters::toChars(buffer, buffer + sizeof(buffer), value);
+            appendCacheKeyPart(key, {buffer, static_cast<std::size_t>(end - buffer)});
+        }
+
+        inline void appendCacheKey(std::string& key, const std::string& value)
+        {
+            appendCacheKeyPart(key, value);
+        }
+
+        inline void appendCacheKey(std::string& key, StringView value)
+        {
+            appendCacheKeyPart(key, value);
+        }
+
+        inline void appendCacheKey(std::string& key, const char* value)
+        {
+            appendCacheKeyPart(key, value);
+        }
+
+        template<std::size_t N, bool TerminatingZero>
+        inline void appendCacheKey(std::string& key, const ArrayBase<N, TerminatingZero>& value)
+        {
+            appendCacheKeyPart(key, {value.data(), value.size()});
+        }
+
+        template<typename T>
+        inline void appendCacheKey(std::string& key, const Nullable<T>& value)
+        {
+            if (value.isValid())
+            {
+                key += 'v';
+                appendCacheKey(key, value.value());
+            }
+            else
+            {
+                key += 'n';
+            }
+        }
+
+        /**
+         * Identity of connection (user, server and default database), so that connections
+         * to different servers or databases can share one cache.
+         */
+        inline void appendConnectionCacheKey(std::string& key, Connection& connection)
+        {
+            auto& driver = connection.detail_getDriver();
+            appendCacheKeyPart(key, driver.getUser());
+            appendCacheKeyPart(key, driver.getHostInfo());
+            key += std::to_string(driver.getPort());
+            key += ':';
+            appendCacheKeyPart(key, driver.getDatabase());
+        }
+
+        template<typename RBindings>
+        using CachedRows = std::vector<std::decay_t<decltype(std::declval<RBindings&>().data)>>;
+    }
+
+
+    /**
+     * Options of cached queries.
+     */
+    struct QueryCacheOptions
+    {
+        /** Tags for QueryResultCache::invalidateTag. */
+        std::vector<std::string> tags{};
+        /** Time to live; zero means default of cache. */
+        QueryResultCache::Duration ttl = QueryResultCache::Duration::zero();
+    };
+
+
+    /**
+     * @return Key of cached query; normalized query text.
+     */
+    inline std::string makeQueryCacheKey(StringView query)
+    {
+        return "q:" + normalizeQueryText(query);
+    }
+
+    /**
+     * @return Key of cached prepared statement; result type, normalized query text and parameters.
+     */
+    template<typename RBindings, typename... Params>
+    std::string makePsQueryCacheKey(StringView query, const Params&... params)
+    {
+        std::string key{"ps:"};
+        key += typeid(detail::CachedRows<RBindings>).name();
+        key += ':';
+        detail::appendCacheKeyPart(key, normalizeQueryText(query));
+        using Expander = int[];
+        (void)Expander{0, (detail::appendCacheKey(key, params), 0)...};
+        return key;
+    }
+
+    /**
+     * @return Key of text query cached for connection; connection identity (user, server, database)
+     *         and normalized query text.
+     */
+    inline std::string makeQueryCacheKey(Connection& connection, StringView query)
+    {
+        std::string key{"c:"};
+        detail::appendConnectionCacheKey(key, connection);
+        key += makeQueryCacheKey(query);
+        return key;
+    }
+
+    /**
+     * @return Key of prepared statement cached for connection; connection identity (user, server, database),
+     *         result type, normalized query text and parameters.
+     */
+    template<typename RBindings, typename... Params>
+    std::string makePsQueryCacheKey(Connection& connection, StringView query, const Params&... params)
+    {
+        std::string key{"c:"};
+        detail::appendConnectionCacheKey(key, connection);
+        key += makePsQueryCacheKey<RBindings>(query, params...);
+        return key;
+    }
+
+    /**
+     * Returns rows of text query from cache or executes it on connection and caches its stored result.
+     * Results are cached per connection identity (see makeQueryCacheKey(Connection&, StringView)).
+     */
+    inline std::shared_ptr<const OwnedRowSet> cachedQuery(QueryResultCache& cache, Connection& connection, const std::string& query,
+                                                          const QueryCacheOptions& options={})
+    {
+        return cache.getOrLoad<OwnedRowSet>(makeQueryCacheKey(connection, query), options.tags, options.ttl, [&](){
+            auto statement = connection.makeQuery(query);
+            statement.execute();
+            return OwnedRowSet{statement.store()};
+        });
+    }
+
+    /**
+     * Returns rows of prepared statement from cache or executes it with given parameters and caches
+     * copies of its results (std::vector of tuples with RBindings types).
+     * Results are cached per connection identity (see makeQueryCacheKey(Connection&, StringView)).
+     *
+     * @tparam RBindings Specialization of ResultBindings.
+     */
+    template<typename RBindings, typename... Params>
+    std::shared_ptr<const detail::CachedRows<RBindings>> cachedPsQuery(QueryResultCache& cache, Connection& connection, const std::string& query,
+                                                                       const QueryCacheOptions& options, const Params&... params)
+    {
+        using Rows = detail::CachedRows<RBindings>;
+        return cache.getOrLoad<Rows>(makePsQueryCacheKey<RBindings>(connection, query, params...), options.tags, options.ttl, [&](){
+            auto preparedStatement = connection.makePreparedStatement<RBindings>(query, params...);
+            preparedStatement.execute();
+            Rows rows{};
+            rows.reserve(static_cast<std::size_t>(preparedStatement.getRowsCount()));
+            while (preparedStatement.fetch())
+            {
+                rows.push_back(preparedStatement.getResult());
+            }
+            rows.shrink_to_fit();
+            return rows;
+        });
+    }
+}
@@ -10,6 +10,7 @@
 
 #include <superior_mysqlpp/low_level/dbdriver.hpp>
 #include <superior_mysqlpp/field.hpp>
+#include <superior_mysqlpp/column_name_index.hpp>
 #include <superior_mysqlpp/iterator.hpp>
 
 
@@ -30,6 +31,16 @@ namespace SuperiorMySqlpp
         {
         }
 
+        /**
+         * Row over fields held elsewhere (e.g. RowBatch).
+         */
+        Row(MYSQL_ROW mysqlRow, unsigned long* fieldsLengthsPtr, unsigned int fieldsCount) noexcept
+            : mysqlRow{mysqlRow},
+              fieldsLengthsPtr{fieldsLengthsPtr},
+              fieldsCount{fieldsCount}
+        {
+        }
+
         Row(Row&&) = default;
 
         Row(const Row&) = delete;
@@ -92,6 +103,11 @@ namespace SuperiorMySqlpp
         {
             return {mysqlRow[index], fieldsLengthsPtr[index]};
         }
+
+        Field operator[](ColumnHandle column) const
+        {
+            return (*this)[static_cast<unsigned int>(column.getIndex())];
+        }
     };
 
 
@@ -0,0 +1,119 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+#include <mysql/mysql.h>
+
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/row.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Copy of consecutive rows of result.
+     *
+     * Rows of use result are valid only until next fetch, so batch copies data of all fields
+     * into one buffer. Buffers are reused when the batch is filled again.
+     */
+    class RowBatch
+    {
+    private:
+        static constexpr std::size_t nullOffset = std::numeric_limits<std::size_t>::max();
+
+        unsigned int fieldsCount = 0;
+        std::size_t rowsCount = 0;
+        std::vector<char> bytes{};
+        std::vector<std::size_t> offsets{};
+        std::vector<char*> fields{};
+        std::vector<LowLevel::DBDriver::FieldSize> lengths{};
+
+    public:
+        RowBatch() = default;
+
+        RowBatch(RowBatch&&) = default;
+        RowBatch& operator=(RowBatch&&) = default;
+
+        RowBatch(const RowBatch&) = delete;
+        RowBatch& operator=(const RowBatch&) = delete;
+
+        std::size_t size() const noexcept
+        {
+            return rowsCount;
+        }
+
+        bool empty() const noexcept
+        {
+            return rowsCount == 0;
+        }
+
+        /**
+         * @return Row referencing data of this batch; valid until the batch is refilled or destroyed.
+         */
+        Row operator[](std::size_t index) const
+        {
+            auto first = index * fieldsCount;
+            // Row does not modify fields, it just shares MYSQL_ROW type with C API
+            return {const_cast<MYSQL_ROW>(fields.data() + first), const_cast<LowLevel::DBDriver::FieldSize*>(lengths.data() + first), fieldsCount};
+        }
+
+        void clear() noexcept
+        {
+            rowsCount = 0;
+            bytes.clear();
+            offsets.clear();
+            fields.clear();
+            lengths.clear();
+        }
+
+        /*
+         * DO NOT USE this function unless you want to work with C API directly!
+         * Replaces content of batch by at most maxRows rows fetched from result.
+         */
+        std::size_t detail_fetch(LowLevel::DBDriver::Result& result, unsigned int fieldsCount, std::size_t maxRows)
+        {
+            clear();
+            this->fieldsCount = fieldsCount;
+
+            while (rowsCount < maxRows)
+            {
+                auto row = result.checkedFetchRow();
+                if (row == nullptr)
+                {
+                    break;
+                }
+                auto rowLengths = result.fetchLengths();
+                for (unsigned int i=0; i<fieldsCount; ++i)
+                {
+                    if (row[i] == nullptr)
+                    {
+                        offsets.push_back(std::size_t{nullOffset});
+                    }
+                    else
+                    {
+                        offsets.push_back(bytes.size());
+                        bytes.insert(bytes.end(), row[i], row[i] + rowLengths[i]);
+                        // Keep fields null terminated as C API does
+                        bytes.push_back('\0');
+                    }
+                    lengths.push_back(rowLengths[i]);
+                }
+                ++rowsCount;
+            }
+
+            // Buffer is complete, it will not be reallocated anymore
+            fields.reserve(offsets.size());
+            for (auto offset: offsets)
+            {
+                fields.push_back(offset == nullOffset? nullptr : bytes.data() + offset);
+            }
+            return rowsCount;
+        }
+    };
+}
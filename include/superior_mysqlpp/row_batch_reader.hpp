@@ -0,0 +1,176 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <cstddef>
+
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/query_result.hpp>
+#include <superior_mysqlpp/row_batch.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Reads use result by batches; next batch is fetched on helper thread
+     * while the current one is processed, so the connection keeps receiving data.
+     *
+     * Single helper thread lives as long as this object; it initializes MySQL library
+     * for itself (mysql_thread_init) and releases it (mysql_thread_end) when it ends.
+     *
+     * Result (and its connection) must not be used otherwise until this object is destroyed
+     * or #fetchBatch returns false.
+     */
+    class RowBatchReader
+    {
+    private:
+        UseQueryResult& result;
+        std::size_t batchSize;
+        RowBatch pending{};
+        bool finished = false;
+
+        // Shared with helper thread, guarded by mutex
+        std::mutex mutex{};
+        std::condition_variable condition{};
+        bool fetchRequested = true;
+        bool fetchDone = false;
+        bool stopRequested = false;
+        std::size_t fetched = 0;
+        std::exception_ptr error{};
+
+        std::thread helper{};
+
+        void run() noexcept
+        {
+            try
+            {
+                LowLevel::DBDriver::threadInit();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                error = std::current_exception();
+                fetchDone = true;
+                condition.notify_all();
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock{mutex};
+            while (true)
+            {
+                condition.wait(lock, [this](){ return fetchRequested || stopRequested; });
+                if (stopRequested)
+                {
+                    break;
+                }
+                fetchRequested = false;
+
+                lock.unlock();
+                std::size_t count = 0;
+                std::exception_ptr fetchError{};
+                try
+                {
+                    count = result.fetchBatch(pending, batchSize);
+                }
+                catch (...)
+                {
+                    fetchError = std::current_exception();
+                }
+                lock.lock();
+
+                fetched = count;
+                error = fetchError;
+                fetchDone = true;
+                condition.notify_all();
+            }
+            lock.unlock();
+
+            LowLevel::DBDriver::threadEnd();
+        }
+
+    public:
+        /**
+         * Starts helper thread which fetches the first batch immediately.
+         *
+         * @throws LogicError When batchSize is 0.
+         */
+        RowBatchReader(UseQueryResult& result, std::size_t batchSize)
+            : result{result}, batchSize{batchSize}
+        {
+            if (batchSize == 0)
+            {
+                throw LogicError{"Batch size must be positive!"};
+            }
+            helper = std::thread{[this](){ run(); }};
+        }
+
+        RowBatchReader(const RowBatchReader&) = delete;
+        RowBatchReader(RowBatchReader&&) = delete;
+        RowBatchReader& operator=(const RowBatchReader&) = delete;
+        RowBatchReader& operator=(RowBatchReader&&) = delete;
+
+        /**
+         * Waits for running fetch and joins helper thread.
+         */
+        ~RowBatchReader()
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                stopRequested = true;
+            }
+            condition.notify_all();
+            helper.join();
+        }
+
+        /**
+         * Replaces content of batch by next fetched rows and starts fetching the following ones.
+         * Buffers of batch are reused for the following fetch.
+         *
+         * @return False (and empty batch) when there are no more rows.
+         * @throws RuntimeError When fetching fails.
+         * @throws MysqlInternalError When helper thread could not be initialized.
+         */
+        bool fetchBatch(RowBatch& batch)
+        {
+            if (finished)
+            {
+                batch.clear();
+                return false;
+            }
+
+            std::unique_lock<std::mutex> lock{mutex};
+            condition.wait(lock, [this](){ return fetchDone; });
+            fetchDone = false;
+            if (error)
+            {
+                finished = true;
+                std::rethrow_exception(std::exchange(error, nullptr));
+            }
+
+            using std::swap;
+            swap(batch, pending);
+            auto fetchedRows = fetched;
+            if (fetchedRows < batchSize)
+            {
+                // Short batch means that result is exhausted
+                finished = true;
+            }
+            else
+            {
+                fetchRequested = true;
+                lock.unlock();
+                condition.notify_all();
+            }
+            return fetchedRows != 0;
+        }
+    };
+}
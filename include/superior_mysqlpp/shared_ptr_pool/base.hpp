@@ -12,9 +12,11 @@
 #include <atomic>
 #include <future>
 #include <memory>
+#include <functional>
 #include <algorithm>
 #include <cassert>
 
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
 #include <superior_mysqlpp/traits.hpp>
 #include <superior_mysqlpp/logging.hpp>
 #include <superior_mysqlpp/types/tags.hpp>
@@ -157,6 +159,7 @@ public:
     using PoolItemWeak_t = detail::CheckedResouce<std::weak_ptr<std::decay_t<decltype(*std::declval<Resource_t>().get())>>>;
     using Pool_t = std::vector<PoolItem_t>;
     using PoolMutex_t = std::mutex;
+    using ResourceInitializer_t = std::function<void(Resource_t&)>;
 
     static constexpr bool invalidateResourceOnAccess_ = invalidateResourceOnAccess;
 
@@ -171,6 +174,8 @@ protected:
 
 protected:
     SharedPtrFactory factory;
+    /** Accessed atomically, jobs create resources concurrently with setting it. */
+    std::shared_ptr<const ResourceInitializer_t> resourceInitializer{};
 
 protected:
     Loggers::SharedPointer_t loggerSharedPtr;
@@ -212,6 +217,7 @@ public:
           pool{std::move(other).pool},
           poolMutex{},
           factory{std::move(other).factory},
+          resourceInitializer{std::atomic_load(&other.resourceInitializer)},
           loggerSharedPtr{std::move(other).loggerSharedPtr}
     {}
 
@@ -239,6 +245,30 @@ protected:
         return loggerSharedPtr.get();
     }
 
+    /**
+     * Creates resource for the pool; resource initializer (if any) runs asynchronously
+     * after the factory (on thread initialized for MySQL library), so the resource is initialized
+     * before it becomes available.
+     * Exception thrown by initializer is propagated through the future (resource is dropped).
+     */
+    std::future<Resource_t> createResource() const
+    {
+        auto initializer = std::atomic_load(&resourceInitializer);
+        std::future<Resource_t> futureResource = factory();
+        if (!initializer)
+        {
+            return futureResource;
+        }
+
+        return std::async(std::launch::async, [initializer, futureResource=std::move(futureResource)]() mutable {
+            auto resource = futureResource.get();
+            // Initializer uses connection (MySQL C API) on this thread
+            LowLevel::DBDriver::ThreadGuard threadGuard{};
+            (*initializer)(resource);
+            return resource;
+        });
+    }
+
 
 public:
     auto getId() const
@@ -307,6 +337,20 @@ public:
         loggerSharedPtr = std::forward<T>(value);
     }
 
+    /**
+     * Sets hook called on every new pooled resource before it becomes available
+     * (e.g. to prepare statements on new connection); empty function removes it.
+     */
+    void setResourceInitializer(ResourceInitializer_t initializer)
+    {
+        std::shared_ptr<const ResourceInitializer_t> value{};
+        if (initializer)
+        {
+            value = std::make_shared<const ResourceInitializer_t>(std::move(initializer));
+        }
+        std::atomic_store(&resourceInitializer, std::move(value));
+    }
+
 
     Resource_t get() const
     {
@@ -340,7 +384,7 @@ public:
             lock.unlock();
 
             getLogger()->logSharedPtrPoolEmergencyResourceCreation(id);
-            auto futureResource = factory();
+            auto futureResource = createResource();
             auto newResource = std::move(futureResource).get();
 
             lock.lock();
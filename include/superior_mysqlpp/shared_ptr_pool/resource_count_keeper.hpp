@@ -101,7 +101,7 @@ private:
                     futures.reserve(needed);
                     for (std::size_t i=0; i<needed; ++i)
                     {
-                        auto&& future = getBase().factory();
+                        auto&& future = getBase().createResource();
                         futures.emplace_back(std::move(future));
                     }
 
@@ -0,0 +1,294 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <type_traits>
+
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/converters/to_temporal.hpp>
+#include <superior_mysqlpp/types/nullable.hpp>
+#include <superior_mysqlpp/types/string_view.hpp>
+
+
+/*
+ * Query templates with placeholders checked at compile time.
+ *
+ * Format string is parsed by constexpr functions; literal text between placeholders
+ * is precomputed so rendering consists of copying the segments and formatting the arguments.
+ *
+ * Placeholders:
+ *   {}    any value; strings are escaped and quoted, numbers are written as they are,
+ *         Date, Time and Datetime are quoted
+ *   {d}   integral number
+ *   {f}   arithmetic number
+ *   {s}   string or temporal value; escaped and quoted
+ *   {id}  identifier; enclosed in backticks (backticks inside are doubled)
+ *   {{ }} literal braces
+ *
+ * Empty Nullable and nullptr are rendered as NULL (not allowed for identifiers).
+ */
+
+namespace SuperiorMySqlpp
+{
+    enum class SqlPlaceholder
+    {
+        value,
+        integer,
+        floatingPoint,
+        string,
+        identifier,
+    };
+
+    namespace detail
+    {
+        /**
+         * Parsed format string.
+         *
+         * @tparam textCapacity Length of the format string (upper bound of the literal text length).
+         * @tparam placeholdersCount Number of placeholders.
+         */
+        template<std::size_t textCapacity, std::size_t placeholdersCount>
+        struct SqlFormat
+        {
+            /** Literal text with placeholders removed and braces unescaped. */
+            char text[textCapacity + 1];
+            /** Length of the literal text. */
+            std::size_t textLength;
+            /** Segment i (text preceding placeholder i) ends at segmentEnds[i] in #text. */
+            std::size_t segmentEnds[placeholdersCount + 1];
+            SqlPlaceholder placeholders[placeholdersCount + 1];
+        };
+
+        constexpr bool isSqlPlaceholderSpec(const char* spec, std::size_t length, const char* expected)
+        {
+            for (std::size_t i=0; i<length; ++i)
+            {
+                if (expected[i] == '\0' || expected[i] != spec[i])
+                {
+                    return false;
+                }
+            }
+            return expected[length] == '\0';
+        }
+
+        constexpr SqlPlaceholder parseSqlPlaceholderSpec(const char* spec, std::size_t length)
+        {
+            return isSqlPlaceholderSpec(spec, length, "")? SqlPlaceholder::value :
+                   isSqlPlaceholderSpec(spec, length, "d")? SqlPlaceholder::integer :
+                   isSqlPlaceholderSpec(spec, length, "f")? SqlPlaceholder::floatingPoint :
+                   isSqlPlaceholderSpec(spec, length, "s")? SqlPlaceholder::string :
+                   isSqlPlaceholderSpec(spec, length, "id")? SqlPlaceholder::identifier :
+                   throw LogicError{"Unknown placeholder in SQL template!"};
+        }
+
+        /**
+         * Walks through format string calling onText(char) for every literal character
+         * and onPlaceholder(SqlPlaceholder) for every placeholder.
+         * Throwing during constant evaluation makes malformed format a compile error.
+         */
+        template<typename Visitor>
+        constexpr void visitSqlFormat(const char* format, std::size_t length, Visitor& visitor)
+        {
+            std::size_t i = 0;
+            while (i < length)
+            {
+                if (format[i] == '{')
+                {
+                    if (i + 1 < length && format[i + 1] == '{')
+                    {
+                        visitor.onText('{');
+                        i += 2;
+                        continue;
+                    }
+
+                    auto specBegin = i + 1;
+                    auto specEnd = specBegin;
+                    while (specEnd < length && format[specEnd] != '}' && format[specEnd] != '{')
+                    {
+                        ++specEnd;
+                    }
+                    if (specEnd == length || format[specEnd] != '}')
+                    {
+                        throw LogicError{"Unterminated placeholder in SQL template!"};
+                    }
+                    visitor.onPlaceholder(parseSqlPlaceholderSpec(format + specBegin, specEnd - specBegin));
+                    i = specEnd + 1;
+                }
+                else if (format[i] == '}')
+                {
+                    if (i + 1 < length && format[i + 1] == '}')
+                    {
+                        visitor.onText('}');
+                        i += 2;
+                        continue;
+                    }
+                    throw LogicError{"Unmatched '}' in SQL template!"};
+                }
+                else
+                {
+                    visitor.onText(format[i]);
+                    ++i;
+                }
+            }
+        }
+
+        struct SqlPlaceholderCounter
+        {
+            std::size_t count = 0;
+
+            constexpr void onText(char)
+            {
+            }
+
+            constexpr void onPlaceholder(SqlPlaceholder)
+            {
+                ++count;
+            }
+        };
+
+        template<std::size_t textCapacity, std::size_t placeholdersCount>
+        struct SqlFormatBuilder
+        {
+            SqlFormat<textCapacity, placeholdersCount> format{};
+            std::size_t placeholderIndex = 0;
+
+            constexpr void onText(char character)
+            {
+                format.text[format.textLength++] = character;
+            }
+
+            constexpr void onPlaceholder(SqlPlaceholder placeholder)
+            {
+                format.segmentEnds[placeholderIndex] = format.textLength;
+                format.placeholders[placeholderIndex] = placeholder;
+                ++placeholderIndex;
+            }
+        };
+
+        constexpr std::size_t countSqlPlaceholders(const char* format, std::size_t length)
+        {
+            SqlPlaceholderCounter counter{};
+            visitSqlFormat(format, length, counter);
+            return counter.count;
+        }
+
+        template<std::size_t textCapacity, std::size_t placeholdersCount>
+        constexpr SqlFormat<textCapacity, placeholdersCount> parseSqlFormat(const char* format)
+        {
+            SqlFormatBuilder<textCapacity, placeholdersCount> builder{};
+            visitSqlFormat(format, textCapacity, builder);
+            builder.format.segmentEnds[placeholdersCount] = builder.format.textLength;
+            return builder.format;
+        }
+
+
+        enum class SqlArgumentCategory
+        {
+            unsupported,
+            null,
+            nullable,
+            integral,
+            floatingPoint,
+            string,
+            temporal,
+        };
+
+        template<typename T>
+        struct GetSqlArgumentCategory
+        {
+            static constexpr SqlArgumentCategory value =
+                std::is_integral<T>::value? SqlArgumentCategory::integral :
+                std::is_floating_point<T>::value? SqlArgumentCategory::floatingPoint :
+                std::is_convertible<const T&, StringView>::value? SqlArgumentCategory::string :
+                Converters::detail::IsTemporal<T>::value? SqlArgumentCategory::temporal :
+                SqlArgumentCategory::unsupported;
+        };
+
+        template<>
+        struct GetSqlArgumentCategory<std::nullptr_t>
+        {
+            static constexpr SqlArgumentCategory value = SqlArgumentCategory::null;
+        };
+
+        template<typename T>
+        struct GetSqlArgumentCategory<Nullable<T>>
+        {
+            static constexpr SqlArgumentCategory value = SqlArgumentCategory::nullable;
+        };
+
+        constexpr bool isSqlArgumentAllowed(SqlPlaceholder placeholder, SqlArgumentCategory category)
+        {
+            switch (placeholder)
+            {
+                case SqlPlaceholder::value:
+                    return category != SqlArgumentCategory::unsupported;
+                case SqlPlaceholder::integer:
+                    return category == SqlArgumentCategory::integral
+                           || category == SqlArgumentCategory::null
+                           || category == SqlArgumentCategory::nullable;
+                case SqlPlaceholder::floatingPoint:
+                    return category == SqlArgumentCategory::integral
+                           || category == SqlArgumentCategory::floatingPoint
+                           || category == SqlArgumentCategory::null
+                           || category == SqlArgumentCategory::nullable;
+                case SqlPlaceholder::string:
+                    return category == SqlArgumentCategory::string
+                           || category == SqlArgumentCategory::temporal
+                           || category == SqlArgumentCategory::null
+                           || category == SqlArgumentCategory::nullable;
+                case SqlPlaceholder::identifier:
+                    return category == SqlArgumentCategory::string;
+            }
+            return false;
+        }
+    }
+
+
+    /**
+     * Query template created by SUPERIOR_MYSQLPP_SQL macro.
+     * Format is parsed once at compile time; the object itself is empty.
+     *
+     * @tparam Literal Class with static constexpr get() returning the format string and size() returning its length.
+     */
+    template<typename Literal>
+    struct SqlTemplate
+    {
+        static constexpr std::size_t placeholdersCount = detail::countSqlPlaceholders(Literal::get(), Literal::size());
+        static constexpr detail::SqlFormat<Literal::size(), placeholdersCount> format =
+            detail::parseSqlFormat<Literal::size(), placeholdersCount>(Literal::get());
+
+        static constexpr StringView getSegment(std::size_t index)
+        {
+            return index == 0? StringView{format.text, format.segmentEnds[0]}
+                             : StringView{format.text + format.segmentEnds[index - 1], format.segmentEnds[index] - format.segmentEnds[index - 1]};
+        }
+    };
+
+    template<typename Literal>
+    constexpr std::size_t SqlTemplate<Literal>::placeholdersCount;
+
+    template<typename Literal>
+    constexpr detail::SqlFormat<Literal::size(), SqlTemplate<Literal>::placeholdersCount> SqlTemplate<Literal>::format;
+}
+
+
+/**
+ * Creates SqlTemplate from string literal, e.g.
+ *   connection.makeQuery(SUPERIOR_MYSQLPP_SQL("SELECT name FROM users WHERE id={d}"), id)
+ *
+ * Malformed format, wrong number of arguments and argument types not matching
+ * placeholders are reported at compile time.
+ */
+#define SUPERIOR_MYSQLPP_SQL(literal) \
+    ([]{ \
+        struct SqlLiteral \
+        { \
+            static constexpr const char* get() { return literal; } \
+            static constexpr std::size_t size() { return sizeof(literal) - 1; } \
+        }; \
+        return ::SuperiorMySqlpp::SqlTemplate<SqlLiteral>{}; \
+    }())
@@ -0,0 +1,374 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <mysql/mysqld_error.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    class StatementCache;
+
+    namespace detail
+    {
+        class CachedStatementBase
+        {
+        public:
+            const std::type_index type;
+            const std::string query;
+
+            CachedStatementBase(std::type_index type, const std::string& query)
+                : type{type}, query{query}
+            {
+            }
+
+            virtual ~CachedStatementBase() = default;
+
+            /**
+             * Prepares statement for next checkout (remaining rows are discarded).
+             */
+            virtual void reset() noexcept = 0;
+        };
+
+        /**
+         * Statement is constructed in place and never moved, because bindings point into it.
+         */
+        template<typename PreparedStatementType>
+        class CachedStatement : public CachedStatementBase
+        {
+        public:
+            PreparedStatementType statement;
+
+            CachedStatement(LowLevel::DBDriver& driver, const std::string& query)
+                : CachedStatementBase{typeid(PreparedStatementType), query},
+                  statement{driver, query}
+            {
+            }
+
+            void reset() noexcept override
+            {
+                statement.detail_getStatementRef().freeResult();
+            }
+        };
+    }
+
+
+    /**
+     * Handle of prepared statement checked out from StatementCache.
+     * Behaves like pointer to the statement; the statement is returned to the cache on destruction.
+     *
+     * @remark Handle must not outlive the Connection it was checked out from (same as PreparedStatement).
+     */
+    template<typename PreparedStatementType>
+    class CachedPreparedStatement
+    {
+    private:
+        StatementCache* cache;
+        std::unique_ptr<detail::CachedStatement<PreparedStatementType>> entry;
+        std::uint_fast64_t generation;
+
+        void checkin() noexcept;
+
+    public:
+        CachedPreparedStatement(StatementCache& cache,
+                                std::unique_ptr<detail::CachedStatement<PreparedStatementType>> entry,
+                                std::uint_fast64_t generation) noexcept
+            : cache{&cache}, entry{std::move(entry)}, generation{generation}
+        {
+        }
+
+        CachedPreparedStatement(const CachedPreparedStatement&) = delete;
+        CachedPreparedStatement& operator=(const CachedPreparedStatement&) = delete;
+
+        CachedPreparedStatement(CachedPreparedStatement&&) = default;
+
+        CachedPreparedStatement& operator=(CachedPreparedStatement&& other) noexcept
+        {
+            if (this != &other)
+            {
+                checkin();
+                cache = other.cache;
+                entry = std::move(other.entry);
+                generation = other.generation;
+            }
+            return *this;
+        }
+
+        ~CachedPreparedStatement()
+        {
+            checkin();
+        }
+
+        PreparedStatementType& operator*() const noexcept
+        {
+            return entry->statement;
+        }
+
+        PreparedStatementType* operator->() const noexcept
+        {
+            return &entry->statement;
+        }
+
+        PreparedStatementType& get() const noexcept
+        {
+            return entry->statement;
+        }
+    };
+
+
+    /**
+     * Per-connection LRU cache of prepared statements keyed by query text and statement type
+     * (i.e. result and param bindings and statement options).
+     *
+     * Checked out statement keeps its server-side statement (no prepare round trip) and its bindings.
+     * Number of idle statements is bounded by capacity; when server refuses to prepare another statement
+     * because of max_prepared_stmt_count, idle statements are evicted and prepare is retried.
+     *
+     * Cache is invalidated when connection is reconnected (including automatic reconnect)
+     * or when user is changed, because server closes all statements of the session.
+     *
+     * Capacity is 0 by default, i.e. statements are closed when they are returned.
+     */
+    class StatementCache
+    {
+    public:
+        struct Statistics
+        {
+            std::uint_fast64_t hits = 0;
+            std::uint_fast64_t misses = 0;
+            std::uint_fast64_t evictions = 0;
+            std::uint_fast64_t invalidations = 0;
+            std::size_t statementsCount = 0;
+        };
+
+    private:
+        template<typename> friend class CachedPreparedStatement;
+
+        /** Idle statements; most recently returned first. */
+        using Entries = std::list<std::unique_ptr<detail::CachedStatementBase>>;
+
+        std::size_t capacity;
+        Entries entries{};
+        /** Key hash to idle statements; statements hold their keys, so lookup does not copy the query. */
+        std::unordered_multimap<std::size_t, Entries::iterator> index{};
+        /** Incremented on every invalidation, statements checked out before are not returned. */
+        std::uint_fast64_t generation = 0;
+        std::uint_fast64_t driverId = 0;
+        unsigned long serverThreadId = 0;
+        Statistics statistics{};
+
+        static std::size_t hash(std::type_index type, const std::string& query) noexcept
+        {
+            return std::hash<std::string>{}(query) * 31 + type.hash_code();
+        }
+
+        Entries::iterator find(std::type_index type, const std::string& query, std::size_t hashValue) noexcept
+        {
+            auto range = index.equal_range(hashValue);
+            for (auto it=range.first; it!=range.second; ++it)
+            {
+                auto& statement = **it->second;
+                if (statement.type == type && statement.query == query)
+                {
+                    auto result = it->second;
+                    index.erase(it);
+                    return result;
+                }
+            }
+            return entries.end();
+        }
+
+        void evictLast() noexcept
+        {
+            auto& statement = *entries.back();
+            find(statement.type, statement.query, hash(statement.type, statement.query));
+            entries.pop_back();
+            ++statistics.evictions;
+        }
+
+        /**
+         * Invalidates statements prepared in previous session of the connection.
+         */
+        void checkSession(LowLevel::DBDriver& driver) noexcept
+        {
+            auto currentDriverId = driver.getId();
+            auto currentServerThreadId = driver.getServerThreadId();
+            if (currentDriverId != driverId || currentServerThreadId != serverThreadId)
+            {
+                clear();
+                driverId = currentDriverId;
+                serverThreadId = currentServerThreadId;
+            }
+        }
+
+        template<typename PreparedStatementType>
+        auto prepare(LowLevel::DBDriver& driver, const std::string& query)
+        {
+            using Statement = detail::CachedStatement<PreparedStatementType>;
+            try
+            {
+                return std::make_unique<Statement>(driver, query);
+            }
+            catch (const MysqlInternalError& e)
+            {
+                if (e.getErrorCode() != ER_MAX_PREPARED_STMT_COUNT_REACHED || entries.empty())
+                {
+                    throw;
+                }
+            }
+
+            // Server-wide limit of prepared statements was reached, release ours and retry
+            while (!entries.empty())
+            {
+                evictLast();
+            }
+            return std::make_unique<Statement>(driver, query);
+        }
+
+        void checkin(std::unique_ptr<detail::CachedStatementBase> statement, std::uint_fast64_t statementGeneration) noexcept
+        {
+            if (statementGeneration != generation || capacity == 0)
+            {
+                return;
+            }
+
+            auto hashValue = hash(statement->type, statement->query);
+            auto range = index.equal_range(hashValue);
+            for (auto it=range.first; it!=range.second; ++it)
+            {
+                auto& idle = **it->second;
+                if (idle.type == statement->type && idle.query == statement->query)
+                {
+                    // Same statement was checked out more than once, keep only one
+                    return;
+                }
+            }
+
+            statement->reset();
+            try
+            {
+                entries.push_front(std::move(statement));
+                try
+                {
+                    index.emplace(hashValue, entries.begin());
+                }
+                catch (...)
+                {
+                    entries.pop_front();
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                // Statement is just closed when it can't be cached
+                return;
+            }
+
+            while (entries.size() > capacity)
+            {
+                evictLast();
+            }
+        }
+
+    public:
+        explicit StatementCache(std::size_t capacity=0) noexcept
+            : capacity{capacity}
+        {
+        }
+
+        StatementCache(const StatementCache&) = delete;
+        StatementCache& operator=(const StatementCache&) = delete;
+        StatementCache(StatementCache&&) = delete;
+        StatementCache& operator=(StatementCache&&) = delete;
+
+        ~StatementCache() = default;
+
+        std::size_t getCapacity() const noexcept
+        {
+            return capacity;
+        }
+
+        /**
+         * Sets maximal number of idle statements; least recently used statements are evicted.
+         */
+        void setCapacity(std::size_t value) noexcept
+        {
+            capacity = value;
+            while (entries.size() > capacity)
+            {
+                evictLast();
+            }
+        }
+
+        Statistics getStatistics() const noexcept
+        {
+            auto result = statistics;
+            result.statementsCount = entries.size();
+            return result;
+        }
+
+        /**
+         * Closes all idle statements; statements checked out at the moment are closed when they are returned.
+         */
+        void clear() noexcept
+        {
+            statistics.invalidations += entries.size();
+            index.clear();
+            entries.clear();
+            ++generation;
+        }
+
+        /**
+         * Returns cached statement or prepares new one.
+         * Params of cached statement keep values of its previous use.
+         *
+         * @tparam PreparedStatementType Statement type; it is part of the key, so it should describe all bindings.
+         */
+        template<typename PreparedStatementType>
+        CachedPreparedStatement<PreparedStatementType> checkout(LowLevel::DBDriver& driver, const std::string& query)
+        {
+            using Statement = detail::CachedStatement<PreparedStatementType>;
+
+            checkSession(driver);
+
+            std::type_index type{typeid(PreparedStatementType)};
+            auto it = find(type, query, hash(type, query));
+            if (it != entries.end())
+            {
+                ++statistics.hits;
+                std::unique_ptr<Statement> statement{static_cast<Statement*>(it->release())};
+                entries.erase(it);
+                return {*this, std::move(statement), generation};
+            }
+
+            ++statistics.misses;
+            return {*this, prepare<PreparedStatementType>(driver, query), generation};
+        }
+    };
+
+
+    template<typename PreparedStatementType>
+    void CachedPreparedStatement<PreparedStatementType>::checkin() noexcept
+    {
+        if (entry)
+        {
+            cache->checkin(std::move(entry), generation);
+        }
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+#include <superior_mysqlpp/connection.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Prepares registered (hot) statements into statement cache of new connections,
+     * so the first use of pooled connection does not pay prepare latency.
+     *
+     * Intended as resource initializer of connection pool:
+     *   StatementWarmUp warmUp{};
+     *   warmUp.addStatement<PreparedStatement<ResultBindings<Sql::Int>, ParamBindings<int>>>("SELECT ...");
+     *   connectionPool.setResourceInitializer(warmUp);
+     *
+     * Copies share registered statements and statistics. Thread-safe.
+     */
+    class StatementWarmUp
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Statistics
+        {
+            std::uint_fast64_t connections = 0;
+            std::uint_fast64_t prepared = 0;
+            std::uint_fast64_t failed = 0;
+            /** Sum and maximum of single statement prepare time. */
+            Clock::duration totalPrepareTime{};
+            Clock::duration maxPrepareTime{};
+            std::string lastError{};
+        };
+
+    private:
+        struct Statement
+        {
+            std::string query;
+            std::function<void(Connection&, const std::string&)> prepare;
+        };
+
+        struct State
+        {
+            std::mutex mutex{};
+            std::vector<Statement> statements{};
+            Statistics statistics{};
+        };
+
+        std::shared_ptr<State> state;
+
+    public:
+        StatementWarmUp()
+            : state{std::make_shared<State>()}
+        {
+        }
+
+        /**
+         * Registers statement; type must be the same as the one later checked out from statement cache
+         * (e.g. by Connection::makeCachedPreparedStatement or psQuery), because it is part of the cache key.
+         */
+        template<typename PreparedStatementType>
+        void addStatement(std::string query)
+        {
+            std::lock_guard<std::mutex> lock{state->mutex};
+            state->statements.push_back({std::move(query), [](Connection& connection, const std::string& query){
+                connection.checkoutPreparedStatement<PreparedStatementType>(query);
+            }});
+        }
+
+        std::size_t getStatementsCount() const
+        {
+            std::lock_guard<std::mutex> lock{state->mutex};
+            return state->statements.size();
+        }
+
+        Statistics getStatistics() const
+        {
+            std::lock_guard<std::mutex> lock{state->mutex};
+            return state->statistics;
+        }
+
+        /**
+         * Prepares all registered statements into connection's statement cache;
+         * cache capacity is raised to hold them. Failed statements are counted and skipped.
+         */
+        void warmUp(Connection& connection) const
+        {
+            std::vector<Statement> statements{};
+            {
+                std::lock_guard<std::mutex> lock{state->mutex};
+                statements = state->statements;
+            }
+
+            auto& cache = connection.getStatementCache();
+            if (cache.getCapacity() < statements.size())
+            {
+                cache.setCapacity(statements.size());
+            }
+
+            Statistics statistics{};
+            for (auto&& statement: statements)
+            {
+                auto start = Clock::now();
+                try
+                {
+                    statement.prepare(connection, statement.query);
+                    ++statistics.prepared;
+                }
+                catch (const std::exception& e)
+                {
+                    ++statistics.failed;
+                    statistics.lastError = e.what();
+                }
+                auto duration = Clock::now() - start;
+                statistics.totalPrepareTime += duration;
+                statistics.maxPrepareTime = std::max(statistics.maxPrepareTime, duration);
+            }
+
+            std::lock_guard<std::mutex> lock{state->mutex};
+            auto& total = state->statistics;
+            ++total.connections;
+            total.prepared += statistics.prepared;
+            total.failed += statistics.failed;
+            total.totalPrepareTime += statistics.totalPrepareTime;
+            total.maxPrepareTime = std::max(total.maxPrepareTime, statistics.maxPrepareTime);
+            if (statistics.failed > 0)
+            {
+                total.lastError = std::move(statistics.lastError);
+            }
+        }
+
+        /**
+         * Resource initializer interface; connection is passed as (smart) pointer.
+         */
+        template<typename ConnectionPtr>
+        void operator()(ConnectionPtr& connection) const
+        {
+            warmUp(*connection);
+        }
+    };
+}
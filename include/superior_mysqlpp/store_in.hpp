@@ -0,0 +1,238 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <array>
+#include <tuple>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+#include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+#include <superior_mysqlpp/query_result.hpp>
+#include <superior_mysqlpp/types/nullable.hpp>
+#include <superior_mysqlpp/types/string_view.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Binds result column (found by name) to member of stored structure.
+     * @see mapColumn
+     */
+    template<typename T, typename Member>
+    struct ColumnMapping
+    {
+        StringView columnName;
+        Member T::* member;
+    };
+
+    /**
+     * Creates mapping of result column to structure member for Query::storeIn, e.g.
+     *   query.storeIn(users, mapColumn("id", &User::id), mapColumn("name", &User::name));
+     */
+    template<typename T, typename Member>
+    constexpr ColumnMapping<T, Member> mapColumn(StringView columnName, Member T::* member)
+    {
+        return {columnName, member};
+    }
+
+
+    namespace detail
+    {
+        /**
+         * Converts text protocol field into T.
+         * NULL is accepted only by Nullable types.
+         */
+        template<typename T>
+        struct FieldConverter
+        {
+            static T convert(const char* data, unsigned long length, std::size_t column)
+            {
+                if (data == nullptr)
+                {
+                    throw LogicError{"Column " + std::to_string(column) + " contains NULL, but target type is not Nullable!"};
+                }
+                return Converters::to<T>(data, length);
+            }
+        };
+
+        template<typename T>
+        struct FieldConverter<Nullable<T>>
+        {
+            static Nullable<T> convert(const char* data, unsigned long length, std::size_t column)
+            {
+                if (data == nullptr)
+                {
+                    return {};
+                }
+                return {FieldConverter<T>::convert(data, length, column)};
+            }
+        };
+
+
+        template<typename T>
+        struct IsTuple : std::false_type
+        {
+        };
+
+        template<typename... Ts>
+        struct IsTuple<std::tuple<Ts...>> : std::true_type
+        {
+        };
+
+        template<typename T1, typename T2>
+        struct IsTuple<std::pair<T1, T2>> : std::true_type
+        {
+        };
+
+
+        /**
+         * Converts rows into Value. Column indexes are resolved once per result set.
+         *
+         * Without mappings Value is either tuple (columns are taken by position)
+         * or a single value (result must have exactly one column).
+         * With mappings Value is default constructed and mapped members are assigned.
+         */
+        template<typename Value, bool isTuple, typename... Mappings>
+        class RowConverter
+        {
+        private:
+            std::tuple<Mappings...> mappings;
+            std::array<std::size_t, sizeof...(Mappings)> columns;
+
+            template<std::size_t... I>
+            void assignMembers(Value& value, MYSQL_ROW row, const unsigned long* lengths, std::index_sequence<I...>) const
+            {
+                using Expander = int[];
+                (void)Expander{0, (
+                    value.*(std::get<I>(mappings).member) =
+                        FieldConverter<std::remove_reference_t<decltype(value.*(std::get<I>(mappings).member))>>::convert(row[columns[I]], lengths[columns[I]], columns[I]),
+                    0)...};
+            }
+
+        public:
+            template<typename Result>
+            RowConverter(Result& result, const Mappings&... columnMappings)
+                : mappings{columnMappings...}
+            {
+                std::size_t i = 0;
+                for (auto&& columnName: {columnMappings.columnName...})
+                {
+                    columns[i++] = result.getColumnIndex(columnName);
+                }
+            }
+
+            Value operator()(MYSQL_ROW row, const unsigned long* lengths) const
+            {
+                Value value{};
+                assignMembers(value, row, lengths, std::index_sequence_for<Mappings...>{});
+                return value;
+            }
+        };
+
+        template<typename Value>
+        class RowConverter<Value, true>
+        {
+        private:
+            template<std::size_t... I>
+            static Value convert(MYSQL_ROW row, const unsigned long* lengths, std::index_sequence<I...>)
+            {
+                // Braced initialization guarantees left-to-right conversion
+                return Value{FieldConverter<std::tuple_element_t<I, Value>>::convert(row[I], lengths[I], I)...};
+            }
+
+        public:
+            template<typename Result>
+            RowConverter(Result& result)
+            {
+                constexpr auto tupleSize = std::tuple_size<Value>::value;
+                if (result.getMetadata().size() != tupleSize)
+                {
+                    throw LogicError{"Result has " + std::to_string(result.getMetadata().size())
+                                     + " columns, but stored tuple has " + std::to_string(tupleSize) + " elements!"};
+                }
+            }
+
+            Value operator()(MYSQL_ROW row, const unsigned long* lengths) const
+            {
+                return convert(row, lengths, std::make_index_sequence<std::tuple_size<Value>::value>{});
+            }
+        };
+
+        template<typename Value>
+        class RowConverter<Value, false>
+        {
+        public:
+            template<typename Result>
+            RowConverter(Result& result)
+            {
+                if (result.getMetadata().size() != 1)
+                {
+                    throw LogicError{"Result has " + std::to_string(result.getMetadata().size())
+                                     + " columns, but single column is required by stored type!"};
+                }
+            }
+
+            Value operator()(MYSQL_ROW row, const unsigned long* lengths) const
+            {
+                return FieldConverter<Value>::convert(row[0], lengths[0], 0);
+            }
+        };
+
+
+        template<typename Container>
+        auto reserveRows(Container& container, std::size_t rowsCount, int) -> decltype(container.reserve(rowsCount), void())
+        {
+            container.reserve(container.size() + rowsCount);
+        }
+
+        template<typename Container>
+        void reserveRows(Container&, std::size_t, long)
+        {
+        }
+
+        template<typename Container>
+        auto isSequence(int) -> decltype(std::declval<Container&>().emplace_back(std::declval<typename Container::value_type>()), std::true_type{});
+
+        template<typename Container>
+        std::false_type isSequence(long);
+
+        template<typename Container, typename Value>
+        auto insertRow(Container& container, Value&& value, int) -> decltype(container.emplace_back(std::forward<Value>(value)), void())
+        {
+            container.emplace_back(std::forward<Value>(value));
+        }
+
+        template<typename Container, typename Value>
+        void insertRow(Container& container, Value&& value, long)
+        {
+            container.insert(container.end(), std::forward<Value>(value));
+        }
+
+        /**
+         * Converts all rows of stored result and inserts those accepted by predicate into container.
+         */
+        template<typename Container, typename Predicate, typename... Mappings>
+        void storeRowsIn(StoreQueryResult& result, Container& container, Predicate&& predicate, const Mappings&... mappings)
+        {
+            using Value = typename Container::value_type;
+            const RowConverter<Value, IsTuple<Value>::value && sizeof...(Mappings) == 0, Mappings...> converter{result, mappings...};
+
+            auto& lowLevelResult = result.detail_getResult();
+            reserveRows(container, lowLevelResult.getRowsCount(), 0);
+            while (auto row = lowLevelResult.fetchRow())
+            {
+                auto value = converter(row, lowLevelResult.fetchLengths());
+                if (predicate(static_cast<const Value&>(value)))
+                {
+                    insertRow(container, std::move(value), 0);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <superior_mysqlpp/prepared_statement_fwd.hpp>
+
+
+/*
+ * Mapping of plain structs to prepared statement bindings.
+ * Struct declares its members (in order of query columns or params) by SUPERIOR_MYSQLPP_MEMBERS:
+ *
+ *   struct Employee
+ *   {
+ *       int id;
+ *       StringData name;
+ *       Nullable<Sql::Double> salary;
+ *
+ *       SUPERIOR_MYSQLPP_MEMBERS(id, name, salary)
+ *   };
+ *
+ *   auto preparedStatement = connection.makePreparedStatement<StructResultBindings<Employee>>("SELECT ...");
+ *   preparedStatement.execute();
+ *   std::vector<Employee> employees{};
+ *   preparedStatement.fetchAllInto(employees);
+ */
+
+
+namespace SuperiorMySqlpp
+{
+    namespace detail
+    {
+        /**
+         * Detects struct with members declared by SUPERIOR_MYSQLPP_MEMBERS.
+         */
+        template<typename T, typename=void>
+        struct HasStructMembers : std::false_type {};
+
+        template<typename T>
+        struct HasStructMembers<T, decltype(void(std::declval<T&>().superiorMySqlppTie()))> : std::true_type {};
+
+        /**
+         * Returns tuple of references to declared members of struct.
+         */
+        template<typename T>
+        inline auto tieMembers(T& row) noexcept
+        {
+            static_assert(HasStructMembers<T>::value, "Struct members must be declared by SUPERIOR_MYSQLPP_MEMBERS!");
+            return row.superiorMySqlppTie();
+        }
+
+        template<typename Tuple>
+        struct DecayTupleTypes;
+
+        template<typename... Types>
+        struct DecayTupleTypes<std::tuple<Types...>>
+        {
+            using type = std::tuple<std::decay_t<Types>...>;
+        };
+
+        /**
+         * Tuple of types of declared members of struct.
+         */
+        template<typename T>
+        using StructMembersTuple = typename DecayTupleTypes<decltype(tieMembers(std::declval<T&>()))>::type;
+
+        template<bool IsParamBinding, typename Tuple>
+        struct StructBindingsImpl;
+
+        template<bool IsParamBinding, typename... Types>
+        struct StructBindingsImpl<IsParamBinding, std::tuple<Types...>>
+        {
+            using type = Bindings<IsParamBinding, Types...>;
+        };
+
+        /**
+         * Returns params row as is, unless it is struct with declared members,
+         * then tuple of references to its members is returned.
+         */
+        template<typename T, typename std::enable_if<!HasStructMembers<T>::value, int>::type=0>
+        inline const T& toParamsRow(const T& row) noexcept
+        {
+            return row;
+        }
+
+        template<typename T, typename std::enable_if<HasStructMembers<T>::value, int>::type=0>
+        inline auto toParamsRow(const T& row) noexcept
+        {
+            return tieMembers(row);
+        }
+    }
+
+    /**
+     * ResultBindings of types of members of struct declared by SUPERIOR_MYSQLPP_MEMBERS.
+     */
+    template<typename T>
+    using StructResultBindings = typename detail::StructBindingsImpl<false, detail::StructMembersTuple<T>>::type;
+
+    /**
+     * ParamBindings of types of members of struct declared by SUPERIOR_MYSQLPP_MEMBERS.
+     */
+    template<typename T>
+    using StructParamBindings = typename detail::StructBindingsImpl<true, detail::StructMembersTuple<T>>::type;
+}
+
+
+/**
+ * Declares members of struct mapped to columns of result (or params) of prepared statement, in order.
+ * Is used inside struct definition; struct stays an aggregate.
+ */
+#define SUPERIOR_MYSQLPP_MEMBERS(...) \
+    auto superiorMySqlppTie() noexcept \
+    { \
+        return std::tie(__VA_ARGS__); \
+    } \
+    auto superiorMySqlppTie() const noexcept \
+    { \
+        return std::tie(__VA_ARGS__); \
+    }
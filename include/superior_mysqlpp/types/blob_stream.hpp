@@ -0,0 +1,183 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <streambuf>
+#include <vector>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/field_types.hpp>
+#include <superior_mysqlpp/types/string_view.hpp>
+#include <superior_mysqlpp/prepared_statements/binding_types.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Result storage reading blob value in chunks.
+     * Nothing of the value is transferred into the binding on fetch, value is read from the fetched row
+     * by mysql_stmt_fetch_column with increasing offsets, so memory per row is constant regardless of value size.
+     *
+     * @remark Value can be read only until next fetch of the statement (and only through PreparedStatement
+     *         with data truncation reporting enabled).
+     */
+    class BlobStream
+    {
+    private:
+        LowLevel::DBDriver::Statement* statement = nullptr;
+        unsigned int column = 0;
+        /** Length of the value, is set by C client on fetch. */
+        unsigned long itemsCount = 0;
+        std::size_t offset = 0;
+        /** Empty buffer of the binding, C client just reports length of the value. */
+        char emptyBuffer[1] = {};
+
+    public:
+        static constexpr std::size_t getDefaultChunkSize()
+        {
+            return 64 * 1024;
+        }
+
+        BlobStream() = default;
+        BlobStream(const BlobStream&) = default;
+        BlobStream(BlobStream&&) = default;
+        BlobStream& operator=(const BlobStream&) = default;
+        BlobStream& operator=(BlobStream&&) = default;
+        ~BlobStream() = default;
+
+        /**
+         * Attaches storage to fetched row, value is read from the beginning.
+         */
+        void detail_attach(LowLevel::DBDriver::Statement& statement, unsigned int column) noexcept
+        {
+            this->statement = &statement;
+            this->column = column;
+            offset = 0;
+        }
+
+        unsigned long& counterRef() noexcept
+        {
+            return itemsCount;
+        }
+
+        const unsigned long& counterRef() const noexcept
+        {
+            return itemsCount;
+        }
+
+        char* data() noexcept
+        {
+            return emptyBuffer;
+        }
+
+        constexpr std::size_t maxSize() const noexcept
+        {
+            return 0;
+        }
+
+        /**
+         * Returns length of the whole value.
+         */
+        std::size_t size() const noexcept
+        {
+            return itemsCount;
+        }
+
+        /**
+         * Returns length of the rest of the value, which was not read yet.
+         */
+        std::size_t remaining() const noexcept
+        {
+            return offset < size()? size() - offset : 0;
+        }
+
+        /**
+         * Reads next chunk of the value.
+         * @return Number of bytes read, 0 at the end of the value.
+         */
+        std::size_t read(char* destination, std::size_t count)
+        {
+            count = std::min(count, remaining());
+            if (count == 0)
+            {
+                return 0;
+            }
+            if (statement == nullptr)
+            {
+                throw LogicError{"BlobStream is not attached to fetched row!"};
+            }
+
+            unsigned long length = 0;
+            MYSQL_BIND binding{};
+            binding.buffer = destination;
+            binding.buffer_type = detail::toMysqlEnum(FieldTypes::Blob);
+            binding.buffer_length = count;
+            binding.length = &length;
+            statement->fetchColumn(&binding, column, offset);
+            offset += count;
+            return count;
+        }
+
+        /**
+         * Reads the rest of the value in chunks, callback is called with StringView of each chunk.
+         * Only one chunk is kept in memory.
+         */
+        template<typename Callable>
+        void readChunks(Callable&& callback, std::size_t chunkSize=getDefaultChunkSize())
+        {
+            std::vector<char> chunk(std::max<std::size_t>(1, std::min(chunkSize, remaining())));
+            while (auto count = read(chunk.data(), chunk.size()))
+            {
+                callback(StringView{chunk.data(), count});
+            }
+        }
+    };
+
+
+    /**
+     * Stream buffer reading value of BlobStream, so it can be read by std::istream.
+     *   BlobStreamBuffer buffer{std::get<0>(preparedStatement.getResult())};
+     *   std::istream input{&buffer};
+     */
+    class BlobStreamBuffer : public std::streambuf
+    {
+    private:
+        BlobStream& stream;
+        std::vector<char> buffer;
+
+    protected:
+        int_type underflow() override
+        {
+            if (gptr() < egptr())
+            {
+                return traits_type::to_int_type(*gptr());
+            }
+
+            auto count = stream.read(buffer.data(), buffer.size());
+            if (count == 0)
+            {
+                return traits_type::eof();
+            }
+            setg(buffer.data(), buffer.data(), buffer.data() + count);
+            return traits_type::to_int_type(*gptr());
+        }
+
+    public:
+        explicit BlobStreamBuffer(BlobStream& stream, std::size_t chunkSize=BlobStream::getDefaultChunkSize())
+            : stream{stream}, buffer(std::max<std::size_t>(1, chunkSize))
+        {
+        }
+    };
+
+
+    namespace detail
+    {
+        template<>
+        struct CanBindAsResult<BindingTypes::Blob, BlobStream> : std::true_type {};
+    }
+}
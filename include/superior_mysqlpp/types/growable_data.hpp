@@ -0,0 +1,164 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <string>
+
+#include <superior_mysqlpp/types/string_view.hpp>
+#include <superior_mysqlpp/prepared_statements/binding_types.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Result storage of string or blob values of any length.
+     * Value is fetched directly into std::string buffer, which is either owned or provided by caller
+     * (and reused for all rows). When value doesn't fit, PreparedStatement grows the buffer
+     * and fetches only the rest of the value, so the value is neither truncated nor copied twice.
+     *
+     * Buffer is used as whole (its size is capacity of this storage), value is in first #size() bytes
+     * and it is not zero-terminated.
+     *
+     * @remark Copies share caller provided buffer.
+     * @remark Tails of long values are fetched only by PreparedStatement (with data truncation reporting enabled).
+     */
+    template<detail::BindingTypes bindingType>
+    class GrowableDataBase
+    {
+    private:
+        std::string ownBuffer{};
+        std::string* externalBuffer = nullptr;
+        /** Length of the value, is set by C client and may be larger than buffer until the rest is fetched. */
+        unsigned long itemsCount = 0;
+
+    public:
+        static constexpr std::size_t getInitialCapacity()
+        {
+            return 1024;
+        }
+
+        GrowableDataBase()
+            : ownBuffer(getInitialCapacity(), '\0')
+        {
+        }
+
+        /**
+         * Values are fetched into buffer, which must outlive this storage and its copies.
+         * Empty buffer is resized to initial capacity.
+         */
+        explicit GrowableDataBase(std::string& buffer)
+            : externalBuffer{&buffer}
+        {
+            if (buffer.empty())
+            {
+                buffer.resize(getInitialCapacity());
+            }
+        }
+
+        GrowableDataBase(const GrowableDataBase&) = default;
+        GrowableDataBase(GrowableDataBase&&) = default;
+        GrowableDataBase& operator=(const GrowableDataBase&) = default;
+        GrowableDataBase& operator=(GrowableDataBase&&) = default;
+        ~GrowableDataBase() = default;
+
+        std::string& detail_getBufferRef() noexcept
+        {
+            return externalBuffer? *externalBuffer : ownBuffer;
+        }
+
+        const std::string& detail_getBufferRef() const noexcept
+        {
+            return externalBuffer? *externalBuffer : ownBuffer;
+        }
+
+        /**
+         * Grows buffer to hold at least size bytes, capacity is at least doubled
+         * so that buffer (and result binding) changes only few times.
+         */
+        void detail_grow(std::size_t size)
+        {
+            auto& buffer = detail_getBufferRef();
+            if (size > buffer.size())
+            {
+                buffer.resize(std::max(size, 2 * buffer.size()));
+            }
+        }
+
+        unsigned long& counterRef() noexcept
+        {
+            return itemsCount;
+        }
+
+        const unsigned long& counterRef() const noexcept
+        {
+            return itemsCount;
+        }
+
+        char* data() noexcept
+        {
+            return &detail_getBufferRef()[0];
+        }
+
+        const char* data() const noexcept
+        {
+            return detail_getBufferRef().data();
+        }
+
+        std::size_t maxSize() const noexcept
+        {
+            return detail_getBufferRef().size();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return std::min(static_cast<std::size_t>(itemsCount), maxSize());
+        }
+
+        std::size_t length() const noexcept
+        {
+            return size();
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        std::string getString() const
+        {
+            return {data(), size()};
+        }
+
+        StringView getStringView() const
+        {
+            return {data(), size()};
+        }
+
+        operator std::string() const
+        {
+            return getString();
+        }
+
+        operator StringView() const
+        {
+            return getStringView();
+        }
+    };
+
+    using GrowableStringData = GrowableDataBase<detail::BindingTypes::String>;
+    using GrowableBlobData = GrowableDataBase<detail::BindingTypes::Blob>;
+
+
+    namespace detail
+    {
+        template<>
+        struct CanBindAsResult<BindingTypes::String, GrowableStringData> : std::true_type {};
+
+        template<>
+        struct CanBindAsResult<BindingTypes::Blob, GrowableBlobData> : std::true_type {};
+    }
+}
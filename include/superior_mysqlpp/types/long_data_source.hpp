@@ -0,0 +1,200 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <superior_mysqlpp/low_level/dbdriver.hpp>
+#include <superior_mysqlpp/prepared_statements/binding_types.hpp>
+#include <superior_mysqlpp/exceptions.hpp>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Param storage streaming blob value from a source (iterator range, std::istream, file descriptor
+     * or custom reader) to server in chunks by mysql_stmt_send_long_data, when PreparedStatement is executed.
+     * Only one chunk is kept in memory, so the value doesn't have to be materialized before upload.
+     *
+     *   preparedStatement.setParams(42, LongDataSource::fromStream(file, 256 * 1024));
+     *   preparedStatement.execute();
+     *
+     * @remark Source is consumed by execution, set new source before the statement is executed again
+     *         (otherwise empty value is sent). Stream, file descriptor and range must outlive execution.
+     * @remark Copies share stream and file descriptor sources.
+     */
+    class LongDataSource
+    {
+    public:
+        /**
+         * Reads at most count bytes into destination.
+         * @return Number of bytes read, 0 at the end of the value.
+         */
+        using Reader = std::function<std::size_t(char* destination, std::size_t count)>;
+
+    private:
+        Reader reader{};
+        std::size_t chunkSize = getDefaultChunkSize();
+        /** Length of the value in the binding, data are always sent separately. */
+        unsigned long itemsCount = 0;
+        /** Empty buffer of the binding. */
+        char emptyBuffer[1] = {};
+
+    public:
+        static constexpr std::size_t getDefaultChunkSize()
+        {
+            return 64 * 1024;
+        }
+
+        /**
+         * Empty source, empty value is sent.
+         */
+        LongDataSource() = default;
+
+        /**
+         * Source reading value by custom reader.
+         */
+        explicit LongDataSource(Reader reader, std::size_t chunkSize=getDefaultChunkSize())
+            : reader{std::move(reader)}, chunkSize{std::max<std::size_t>(1, chunkSize)}
+        {
+        }
+
+        LongDataSource(const LongDataSource&) = default;
+        LongDataSource(LongDataSource&&) = default;
+        LongDataSource& operator=(const LongDataSource&) = default;
+        LongDataSource& operator=(LongDataSource&&) = default;
+        ~LongDataSource() = default;
+
+        /**
+         * Source reading value from iterator range of chars (or values convertible to char).
+         */
+        template<typename Iterator>
+        static LongDataSource fromRange(Iterator first, Iterator last, std::size_t chunkSize=getDefaultChunkSize())
+        {
+            return LongDataSource{[first, last](char* destination, std::size_t count) mutable {
+                std::size_t read = 0;
+                for (; read<count && first!=last; ++read, ++first)
+                {
+                    destination[read] = static_cast<char>(*first);
+                }
+                return read;
+            }, chunkSize};
+        }
+
+        /**
+         * Source reading value from stream until its end.
+         * @throws RuntimeError If reading of stream fails.
+         */
+        static LongDataSource fromStream(std::istream& stream, std::size_t chunkSize=getDefaultChunkSize())
+        {
+            return LongDataSource{[&stream](char* destination, std::size_t count) {
+                stream.read(destination, static_cast<std::streamsize>(count));
+                if (stream.bad())
+                {
+                    throw RuntimeError{"Failed to read long data from stream!"};
+                }
+                return static_cast<std::size_t>(stream.gcount());
+            }, chunkSize};
+        }
+
+        /**
+         * Source reading value from file descriptor until end of file. Descriptor is not closed.
+         * @throws RuntimeError If reading of file descriptor fails.
+         */
+        static LongDataSource fromFileDescriptor(int fileDescriptor, std::size_t chunkSize=getDefaultChunkSize())
+        {
+            return LongDataSource{[fileDescriptor](char* destination, std::size_t count) {
+                std::size_t read = 0;
+                while (read < count)
+                {
+                    auto result = ::read(fileDescriptor, destination + read, count - read);
+                    if (result == 0)
+                    {
+                        break;
+                    }
+                    if (result < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        throw RuntimeError{"Failed to read long data from file descriptor: " + std::string{std::strerror(errno)}};
+                    }
+                    read += static_cast<std::size_t>(result);
+                }
+                return read;
+            }, chunkSize};
+        }
+
+        std::size_t getChunkSize() const noexcept
+        {
+            return chunkSize;
+        }
+
+        /**
+         * Returns true if the source was not consumed yet.
+         */
+        bool hasData() const noexcept
+        {
+            return static_cast<bool>(reader);
+        }
+
+        /**
+         * Sends whole value of the source as long data of param, source is consumed.
+         * Params must be bound already; nothing is sent for empty value, so the (empty) value of binding is used.
+         */
+        void detail_send(LowLevel::DBDriver::Statement& statement, unsigned int paramNumber)
+        {
+            if (!reader)
+            {
+                return;
+            }
+
+            auto currentReader = std::move(reader);
+            reader = nullptr;
+            std::vector<char> chunk(chunkSize);
+            while (auto count = currentReader(chunk.data(), chunk.size()))
+            {
+                statement.sendLongData(paramNumber, chunk.data(), count);
+            }
+        }
+
+        unsigned long& counterRef() noexcept
+        {
+            return itemsCount;
+        }
+
+        const unsigned long& counterRef() const noexcept
+        {
+            return itemsCount;
+        }
+
+        char* data() noexcept
+        {
+            return emptyBuffer;
+        }
+
+        constexpr std::size_t size() const noexcept
+        {
+            return 0;
+        }
+    };
+
+
+    namespace detail
+    {
+        template<>
+        struct CanBindAsParam<BindingTypes::Blob, LongDataSource> : std::true_type {};
+    }
+}
@@ -204,7 +204,10 @@ public:
             }
             else
             {
-                destroyPayload();
+                if (engaged)
+                {
+                    destroyPayload();
+                }
                 null = true;
             }
         }
@@ -228,7 +231,10 @@ public:
             }
             else
             {
-                destroyPayload();
+                if (engaged)
+                {
+                    destroyPayload();
+                }
                 null = true;
             }
         }
@@ -411,6 +417,18 @@ public:
         return payload;
     }
 
+    /*
+     * DO NOT USE this function unless you really need to!
+     * Default constructs payload if there is none, null state is kept.
+     */
+    void detail_constructPayload()
+    {
+        if (!engaged)
+        {
+            constructPayload();
+        }
+    }
+
     /*
      * DO NOT USE this function unless you really need to!
      */
@@ -14,6 +14,7 @@
 #include <superior_mysqlpp/types/string_view.hpp>
 #include <superior_mysqlpp/types/blob_data.hpp>
 #include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_chars.hpp>
 #include <superior_mysqlpp/exceptions.hpp>
 #include <superior_mysqlpp/prepared_statements/binding_types.hpp>
 
@@ -37,20 +38,28 @@ namespace SuperiorMySqlpp
         using BlobDataBase<N, true>::BlobDataBase;
 
 
-        /*
-         * TODO: add optional arguments specifying precision and formating
+        /**
+         * Integers are written as by std::to_string, float and double in short form
+         * which converts back to the same value (see Converters::toChars).
          */
         template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type=0>
         explicit StringDataBase(T value)
         {
-            auto s = Converters::toString(value);
-            if (s.size() > this->maxSize())
+            char buffer[Converters::toCharsBufferSize];
+            auto end = Converters::toChars(buffer, buffer + sizeof(buffer), value);
+            if (end == nullptr)
             {
                 throw RuntimeError{"Conversion truncated data!"};
             }
 
-            std::memcpy(this->data(), s.data(), s.size());
-            this->itemsCount = s.size();
+            auto size = static_cast<std::size_t>(end - buffer);
+            if (size > this->maxSize())
+            {
+                throw RuntimeError{"Conversion truncated data!"};
+            }
+
+            std::memcpy(this->data(), buffer, size);
+            this->itemsCount = size;
         }
 
         constexpr auto length() const
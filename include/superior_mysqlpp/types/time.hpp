@@ -94,6 +94,17 @@ namespace SuperiorMySqlpp
         {
             setSign(false);
         }
+
+        auto getSecondFraction() const
+        {
+            return buffer.second_part;
+        }
+
+        template<typename U>
+        void setSecondFraction(U&& secondFraction)
+        {
+            buffer.second_part = std::forward<U>(secondFraction);
+        }
     };
 
 
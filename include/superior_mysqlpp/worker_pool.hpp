@@ -0,0 +1,130 @@
+/*
+ * Author: Tomas Nozicka
+ */
+
+#pragma once
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace SuperiorMySqlpp
+{
+    /**
+     * Fixed number of threads processing submitted tasks in FIFO order.
+     *
+     * Tasks are expected to be coarse (e.g. chunks of rows), so single shared queue is used.
+     * Destructor finishes all submitted tasks.
+     */
+    class WorkerPool
+    {
+    private:
+        std::mutex mutex{};
+        std::condition_variable condition{};
+        std::deque<std::function<void()>> tasks{};
+        bool stopping = false;
+        std::vector<std::thread> threads{};
+
+        void job()
+        {
+            while (true)
+            {
+                std::function<void()> task{};
+                {
+                    std::unique_lock<std::mutex> lock{mutex};
+                    condition.wait(lock, [this](){ return stopping || !tasks.empty(); });
+                    if (tasks.empty())
+                    {
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                // Exceptions are stored in futures of tasks
+                task();
+            }
+        }
+
+        void stop() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                stopping = true;
+            }
+            condition.notify_all();
+            for (auto&& thread: threads)
+            {
+                thread.join();
+            }
+            threads.clear();
+        }
+
+    public:
+        /**
+         * @param threadsCount Number of threads; 0 means number of hardware threads.
+         */
+        explicit WorkerPool(std::size_t threadsCount=0)
+        {
+            if (threadsCount == 0)
+            {
+                threadsCount = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            threads.reserve(threadsCount);
+            try
+            {
+                for (std::size_t i=0; i<threadsCount; ++i)
+                {
+                    threads.emplace_back(&WorkerPool::job, this);
+                }
+            }
+            catch (...)
+            {
+                stop();
+                throw;
+            }
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        WorkerPool& operator=(WorkerPool&&) = delete;
+
+        ~WorkerPool()
+        {
+            stop();
+        }
+
+        std::size_t getThreadsCount() const noexcept
+        {
+            return threads.size();
+        }
+
+        /**
+         * @return Future of function's result; exception thrown by function is rethrown by future.
+         */
+        template<typename F>
+        auto submit(F function)
+        {
+            using Result = decltype(function());
+            // std::function requires copyable target
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+            auto future = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                tasks.emplace_back([task](){ (*task)(); });
+            }
+            condition.notify_one();
+            return future;
+        }
+    };
+}
@@ -2,9 +2,19 @@
  *  Author: Tomas Nozicka
  */
 
+#include <clocale>
+#include <cmath>
 #include <string>
+#include <limits>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <stdexcept>
 #include <bandit/bandit.h>
 #include <superior_mysqlpp/converters.hpp>
+#include <superior_mysqlpp/converters/to_chars.hpp>
+#include <superior_mysqlpp/converters/to_integer_batch.hpp>
 
 struct Foo {
     int intValue;
@@ -75,6 +85,204 @@ go_bandit([](){
             auto i = Converters::to<Bar>(s.data(), s.length());
             AssertThat(i, Equals(Bar{125}));
         });
+        it("can write numbers as std::to_string", [&](){
+            auto check = [](auto value){
+                char buffer[Converters::toCharsBufferSize];
+                auto end = Converters::toChars(buffer, buffer + sizeof(buffer), value);
+                AssertThat(std::string(buffer, end), Equals(std::to_string(value)));
+            };
+            check(0);
+            check(-1);
+            check(std::numeric_limits<std::int8_t>::min());
+            check(std::numeric_limits<std::int16_t>::min());
+            check(std::numeric_limits<std::int32_t>::min());
+            check(std::numeric_limits<std::int64_t>::min());
+            check(std::numeric_limits<std::int64_t>::max());
+            check(std::numeric_limits<std::uint64_t>::max());
+            for (std::uint64_t power=1; power<=1000000000000000000u; power*=10)
+            {
+                check(power - 1);
+                check(power);
+            }
+        });
+        it("can write short round-trip floating point numbers", [&](){
+            auto write = [](auto value){
+                char buffer[Converters::toCharsBufferSize];
+                auto end = Converters::toChars(buffer, buffer + sizeof(buffer), value);
+                return std::string(buffer, end);
+            };
+            AssertThat(write(0.0), Equals("0"));
+            AssertThat(write(-0.0), Equals("-0"));
+            AssertThat(write(1.5f), Equals("1.5"));
+            AssertThat(write(-0.125), Equals("-0.125"));
+            AssertThat(write(0.1), Equals("0.1"));
+            AssertThat(write(0.1f), Equals("0.1"));
+            AssertThat(write(0.3), Equals("0.3"));
+            AssertThat(write(12345.678), Equals("12345.678"));
+            AssertThat(write(123456789012345.0), Equals("123456789012345"));
+            AssertThat(write(1e15), Equals("1e15"));
+            AssertThat(write(0.0001), Equals("0.0001"));
+            AssertThat(write(1.5e-7), Equals("1.5e-7"));
+            AssertThat(write(1e300), Equals("1e300"));
+            AssertThat(write(std::numeric_limits<double>::max()), Equals("1.7976931348623157e308"));
+            AssertThat(write(std::numeric_limits<double>::denorm_min()), Equals("5e-324"));
+            AssertThat(write(std::numeric_limits<float>::max()), Equals("3.4028235e38"));
+            AssertThat(write(std::numeric_limits<double>::infinity()), Equals("inf"));
+            AssertThat(write(-std::numeric_limits<double>::infinity()), Equals("-inf"));
+            AssertThat(write(std::numeric_limits<double>::quiet_NaN()), Equals("nan"));
+            AssertThat(write(1.5L), Equals("1.5"));
+
+            std::mt19937_64 generator{1};
+            for (int i=0; i<10000; ++i)
+            {
+                auto bits = generator();
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                if (std::isfinite(value))
+                {
+                    auto written = write(value);
+                    AssertThat(Converters::toFloatingPoint<double>(written.data(), written.size()), Equals(value));
+                }
+            }
+        });
+        it("writes long double independently of locale", [&](){
+            std::string previousLocale{std::setlocale(LC_NUMERIC, nullptr)};
+            // Test is effective only where some locale with decimal comma is installed
+            for (auto locale: {"de_DE.UTF-8", "cs_CZ.UTF-8", "fr_FR.UTF-8"})
+            {
+                if (std::setlocale(LC_NUMERIC, locale) != nullptr)
+                {
+                    char buffer[Converters::toCharsBufferSize];
+                    auto end = Converters::toChars(buffer, buffer + sizeof(buffer), 2.5L);
+                    AssertThat(std::string(buffer, end), Equals("2.5"));
+                }
+            }
+            std::setlocale(LC_NUMERIC, previousLocale.c_str());
+        });
+        it("reports insufficient buffer", [&](){
+            char buffer[3];
+            AssertThat(Converters::toChars(buffer, buffer + sizeof(buffer), 123) - buffer, Equals(3));
+            AssertThat(Converters::toChars(buffer, buffer + sizeof(buffer), -12) - buffer, Equals(3));
+            AssertThat(Converters::toChars(buffer, buffer + sizeof(buffer), 1234) == nullptr, IsTrue());
+            AssertThat(Converters::toChars(buffer, buffer + sizeof(buffer), 1.5) - buffer, Equals(3));
+            AssertThat(Converters::toChars(buffer, buffer + sizeof(buffer), -1.5) == nullptr, IsTrue());
+        });
+        it("can parse floating point numbers", [&](){
+            auto parse = [](const std::string& value){
+                return Converters::toFloatingPoint<double>(value.data(), value.size());
+            };
+            AssertThat(parse("0"), Equals(0.0));
+            AssertThat(std::signbit(parse("-0")), IsTrue());
+            AssertThat(parse("1.5"), Equals(1.5));
+            AssertThat(parse("-.5"), Equals(-0.5));
+            AssertThat(parse("+3."), Equals(3.0));
+            AssertThat(parse("0.1"), Equals(0.1));
+            AssertThat(parse("1e23"), Equals(1e23));
+            AssertThat(parse("1.5E-7"), Equals(1.5e-7));
+            AssertThat(parse("-159417.8448"), Equals(-159417.8448));
+            AssertThat(parse("1.7976931348623157e308"), Equals(std::numeric_limits<double>::max()));
+            AssertThat(parse("4.9406564584124654e-324"), Equals(std::numeric_limits<double>::denorm_min()));
+            AssertThat(parse("2e308"), Equals(std::numeric_limits<double>::infinity()));
+            AssertThat(parse("1e-400"), Equals(0.0));
+            AssertThat(parse("-inf"), Equals(-std::numeric_limits<double>::infinity()));
+            AssertThat(std::isnan(parse("NaN")), IsTrue());
+            // Exactly between two doubles; more digits than fit into 64-bit mantissa
+            AssertThat(parse("9007199254740993"), Equals(9007199254740992.0));
+            AssertThat(parse("9007199254740993.0000000000000000001"), Equals(9007199254740994.0));
+            AssertThat(parse("0.30000000000000000000000000000000000001"), Equals(0.3));
+            AssertThat(Converters::toFloatingPoint<float>("3.4028235e38", 12), Equals(std::numeric_limits<float>::max()));
+            AssertThat(Converters::toFloatingPoint<float>("3.4028236e38", 12), Equals(std::numeric_limits<float>::infinity()));
+            AssertThat(Converters::toFloatingPoint<float>("0.1", 3), Equals(0.1f));
+            AssertThat(Converters::toFloatingPoint<long double>("1.25", 4), Equals(1.25L));
+
+            // Only given length is parsed
+            AssertThat(Converters::toFloatingPoint<double>("12345", 3), Equals(123.0));
+
+            for (auto&& invalid: {"", "-", ".", "e5", "1e", "1e+", "1.2.3", "1,5", " 1", "1 ", "0x10", "1f", "infinite"})
+            {
+                AssertThrows(std::domain_error, parse(invalid));
+            }
+        });
+        it("can convert integer columns in batch", [&](){
+            using Converters::IntegerParseStatus;
+
+            std::vector<std::string> fields{"0", "42", "-17", "2147483647", "-2147483648", "2147483648",
+                                            "00000000000000000000007", "12a", "", "-", "123456789012"};
+            std::vector<const char*> values{};
+            std::vector<unsigned long> lengths{};
+            for (auto&& field: fields)
+            {
+                values.push_back(field.data());
+                lengths.push_back(field.size());
+            }
+            values.push_back(nullptr);
+            lengths.push_back(0);
+
+            std::vector<std::int32_t> output(values.size());
+            std::vector<IntegerParseStatus> statuses(values.size());
+            auto report = Converters::toIntegerBatch(values.data(), lengths.data(), values.size(), output.data(), statuses.data());
+
+            AssertThat(output, Equals(std::vector<std::int32_t>{0, 42, -17, 2147483647, -2147483648, 0, 7, 0, 0, 0, 0, 0}));
+            AssertThat(statuses[5] == IntegerParseStatus::overflow, IsTrue());
+            AssertThat(statuses[7] == IntegerParseStatus::invalid, IsTrue());
+            AssertThat(statuses[9] == IntegerParseStatus::invalid, IsTrue());
+            AssertThat(statuses[11] == IntegerParseStatus::null, IsTrue());
+            AssertThat(report.isOk(), IsFalse());
+            AssertThat(report.overflowCount, Equals(2u));
+            AssertThat(report.invalidCount, Equals(3u));
+            AssertThat(report.nullCount, Equals(1u));
+            AssertThat(report.firstErrorIndex, Equals(5u));
+        });
+
+        it("can convert long zero-filled integer columns in batch", [&](){
+            using Converters::IntegerParseStatus;
+
+            std::vector<std::string> fields{std::string(30, '0') + "12345", "-" + std::string(30, '0') + "5",
+                                            std::string(40, '0') + "9223372036854775807", std::string(25, '0'),
+                                            "1" + std::string(29, '0'), std::string(30, '0') + "x"};
+            std::vector<const char*> values{};
+            std::vector<unsigned long> lengths{};
+            for (auto&& field: fields)
+            {
+                values.push_back(field.data());
+                lengths.push_back(field.size());
+            }
+
+            std::vector<std::int64_t> output(values.size());
+            std::vector<IntegerParseStatus> statuses(values.size());
+            auto report = Converters::toIntegerBatch(values.data(), lengths.data(), values.size(), output.data(), statuses.data());
+
+            AssertThat(output, Equals(std::vector<std::int64_t>{12345, -5, 9223372036854775807, 0, 0, 0}));
+            AssertThat(statuses[4] == IntegerParseStatus::overflow, IsTrue());
+            AssertThat(statuses[5] == IntegerParseStatus::invalid, IsTrue());
+            AssertThat(report.firstErrorIndex, Equals(4u));
+        });
+
+        it("converts integer columns in batch as toInteger does", [&](){
+            std::vector<std::string> fields{};
+            for (std::uint64_t value=1; value<std::numeric_limits<std::uint64_t>::max()/7; value=value*7+3)
+            {
+                fields.push_back(std::to_string(value));
+            }
+            fields.push_back(std::to_string(std::numeric_limits<std::uint64_t>::max()));
+
+            std::vector<const char*> values{};
+            std::vector<unsigned long> lengths{};
+            for (auto&& field: fields)
+            {
+                values.push_back(field.data());
+                lengths.push_back(field.size());
+            }
+
+            std::vector<std::uint64_t> output(values.size());
+            auto report = Converters::toIntegerBatch(values.data(), lengths.data(), values.size(), output.data());
+            AssertThat(report.isOk(), IsTrue());
+            AssertThat(report.firstErrorIndex, Equals(values.size()));
+            for (std::size_t i=0; i<values.size(); ++i)
+            {
+                AssertThat(output[i], Equals(Converters::toInteger<std::uint64_t>(values[i], lengths[i])));
+            }
+        });
     });
 });
 
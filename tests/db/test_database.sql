@@ -151,3 +151,10 @@ INSERT INTO `psquery_test` (`id`, `f_id`) VALUES
     (6, 2),
     (7, 1),
     (8, 3);
+
+DROP TABLE IF EXISTS `load_data`;
+CREATE TABLE `load_data` (
+    `id` INT(11) NOT NULL PRIMARY KEY,
+    `name` VARCHAR(100) NULL,
+    `value` DOUBLE NOT NULL
+) ENGINE=INNODB DEFAULT CHARSET=UTF8;
@@ -0,0 +1,199 @@
+/*
+ *  Author: Tomas Nozicka
+ */
+
+#include <cstdint>
+#include <string>
+#include <bandit/bandit.h>
+
+#include <superior_mysqlpp.hpp>
+#include <superior_mysqlpp/columnar_result.hpp>
+#include <superior_mysqlpp/arrow_export.hpp>
+
+#include "settings.hpp"
+
+using namespace bandit;
+using namespace snowhouse;
+using namespace SuperiorMySqlpp;
+
+
+go_bandit([](){
+    describe("Test columnar result", [&](){
+        auto& s = getSettingsRef();
+        Connection connection{s.database, s.user, s.password, s.host, s.port};
+
+        it("converts columns by field types", [&](){
+            auto query = connection.makeQuery(
+                "SELECT -5 AS `i`, CAST(7 AS UNSIGNED) AS `u`, 1.5e0 AS `d`, 'abc' AS `s`, NULL AS `n` "
+                "UNION ALL SELECT NULL, 18446744073709551615, NULL, '', NULL "
+                "UNION ALL SELECT 9223372036854775807, 0, -2.25e0, NULL, NULL"
+            );
+            query.execute();
+
+            ColumnarResult result{query.store()};
+            AssertThat(result.getRowsCount(), Equals(3u));
+            AssertThat(result.getColumnsCount(), Equals(5u));
+
+            auto& signedColumn = result.getColumn("i");
+            AssertThat(signedColumn.getType(), Equals(ColumnType::int64));
+            AssertThat(signedColumn.getNullCount(), Equals(1u));
+            AssertThat(signedColumn.isNull(1), IsTrue());
+            AssertThat(signedColumn.getInt64Values()[0], Equals(-5));
+            AssertThat(signedColumn.getInt64Values()[2], Equals(9223372036854775807LL));
+
+            auto& unsignedColumn = result[1];
+            AssertThat(unsignedColumn.getType(), Equals(ColumnType::uint64));
+            AssertThat(unsignedColumn.getUint64Values()[1], Equals(18446744073709551615ULL));
+
+            auto& doubleColumn = result.getColumn("d");
+            AssertThat(doubleColumn.getType(), Equals(ColumnType::float64));
+            AssertThat(doubleColumn.getDoubleValues()[0], Equals(1.5));
+            AssertThat(doubleColumn.getDoubleValues()[2], Equals(-2.25));
+            AssertThat(doubleColumn.getValidityBitmap()[0], Equals(0b101));
+
+            auto& stringColumn = result.getColumn("s");
+            AssertThat(stringColumn.getType(), Equals(ColumnType::string));
+            AssertThat(stringColumn.getString(0), Equals("abc"));
+            AssertThat(stringColumn.isNull(1), IsFalse());
+            AssertThat(stringColumn.getString(1).size(), Equals(0u));
+            AssertThat(stringColumn.isNull(2), IsTrue());
+            AssertThat(stringColumn.getOffsets().size(), Equals(4u));
+            AssertThat(stringColumn.getBytes(), Equals("abc"));
+
+            AssertThat(result.getColumn("n").getNullCount(), Equals(3u));
+            AssertThrows(LogicError, stringColumn.getInt64Values());
+            AssertThrows(OutOfRange, result.getColumn("x"));
+        });
+
+        it("converts many rows", [&](){
+            auto query = connection.makeQuery(
+                "SELECT a.id * 100 + b.id AS `id`, IF(b.id % 3 = 0, NULL, CONCAT('row', b.id)) AS `name` "
+                "FROM (SELECT 0 AS id UNION ALL SELECT 1 UNION ALL SELECT 2 UNION ALL SELECT 3) a "
+                "CROSS JOIN (SELECT 0 AS id UNION ALL SELECT 1 UNION ALL SELECT 2 UNION ALL SELECT 3 UNION ALL SELECT 4 "
+                "UNION ALL SELECT 5 UNION ALL SELECT 6 UNION ALL SELECT 7 UNION ALL SELECT 8 UNION ALL SELECT 9) b "
+                "ORDER BY `id`"
+            );
+            query.execute();
+
+            ColumnarResult result{query.store()};
+            AssertThat(result.getRowsCount(), Equals(40u));
+
+            auto& ids = result[0].getInt64Values();
+            auto& names = result[1];
+            AssertThat(names.getNullCount(), Equals(16u));
+            for (std::size_t i=0; i<result.getRowsCount(); ++i)
+            {
+                auto b = ids[i] % 100;
+                AssertThat(names.isNull(i), Equals(b % 3 == 0));
+                if (!names.isNull(i))
+                {
+                    AssertThat(names.getString(i), Equals("row" + std::to_string(b)));
+                }
+            }
+        });
+
+        it("exports Arrow C data interface", [&](){
+            auto query = connection.makeQuery(
+                "SELECT 1 AS `id`, 'ab' AS `name` UNION ALL SELECT NULL, 'c' UNION ALL SELECT 3, NULL"
+            );
+            query.execute();
+
+            ColumnarResult result{query.store()};
+            ArrowSchema schema;
+            ArrowArray array;
+            exportArrow(std::move(result), &schema, &array);
+            AssertThat(result.getColumnsCount(), Equals(0u));
+
+            AssertThat(std::string{schema.format}, Equals("+s"));
+            AssertThat(schema.n_children, Equals(2));
+            AssertThat(std::string{schema.children[0]->format}, Equals("l"));
+            AssertThat(std::string{schema.children[0]->name}, Equals("id"));
+            AssertThat(std::string{schema.children[1]->format}, Equals("U"));
+            AssertThat(std::string{schema.children[1]->name}, Equals("name"));
+
+            AssertThat(array.length, Equals(3));
+            AssertThat(array.n_children, Equals(2));
+            auto& ids = *array.children[0];
+            AssertThat(ids.null_count, Equals(1));
+            AssertThat(*static_cast<const std::uint8_t*>(ids.buffers[0]), Equals(0b101));
+            AssertThat(static_cast<const std::int64_t*>(ids.buffers[1])[2], Equals(3));
+
+            auto& names = *array.children[1];
+            AssertThat(names.n_buffers, Equals(3));
+            auto* offsets = static_cast<const std::int64_t*>(names.buffers[1]);
+            AssertThat(offsets[1], Equals(2));
+            AssertThat(offsets[3], Equals(3));
+            AssertThat(std::string(static_cast<const char*>(names.buffers[2]), 3), Equals("abc"));
+
+            array.release(&array);
+            schema.release(&schema);
+            AssertThat(array.release == nullptr, IsTrue());
+            AssertThat(schema.release == nullptr, IsTrue());
+        });
+
+        it("exports use result to Arrow while fetching", [&](){
+            auto query = connection.makeQuery(
+                "SELECT 1 AS `id`, 'ab' AS `name` UNION ALL SELECT NULL, 'c' UNION ALL SELECT 3, NULL"
+            );
+            query.execute();
+
+            auto result = query.use();
+            ArrowSchema schema;
+            ArrowArray array;
+            exportArrow(result, &schema, &array);
+
+            AssertThat(schema.n_children, Equals(2));
+            AssertThat(std::string{schema.children[0]->format}, Equals("l"));
+            AssertThat(std::string{schema.children[1]->name}, Equals("name"));
+
+            AssertThat(array.length, Equals(3));
+            auto& ids = *array.children[0];
+            AssertThat(ids.null_count, Equals(1));
+            AssertThat(static_cast<const std::int64_t*>(ids.buffers[1])[2], Equals(3));
+
+            auto& names = *array.children[1];
+            AssertThat(names.null_count, Equals(1));
+            auto* offsets = static_cast<const std::int64_t*>(names.buffers[1]);
+            AssertThat(offsets[3], Equals(3));
+            AssertThat(std::string(static_cast<const char*>(names.buffers[2]), 3), Equals("abc"));
+
+            array.release(&array);
+            schema.release(&schema);
+        });
+
+        it("exports prepared statement to Arrow while fetching", [&](){
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<Sql::BigInt, Nullable<Sql::String>, Sql::Date, Sql::Datetime>>(
+                "SELECT 1 AS `id`, 'ab' AS `name`, DATE('1970-01-02') AS `day`, TIMESTAMP('1970-01-02 00:00:01') AS `at` "
+                "UNION ALL SELECT 2, NULL, DATE('2000-03-01'), TIMESTAMP('2000-03-01 00:00:00')"
+            );
+            preparedStatement.execute();
+
+            ArrowSchema schema;
+            ArrowArray array;
+            exportArrow(preparedStatement, &schema, &array);
+
+            AssertThat(schema.n_children, Equals(4));
+            AssertThat(std::string{schema.children[0]->format}, Equals("l"));
+            AssertThat(std::string{schema.children[0]->name}, Equals("id"));
+            AssertThat(std::string{schema.children[1]->format}, Equals("U"));
+            AssertThat(std::string{schema.children[2]->format}, Equals("tdD"));
+            AssertThat(std::string{schema.children[3]->format}, Equals("tsu:"));
+
+            AssertThat(array.length, Equals(2));
+            AssertThat(static_cast<const std::int64_t*>(array.children[0]->buffers[1])[1], Equals(2));
+
+            auto& names = *array.children[1];
+            AssertThat(names.null_count, Equals(1));
+            AssertThat(*static_cast<const std::uint8_t*>(names.buffers[0]), Equals(0b01));
+            AssertThat(std::string(static_cast<const char*>(names.buffers[2]), 2), Equals("ab"));
+
+            auto* days = static_cast<const std::int32_t*>(array.children[2]->buffers[1]);
+            AssertThat(days[0], Equals(1));
+            AssertThat(days[1], Equals(11017));
+            AssertThat(static_cast<const std::int64_t*>(array.children[3]->buffers[1])[0], Equals(86401000000LL));
+
+            array.release(&array);
+            schema.release(&schema);
+        });
+    });
+});
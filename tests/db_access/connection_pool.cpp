@@ -10,6 +10,7 @@
 #include <bandit/bandit.h>
 
 #include <superior_mysqlpp.hpp>
+#include <superior_mysqlpp/statement_warm_up.hpp>
 
 #include "settings.hpp"
 #include "test_utils.hpp"
@@ -297,6 +298,39 @@ go_bandit([](){
             AssertThat(badConnection.tryPing(), IsFalse());
         });
 
+        it("can warm up statements on new connections", [&](){
+            using PreparedStatementType = PreparedStatement<ResultBindings<Sql::Int>, ParamBindings<int>>;
+            StatementWarmUp warmUp{};
+            warmUp.addStatement<PreparedStatementType>("SELECT ? + 1");
+            warmUp.addStatement<PreparedStatementType>("SELECT ? + 1 FROM `no_such_table`");
+
+            auto connectionPool = makeConnectionPool([&](){
+                return std::async(std::launch::async, [&](){ return std::make_shared<Connection>(s.database, s.user, s.password, s.host, s.port); });
+            });
+            connectionPool.setResourceInitializer(warmUp);
+            connectionPool.setMinSpare(2);
+            connectionPool.setMaxSpare(2);
+            connectionPool.startResourceCountKeeper();
+            waitForPoolState(connectionPool, 10s, 2u, 2u);
+            connectionPool.stopResourceCountKeeper();
+
+            auto statistics = warmUp.getStatistics();
+            AssertThat(statistics.connections, Equals(2u));
+            AssertThat(statistics.prepared, Equals(2u));
+            AssertThat(statistics.failed, Equals(2u));
+            AssertThat(statistics.lastError.empty(), IsFalse());
+            AssertThat(statistics.maxPrepareTime <= statistics.totalPrepareTime, IsTrue());
+
+            auto connection = connectionPool.get();
+            {
+                auto ps = connection->makeCachedPreparedStatement<ResultBindings<Sql::Int>>("SELECT ? + 1", 1);
+                ps->execute();
+                AssertThat(ps->fetch(), IsTrue());
+                AssertThat(std::get<0>(ps->getResult()), Equals(2));
+            }
+            AssertThat(connection->getStatementCache().getStatistics().hits, Equals(1u));
+        });
+
         it("can recover from restarting MySQL", [&](){
             auto&& standardLogger = DefaultLogger::getLoggerPtr();
             auto&& silentLogger = std::make_shared<Loggers::Base>();
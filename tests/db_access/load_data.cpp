@@ -0,0 +1,132 @@
+/*
+ *  Author: Tomas Nozicka
+ */
+
+#include <string>
+#include <stdexcept>
+#include <bandit/bandit.h>
+
+#include <superior_mysqlpp.hpp>
+
+#include "settings.hpp"
+
+using namespace bandit;
+using namespace snowhouse;
+using namespace SuperiorMySqlpp;
+using namespace std::string_literals;
+
+
+go_bandit([](){
+    describe("Test LOAD DATA stream", [&](){
+        auto& s = getSettingsRef();
+        // Local infile capability is negotiated while connecting
+        unsigned int enableLocalInfile = 1;
+        Connection connection{s.database, s.user, s.password, s.host, s.port,
+                              std::make_tuple(std::make_tuple(ConnectionOptions::localInfile, &enableLocalInfile))};
+
+        it("encodes rows as TSV", [&](){
+            LoadDataRowWriter writer{};
+            writer.writeRow(1, "tab\there"s, Nullable<std::string>{}, "\\N");
+            writer.writeRow(2, "new\nline\r"s, nullptr, "nul\0byte\x1a"s);
+            AssertThat(writer.getBuffer(), Equals("1\ttab\\there\t\\N\t\\\\N\n"
+                                                  "2\tnew\\nline\\r\t\\N\tnul\\0byte\\Z\n"s));
+        });
+
+        it("can load generated rows", [&](){
+            connection.makeQuery("DELETE FROM `load_data`").execute();
+
+            const std::string specialName{"ol'da\t\\\n\0\"x", 11};
+            int id = 0;
+            auto affectedRows = connection.loadDataStream("INTO TABLE `load_data` (`id`, `name`, `value`)",
+                [&](LoadDataRowWriter& writer){
+                    switch (id % 3)
+                    {
+                        case 0:
+                            writer.writeRow(id, specialName, id * 0.5);
+                            break;
+                        case 1:
+                            writer.writeRow(id, Nullable<std::string>{}, id * 0.5);
+                            break;
+                        default:
+                            writer.writeRow(id, "\\N", id * 0.5);
+                            break;
+                    }
+                    return ++id < 10000;
+                });
+            AssertThat(affectedRows, Equals(10000u));
+
+            auto query = connection.makeQuery("SELECT `id`, `name`, `value` FROM `load_data` ORDER BY `id`");
+            query.execute();
+            auto result = query.store();
+            AssertThat(result.getRowsCount(), Equals(10000u));
+
+            int expectedId = 0;
+            while (Row row = result.fetchRow())
+            {
+                AssertThat(row[0].to<int>(), Equals(expectedId));
+                AssertThat(row[2].to<double>(), Equals(expectedId * 0.5));
+                switch (expectedId % 3)
+                {
+                    case 0:
+                        AssertThat(row[1].getString(), Equals(specialName));
+                        break;
+                    case 1:
+                        AssertThat(row[1].isNull(), IsTrue());
+                        break;
+                    default:
+                        AssertThat(row[1].getString(), Equals("\\N"s));
+                        break;
+                }
+                ++expectedId;
+            }
+        });
+
+        it("can load data on fresh connection", [&](){
+            Connection freshConnection{s.database, s.user, s.password, s.host, s.port,
+                                       std::make_tuple(std::make_tuple(ConnectionOptions::localInfile, &enableLocalInfile))};
+            freshConnection.makeQuery("DELETE FROM `load_data`").execute();
+
+            int id = 0;
+            auto affectedRows = freshConnection.loadDataStream("INTO TABLE `load_data` (`id`, `name`, `value`)", [&](LoadDataRowWriter& writer){
+                writer.writeRow(id, "fresh"s, 1.5);
+                return ++id < 3;
+            });
+            AssertThat(affectedRows, Equals(3u));
+
+            auto query = freshConnection.makeQuery("SELECT COUNT(*) FROM `load_data` WHERE `name` = 'fresh'");
+            query.execute();
+            auto result = query.store();
+            AssertThat(result.fetchRow()[0].to<int>(), Equals(3));
+        });
+
+        it("rethrows generator's exception", [&](){
+            AssertThrows(std::out_of_range, connection.loadDataStream("INTO TABLE `load_data`", [&](LoadDataRowWriter&) -> bool {
+                throw std::out_of_range{"generator failed"};
+            }));
+        });
+
+        it("restores local infile option", [&](){
+            auto& driver = connection.detail_getDriver();
+            unsigned int localInfile = 0;
+            driver.setDriverOption(LowLevel::DBDriver::DriverOptions::localInfile, &localInfile);
+
+            connection.makeQuery("DELETE FROM `load_data`").execute();
+            auto affectedRows = connection.loadDataStream("INTO TABLE `load_data` (`id`, `name`, `value`)", [&](LoadDataRowWriter& writer){
+                writer.writeRow(1, "name"s, 0.5);
+                return false;
+            });
+            AssertThat(affectedRows, Equals(1u));
+
+            localInfile = 1;
+            driver.getDriverOption(LowLevel::DBDriver::DriverOptions::localInfile, &localInfile);
+            AssertThat(localInfile, Equals(0u));
+        });
+
+        it("refuses unterminated row", [&](){
+            AssertThrows(LogicError, connection.loadDataStream("INTO TABLE `load_data`", [&](LoadDataRowWriter& writer){
+                writer.writeField(1);
+                return false;
+            }));
+        });
+    });
+});
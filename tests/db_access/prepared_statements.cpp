@@ -2,12 +2,17 @@
  *  Author: Tomas Nozicka
  */
 
+#include <atomic>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <tuple>
+#include <vector>
 #include <bandit/bandit.h>
 
 #include <superior_mysqlpp.hpp>
 #include <superior_mysqlpp/extras/prepared_statement_utils.hpp>
+#include <superior_mysqlpp/parallel_for_each_row.hpp>
 
 #include "settings.hpp"
 
@@ -18,6 +23,14 @@ using namespace SuperiorMySqlpp;
 using namespace std::string_literals;
 
 
+struct StructUser
+{
+    int id;
+    Nullable<StringData> name;
+
+    SUPERIOR_MYSQLPP_MEMBERS(id, name)
+};
+
 
 template<ValidateMetadataMode validateMode, typename T, bool debug=false>
 bool testColumnType(Connection& connection, const std::string& column)
@@ -119,6 +132,23 @@ go_bandit([](){
             }
         });
 
+        it("can process result in parallel", [&](){
+            WorkerPool pool{3};
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<int>>(
+                    "SELECT `id` FROM `test_superior_sqlpp`.`xuser` ORDER BY `id`"
+            );
+
+            preparedStatement.execute();
+            std::atomic<int> sum{0};
+            parallelForEachRow(pool, preparedStatement, [&](int id){ sum += id; }, 4);
+            AssertThat(sum.load(), Equals(11+12+13+14+15+16));
+
+            preparedStatement.execute();
+            std::vector<int> ids{};
+            parallelForEachRow(pool, preparedStatement, [](int id){ return id * 2; }, 4, [&](int value){ ids.push_back(value); });
+            AssertThat(ids, Equals(std::vector<int>{22, 24, 26, 28, 30, 32}));
+        });
+
         it("can bind strings", [&](){
             auto preparedStatement = connection.makePreparedStatement<ResultBindings<int, Nullable<StringDataBase<42>>>>(
                 "SELECT `id`, CAST(`name` as CHAR) FROM `test_superior_sqlpp`.`xuser` WHERE `id`=? AND `name`=? AND `name`=? AND `name`=? AND `name`=?",
@@ -285,6 +315,99 @@ go_bandit([](){
             AssertThat(sname->getString(), Equals(""));
         });
 
+        it("can change string arguments in place without updating bindings", [&](){
+            {
+                auto&& preparedStatement = connection.makePreparedStatement(
+                    "INSERT INTO `test_superior_sqlpp`.`xuser` (`id`, `name`) VALUES (?, ?)",
+                    145, StringData{"Kokot"}
+                );
+                preparedStatement.execute();
+
+                // StringData keeps its length in place, so the new values are just stored
+                preparedStatement.setParams(146, StringData{"aaaaaaaaaa"});
+                preparedStatement.execute();
+
+                std::get<0>(preparedStatement.getParams()) = 147;
+                std::get<1>(preparedStatement.getParams()) = StringData{"b"};
+                // Statement is bound again after move, because its params storage moved
+                auto movedStatement = std::move(preparedStatement);
+                movedStatement.execute();
+            }
+
+            auto&& preparedStatement = connection.makePreparedStatement<ResultBindings<int, Nullable<StringDataBase<42>>>>(
+                "SELECT `id`, `name` FROM `test_superior_sqlpp`.`xuser` WHERE `id` IN (145, 146, 147) ORDER BY `id` ASC"
+            );
+            preparedStatement.execute();
+
+            int id;
+            Nullable<StringDataBase<42>> sname;
+
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            std::tie(id, sname) = preparedStatement.getResult();
+            AssertThat(id, Equals(145));
+            AssertThat(sname->getString(), Equals("Kokot"));
+
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            std::tie(id, sname) = preparedStatement.getResult();
+            AssertThat(id, Equals(146));
+            AssertThat(sname->getString(), Equals("aaaaaaaaaa"));
+
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            std::tie(id, sname) = preparedStatement.getResult();
+            AssertThat(id, Equals(147));
+            AssertThat(sname->getString(), Equals("b"));
+
+            AssertThat(preparedStatement.fetch(), IsFalse());
+        });
+
+        it("can execute statement for many params at once", [&](){
+            {
+                auto preparedStatement = PreparedStatement<ResultBindings<>, ParamBindings<int, Nullable<StringData>>>(
+                    connection,
+                    "INSERT INTO `test_superior_sqlpp`.`user_nullable` VALUES (?, ?)"
+                );
+
+                std::vector<std::tuple<int, Nullable<StringData>>> rows{};
+                for (int id=1001; id<=1005; ++id)
+                {
+                    rows.emplace_back(id, id%2? Nullable<StringData>{inPlace, std::to_string(id)} : Nullable<StringData>{});
+                }
+                AssertThat(preparedStatement.executeBulk(rows, 2), Equals(5u));
+                AssertThat(preparedStatement.executeBulk(std::vector<std::tuple<int, Nullable<StringData>>>{}), Equals(0u));
+                AssertThrows(LogicError, preparedStatement.executeBulk(rows, 0));
+
+                // Statement can still be executed with its own params
+                preparedStatement.setParams(1006, Nullable<StringData>{inPlace, "last"});
+                preparedStatement.updateParamsBindings();
+                preparedStatement.execute();
+            }
+
+            auto&& preparedStatement = connection.makePreparedStatement<ResultBindings<int, Nullable<StringData>>>(
+                "SELECT `id`, `nullable_name` FROM `test_superior_sqlpp`.`user_nullable` WHERE `id` BETWEEN 1001 AND 1006 ORDER BY `id` ASC"
+            );
+            preparedStatement.execute();
+
+            int id;
+            Nullable<StringData> name{};
+            for (int expectedId=1001; expectedId<=1005; ++expectedId)
+            {
+                AssertThat(preparedStatement.fetch(), IsTrue());
+                std::tie(id, name) = preparedStatement.getResult();
+                AssertThat(id, Equals(expectedId));
+                AssertThat(name.isValid(), Equals(expectedId%2 == 1));
+                if (name.isValid())
+                {
+                    AssertThat(name->getString(), Equals(std::to_string(expectedId)));
+                }
+            }
+
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            std::tie(id, name) = preparedStatement.getResult();
+            AssertThat(id, Equals(1006));
+            AssertThat(name->getString(), Equals("last"));
+            AssertThat(preparedStatement.fetch(), IsFalse());
+        });
+
         it("can get and set prefetch row count", [&](){
             auto preparedStatement = connection.makePreparedStatement<ResultBindings<int, Nullable<StringData>>, false>(
                 "SELECT `id`, CAST(`name` as CHAR) FROM `test_superior_sqlpp`.`xuser` WHERE `id`=? AND `name`=? AND `name`=? AND `name`=? AND `name`=?",
@@ -326,6 +449,83 @@ go_bandit([](){
             AssertThat(count, Equals(1));
         });
 
+        it("can fetch rows through server-side cursor", [&](){
+            {
+                auto preparedStatement = connection.makePreparedStatement(
+                    "INSERT INTO `test_superior_sqlpp`.`user_nullable` VALUES (?, NULL)", 0
+                );
+                std::vector<std::tuple<int>> rows{};
+                for (int id=2001; id<=2100; ++id)
+                {
+                    rows.emplace_back(id);
+                }
+                preparedStatement.executeBulk(rows);
+            }
+
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<int>, false, ValidateMetadataMode::ArithmeticPromotions,
+                                                                      ValidateMetadataMode::Same, false, CursorMode::ReadOnly>(
+                "SELECT `id` FROM `test_superior_sqlpp`.`user_nullable` WHERE `id` BETWEEN ? AND ? ORDER BY `id` ASC", 2001, 2100
+            );
+            AssertThat(preparedStatement.getPrefetchRowCount(), Equals(detail::PreparedStatementsDefault::getCursorPrefetchRowCount()));
+            preparedStatement.setPrefetchRowCount(7);
+
+            // Cursor is closed before all rows are read
+            preparedStatement.execute();
+            for (int id=2001; id<=2003; ++id)
+            {
+                AssertThat(preparedStatement.fetch(), IsTrue());
+                AssertThat(std::get<0>(preparedStatement.getResult()), Equals(id));
+            }
+            preparedStatement.freeResult();
+
+            preparedStatement.execute();
+            int expectedId = 2001;
+            while (preparedStatement.fetch())
+            {
+                AssertThat(std::get<0>(preparedStatement.getResult()), Equals(expectedId));
+                ++expectedId;
+            }
+            AssertThat(expectedId, Equals(2101));
+
+            // Other statements can be executed while cursor is open
+            preparedStatement.execute();
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            int one = 0;
+            psReadValues("SELECT 1", connection, one);
+            AssertThat(one, Equals(1));
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            AssertThat(std::get<0>(preparedStatement.getResult()), Equals(2002));
+        });
+
+        it("revalidates result when server signals metadata change", [&](){
+            connection.makeQuery("CREATE TEMPORARY TABLE `test_superior_sqlpp`.`metadata_change` (`value` INT NOT NULL)").execute();
+            connection.makeQuery("INSERT INTO `test_superior_sqlpp`.`metadata_change` VALUES (42)").execute();
+
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<Sql::Int>>(
+                "SELECT * FROM `test_superior_sqlpp`.`metadata_change`"
+            );
+            for (int i=0; i<3; ++i)
+            {
+                preparedStatement.execute();
+                AssertThat(preparedStatement.fetch(), IsTrue());
+                AssertThat(std::get<0>(preparedStatement.getResult()), Equals(42));
+            }
+
+            connection.makeQuery("ALTER TABLE `test_superior_sqlpp`.`metadata_change` MODIFY `value` VARCHAR(10) NOT NULL").execute();
+            AssertThrows(PreparedStatementTypeError, preparedStatement.execute());
+
+            connection.makeQuery("ALTER TABLE `test_superior_sqlpp`.`metadata_change` MODIFY `value` INT NOT NULL").execute();
+            preparedStatement.execute();
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            AssertThat(std::get<0>(preparedStatement.getResult()), Equals(42));
+
+            // Client library itself refuses changed number of columns
+            connection.makeQuery("ALTER TABLE `test_superior_sqlpp`.`metadata_change` ADD `other` INT NULL").execute();
+            AssertThrows(SuperiorMySqlppError, preparedStatement.execute());
+
+            connection.makeQuery("DROP TEMPORARY TABLE `test_superior_sqlpp`.`metadata_change`").execute();
+        });
+
         it("can validate metadata", [&](){
             AssertThat((testInt32<ValidateMetadataMode::Strict, signed char>(connection)), IsFalse());
             AssertThat((testInt32<ValidateMetadataMode::Strict, short int>(connection)), IsFalse());
@@ -385,6 +585,12 @@ go_bandit([](){
             AssertThat((testUInt32<ValidateMetadataMode::ArithmeticConversions, unsigned long long>(connection)), IsTrue());
         });
 
+        it("checks result fields count without result bindings", [&](){
+            auto preparedStatement = connection.makePreparedStatement("SELECT 1");
+            AssertThrows(PreparedStatementTypeError, preparedStatement.execute());
+            AssertThrows(PreparedStatementTypeError, preparedStatement.execute());
+        });
+
         it("can validate metadata with nullable", [&](){
             {
                 auto preparedStatement = connection.makePreparedStatement<ResultBindings<int>, true, ValidateMetadataMode::Strict, ValidateMetadataMode::Disabled>(
@@ -441,6 +647,189 @@ go_bandit([](){
             }
         });
 
+        it("can fetch long values into growable storage", [&](){
+            std::string buffer{};
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<Nullable<GrowableStringData>, Nullable<GrowableBlobData>>>(
+                "SELECT REPEAT('a', ?), CAST(REPEAT(?, 3) AS BINARY)",
+                fullInitTag,
+                std::forward_as_tuple(Nullable<GrowableStringData>{inPlace, buffer}, Nullable<GrowableBlobData>{}),
+                std::forward_as_tuple(10, std::string{"b"})
+            );
+
+            for (auto length: {10, 5000, 1, 100000, 0})
+            {
+                std::string blobPart(static_cast<std::size_t>(length), 'b');
+                preparedStatement.setParams(length, blobPart);
+                preparedStatement.updateParamsBindings();
+                preparedStatement.execute();
+
+                AssertThat(preparedStatement.fetch(), IsTrue());
+                auto& string = std::get<0>(preparedStatement.getResult());
+                auto& blob = std::get<1>(preparedStatement.getResult());
+                AssertThat(string.isValid(), IsTrue());
+                AssertThat(string->size(), Equals(static_cast<std::size_t>(length)));
+                AssertThat(string->getString(), Equals(std::string(static_cast<std::size_t>(length), 'a')));
+                // Value is fetched directly into caller's buffer
+                AssertThat(std::string(buffer.data(), string->size()), Equals(string->getString()));
+                AssertThat(blob->getString(), Equals(blobPart + blobPart + blobPart));
+
+                AssertThat(preparedStatement.fetch(), IsFalse());
+            }
+        });
+
+        it("can fetch long values into caller's buffer with spare capacity", [&](){
+            // Buffer grows in place, so its address doesn't change
+            std::string buffer{};
+            buffer.reserve(1 << 20);
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<Nullable<GrowableStringData>>>(
+                "SELECT `v` FROM ("
+                "SELECT 1 AS `k`, REPEAT('p', 3000) AS `v` UNION ALL SELECT 2, REPEAT('q', 3000) UNION ALL "
+                "SELECT 3, 's' UNION ALL SELECT 4, REPEAT('r', 5000)) AS `t` ORDER BY `k`",
+                fullInitTag,
+                std::forward_as_tuple(Nullable<GrowableStringData>{inPlace, buffer}),
+                std::forward_as_tuple()
+            );
+            preparedStatement.execute();
+
+            for (auto&& expected: {std::string(3000, 'p'), std::string(3000, 'q'), std::string{"s"}, std::string(5000, 'r')})
+            {
+                AssertThat(preparedStatement.fetch(), IsTrue());
+                AssertThat(std::get<0>(preparedStatement.getResult())->getString(), Equals(expected));
+            }
+            AssertThat(preparedStatement.fetch(), IsFalse());
+        });
+
+        it("can read blob in chunks", [&](){
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<Nullable<BlobStream>, Sql::BigInt>>(
+                "SELECT CAST(REPEAT(?, ?) AS BINARY), 42",
+                std::string{"0123456789"}, 20000
+            );
+            preparedStatement.execute();
+
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            auto& stream = std::get<0>(preparedStatement.getResult());
+            AssertThat(stream.isValid(), IsTrue());
+            AssertThat(stream->size(), Equals(200000u));
+            AssertThat(std::get<1>(preparedStatement.getResult()), Equals(42));
+
+            std::string value{};
+            std::size_t chunksCount = 0;
+            stream->readChunks([&](StringView chunk){
+                AssertThat(chunk.size() <= 4096u, IsTrue());
+                value.append(chunk.data(), chunk.size());
+                ++chunksCount;
+            }, 4096);
+            AssertThat(chunksCount, Equals(49u));
+            AssertThat(stream->remaining(), Equals(0u));
+
+            std::string expected{};
+            for (auto i=0; i<20000; ++i)
+            {
+                expected += "0123456789";
+            }
+            AssertThat(value == expected, IsTrue());
+            AssertThat(preparedStatement.fetch(), IsFalse());
+
+            preparedStatement.setParams(std::string{"abc"}, 2);
+            preparedStatement.updateParamsBindings();
+            preparedStatement.execute();
+
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            BlobStreamBuffer buffer{*std::get<0>(preparedStatement.getResult()), 4};
+            std::istream input{&buffer};
+            std::string word{};
+            input >> word;
+            AssertThat(word, Equals("abcabc"));
+            AssertThat(preparedStatement.fetch(), IsFalse());
+        });
+
+        it("can stream long data params", [&](){
+            std::string expected{};
+            for (auto i=0; i<20000; ++i)
+            {
+                expected += "0123456789";
+            }
+            std::istringstream input{expected};
+
+            auto preparedStatement = connection.makePreparedStatement<ResultBindings<Nullable<GrowableBlobData>>>(
+                "SELECT CAST(? AS BINARY)",
+                Nullable<LongDataSource>{LongDataSource::fromStream(input, 4096)}
+            );
+            preparedStatement.execute();
+
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            auto& value = std::get<0>(preparedStatement.getResult());
+            AssertThat(value.isValid(), IsTrue());
+            AssertThat(value->size(), Equals(200000u));
+            AssertThat(value->getString() == expected, IsTrue());
+            AssertThat(preparedStatement.fetch(), IsFalse());
+
+            std::vector<char> bytes{'a', 'b', 'c'};
+            preparedStatement.setParams(Nullable<LongDataSource>{LongDataSource::fromRange(bytes.begin(), bytes.end(), 2)});
+            preparedStatement.execute();
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            AssertThat(std::get<0>(preparedStatement.getResult())->getString(), Equals("abc"));
+            AssertThat(preparedStatement.fetch(), IsFalse());
+
+            // Source was consumed by previous execution
+            preparedStatement.execute();
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            AssertThat(std::get<0>(preparedStatement.getResult())->getString(), Equals(""));
+            AssertThat(preparedStatement.fetch(), IsFalse());
+
+            preparedStatement.setParams(Nullable<LongDataSource>{});
+            preparedStatement.updateParamsBindings();
+            preparedStatement.execute();
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            AssertThat(std::get<0>(preparedStatement.getResult()).isValid(), IsFalse());
+            AssertThat(preparedStatement.fetch(), IsFalse());
+        });
+
+        it("can map structs to params and result", [&](){
+            {
+                PreparedStatement<ResultBindings<>, StructParamBindings<StructUser>> preparedStatement{
+                    connection,
+                    "INSERT INTO `test_superior_sqlpp`.`user_nullable` VALUES (?, ?)"
+                };
+
+                std::vector<StructUser> users{};
+                users.push_back({1011, Nullable<StringData>{inPlace, "first"}});
+                users.push_back({1012, Nullable<StringData>{}});
+                AssertThat(preparedStatement.executeBulk(users), Equals(2u));
+
+                preparedStatement.setParamsFrom(StructUser{1013, Nullable<StringData>{inPlace, "last"}});
+                preparedStatement.updateParamsBindings();
+                preparedStatement.execute();
+            }
+
+            PreparedStatement<StructResultBindings<StructUser>, ParamBindings<>> preparedStatement{
+                connection,
+                "SELECT `id`, `nullable_name` FROM `test_superior_sqlpp`.`user_nullable` WHERE `id` BETWEEN 1011 AND 1013 ORDER BY `id` ASC"
+            };
+            preparedStatement.execute();
+
+            std::vector<StructUser> users{};
+            AssertThat(preparedStatement.fetchAllInto(users), Equals(3u));
+            AssertThat(users.size(), Equals(3u));
+            AssertThat(users[0].id, Equals(1011));
+            AssertThat(users[0].name->getString(), Equals("first"));
+            AssertThat(users[1].id, Equals(1012));
+            AssertThat(users[1].name.isValid(), IsFalse());
+            AssertThat(users[2].id, Equals(1013));
+            AssertThat(users[2].name->getString(), Equals("last"));
+
+            // Result storage of statement can still be used
+            preparedStatement.execute();
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            AssertThat(std::get<0>(preparedStatement.getResult()), Equals(1011));
+            StructUser user{};
+            AssertThat(preparedStatement.fetchInto(user), IsTrue());
+            AssertThat(user.id, Equals(1012));
+            AssertThat(preparedStatement.fetch(), IsTrue());
+            AssertThat(std::get<0>(preparedStatement.getResult()), Equals(1013));
+            AssertThat(preparedStatement.fetchInto(user), IsFalse());
+        });
+
         it("can work with decimal", [&](){
             {
                 auto preparedStatement = connection.makePreparedStatement(
@@ -660,6 +1049,82 @@ go_bandit([](){
             AssertThat(ids[3].size(), Equals(1UL));
         });
     });
+
+    describe("Test statement cache", [&](){
+        auto& s = getSettingsRef();
+        Connection connection{s.database, s.user, s.password, s.host, s.port};
+        auto& cache = connection.getStatementCache();
+
+        it("reuses cached statements", [&](){
+            cache.setCapacity(4);
+            std::uint_fast64_t statementId = 0;
+            {
+                auto ps = connection.makeCachedPreparedStatement<ResultBindings<Sql::Int>>("SELECT ? + 1", 1);
+                ps->execute();
+                AssertThat(ps->fetch(), IsTrue());
+                AssertThat(std::get<0>(ps->getResult()), Equals(2));
+                statementId = ps->detail_getStatementRef().getId();
+            }
+            {
+                auto ps = connection.makeCachedPreparedStatement<ResultBindings<Sql::Int>>("SELECT ? + 1", 5);
+                AssertThat(ps->detail_getStatementRef().getId(), Equals(statementId));
+                ps->execute();
+                AssertThat(ps->fetch(), IsTrue());
+                AssertThat(std::get<0>(ps->getResult()), Equals(6));
+            }
+            {
+                // Different bindings make different statement
+                auto ps = connection.makeCachedPreparedStatement<ResultBindings<Sql::BigInt>>("SELECT ? + 1", Sql::BigInt{1});
+                AssertThat(ps->detail_getStatementRef().getId(), !Equals(statementId));
+            }
+
+            auto statistics = cache.getStatistics();
+            AssertThat(statistics.hits, Equals(1u));
+            AssertThat(statistics.misses, Equals(2u));
+            AssertThat(statistics.statementsCount, Equals(2u));
+        });
+
+        it("keeps one of concurrently checked out statements", [&](){
+            cache.clear();
+            {
+                auto first = connection.makeCachedPreparedStatement<ResultBindings<Sql::Int>>("SELECT ?", 1);
+                auto second = connection.makeCachedPreparedStatement<ResultBindings<Sql::Int>>("SELECT ?", 2);
+                AssertThat(first->detail_getStatementRef().getId(), !Equals(second->detail_getStatementRef().getId()));
+            }
+            AssertThat(cache.getStatistics().statementsCount, Equals(1u));
+        });
+
+        it("evicts least recently used statements", [&](){
+            cache.clear();
+            cache.setCapacity(2);
+            auto evictions = cache.getStatistics().evictions;
+            for (auto&& query: {"SELECT 1", "SELECT 2", "SELECT 3"})
+            {
+                connection.makeCachedPreparedStatement<ResultBindings<Sql::Int>>(query);
+            }
+            AssertThat(cache.getStatistics().statementsCount, Equals(2u));
+            AssertThat(cache.getStatistics().evictions, Equals(evictions + 1));
+
+            cache.setCapacity(0);
+            AssertThat(cache.getStatistics().statementsCount, Equals(0u));
+        });
+
+        it("invalidates statements when user is changed", [&](){
+            cache.setCapacity(4);
+            int value = 0;
+            psReadValues("SELECT 1", connection, value);
+            AssertThat(cache.getStatistics().statementsCount, Equals(1u));
+
+            connection.changeUser(s.user.c_str(), s.password.c_str(), s.database.c_str());
+            AssertThat(cache.getStatistics().statementsCount, Equals(0u));
+
+            auto hits = cache.getStatistics().hits;
+            psReadValues("SELECT 1", connection, value);
+            psReadValues("SELECT 1", connection, value);
+            AssertThat(value, Equals(1));
+            AssertThat(cache.getStatistics().hits, Equals(hits + 1));
+        });
+    });
 });
 
 
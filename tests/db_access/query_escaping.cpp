@@ -3,6 +3,9 @@
  */
 
 #include <string>
+#include <limits>
+#include <cstdint>
+#include <random>
 #include <bandit/bandit.h>
 
 #include <superior_mysqlpp.hpp>
@@ -12,6 +15,7 @@
 using namespace bandit;
 using namespace snowhouse;
 using namespace SuperiorMySqlpp;
+using namespace std::string_literals;
 
 
 go_bandit([](){
@@ -63,6 +67,76 @@ go_bandit([](){
                 query << "XXX " << quote << R"(ol'd\a)" << " ol'da";
                 AssertThat(query.getQueryString(), Equals(R"(XXX 'ol\'d\\a' ol'da)"));
             }
+            {
+                auto query = connection.makeQuery();
+                query << "XXX " << quote << StringView{"ol'da"} << " " << StringView{"ol'da"};
+                AssertThat(query.getQueryString(), Equals(R"(XXX 'ol\'da' ol'da)"));
+            }
+        });
+
+        it("escapes the same way as C API", [&](){
+            auto& driver = connection.detail_getDriver();
+            // Special characters, valid and malformed UTF-8 sequences
+            const char alphabetData[] = "ab \0\n\r\\'\"\x1a\x80\xbf\xc2\xc3\xa9\xe0\xa0\xed\xa0\xf0\x9f\x98\x80\xf4\x90\xff";
+            const std::string alphabet{alphabetData, sizeof(alphabetData) - 1};
+            std::mt19937 generator{42};
+            for (auto charset: {"utf8mb4", "utf8", "latin1"})
+            {
+                std::string charsetName{charset};
+                driver.setCharacterSet(&charsetName.front());
+                for (int i=0; i<10000; ++i)
+                {
+                    std::string original(generator() % 100, '\0');
+                    for (auto&& c: original)
+                    {
+                        c = alphabet[generator() % alphabet.size()];
+                    }
+
+                    std::string expected(original.size()*2 + 1, '\0');
+                    expected.resize(mysql_real_escape_string(driver.detail_getMysqlPtr(), &expected.front(), original.data(), original.size()));
+                    AssertThat(connection.escapeString(original), Equals(expected));
+                }
+            }
+            std::string charsetName{"utf8mb4"};
+            driver.setCharacterSet(&charsetName.front());
+        });
+
+        it("respects NO_BACKSLASH_ESCAPES", [&](){
+            connection.makeQuery("SET @previous_sql_mode = @@SESSION.sql_mode, SESSION sql_mode = 'NO_BACKSLASH_ESCAPES'").execute();
+            AssertThat(connection.escapeString("ol'd\\a"), Equals("ol''d\\a"s));
+            connection.makeQuery("SET SESSION sql_mode = @previous_sql_mode").execute();
+            AssertThat(connection.escapeString("ol'd\\a"), Equals("ol\\'d\\\\a"s));
+        });
+
+        it("works for extreme numbers", [&](){
+            auto query = connection.makeQuery();
+            query << std::numeric_limits<std::int64_t>::min() << " " << std::numeric_limits<std::uint64_t>::max()
+                  << " " << -1.5 << " " << 1e300;
+            AssertThat(query.getQueryString(), Equals("-9223372036854775808 18446744073709551615 -1.5 1e300"));
+        });
+
+        it("can reuse query buffer", [&](){
+            std::string buffer{};
+            buffer.reserve(128);
+            auto bufferPtr = buffer.data();
+            for (int i=0; i<3; ++i)
+            {
+                buffer.clear();
+                auto query = connection.makeQuery(std::move(buffer));
+                query << "SELECT " << i << ", " << quote << "ol'da";
+                AssertThat(query.getQueryString(), Equals("SELECT " + std::to_string(i) + R"(, 'ol\'da')"));
+                buffer = query.releaseBuffer();
+                AssertThat(static_cast<const void*>(buffer.data()), Equals(static_cast<const void*>(bufferPtr)));
+            }
+
+            auto query = connection.makeQuery("SELECT 1");
+            query.execute();
+            query.store();
+            query.clear();
+            query << "SELECT " << 2;
+            query.execute();
+            auto result = query.store();
+            AssertThat(result.fetchRow()[0].to<int>(), Equals(2));
         });
     });
 });
@@ -0,0 +1,224 @@
+/*
+ *  Author: Tomas Nozicka
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <bandit/bandit.h>
+
+#include <superior_mysqlpp.hpp>
+#include <superior_mysqlpp/query_result_cache.hpp>
+
+#include "settings.hpp"
+
+using namespace bandit;
+using namespace snowhouse;
+using namespace SuperiorMySqlpp;
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+
+
+go_bandit([](){
+    describe("Test query result cache", [&](){
+        it("normalizes query text", [&](){
+            AssertThat(normalizeQueryText("  SELECT\n\t*   FROM `a  b`  WHERE x='  \\'  '  "),
+                       Equals("SELECT * FROM `a  b` WHERE x='  \\'  '"));
+            AssertThat(normalizeQueryText("SELECT \"a  \\\"  b\"   ,1"), Equals("SELECT \"a  \\\"  b\" ,1"));
+            AssertThat(makeQueryCacheKey("SELECT  1"), Equals(makeQueryCacheKey("\nSELECT 1 ")));
+
+            // Newline ending line comment must be kept, the rest of query is not commented out
+            AssertThat(normalizeQueryText("SELECT 1 -- a  'b\n  ,2 # c\r\n\t, 3--4"),
+                       Equals("SELECT 1 -- a  'b\n,2 # c\r\n, 3--4"));
+            AssertThat(normalizeQueryText("SELECT /* a\n  ' */  1"), Equals("SELECT /* a\n  ' */ 1"));
+            AssertThat(normalizeQueryText("SELECT 1 -- a\n"), Equals("SELECT 1 -- a"));
+            AssertThat(makeQueryCacheKey("SELECT 1 -- a\n, 2"), !Equals(makeQueryCacheKey("SELECT 1 -- a , 2")));
+
+            using Bindings = ResultBindings<int>;
+            AssertThat(makePsQueryCacheKey<Bindings>("SELECT ?", 1, std::string{"a"}),
+                       !Equals(makePsQueryCacheKey<Bindings>("SELECT ?", 1, std::string{"a"}, std::string{})));
+            AssertThat(makePsQueryCacheKey<Bindings>("SELECT ?", std::string{"ab"}, std::string{"c"}),
+                       !Equals(makePsQueryCacheKey<Bindings>("SELECT ?", std::string{"a"}, std::string{"bc"})));
+            AssertThat(makePsQueryCacheKey<Bindings>("SELECT ?", Nullable<int>{}),
+                       !Equals(makePsQueryCacheKey<Bindings>("SELECT ?", Nullable<int>{0})));
+            AssertThat(makePsQueryCacheKey<Bindings>("SELECT ?", Date{2015, 12, 31}),
+                       Equals(makePsQueryCacheKey<Bindings>("SELECT  ?", Date{2015, 12, 31})));
+        });
+
+        it("caches values until they expire", [&](){
+            QueryResultCache cache{1024, 1h};
+            int loads = 0;
+            auto load = [&](){ return ++loads; };
+
+            AssertThat(*cache.getOrLoad<int>("a", {}, {}, load), Equals(1));
+            AssertThat(*cache.getOrLoad<int>("a", {}, {}, load), Equals(1));
+            AssertThat(*cache.getOrLoad<int>("b", {}, 1ns, load), Equals(2));
+            std::this_thread::sleep_for(1ms);
+            AssertThat(*cache.getOrLoad<int>("b", {}, 1ns, load), Equals(3));
+            AssertThrows(LogicError, cache.getOrLoad<long>("a", {}, {}, [](){ return 0l; }));
+
+            auto statistics = cache.getStatistics();
+            AssertThat(statistics.hits, Equals(1u));
+            AssertThat(statistics.misses, Equals(3u));
+            AssertThat(statistics.expirations, Equals(1u));
+            AssertThat(statistics.entriesCount, Equals(2u));
+            AssertThat(statistics.bytes, Equals(2 * sizeof(int)));
+        });
+
+        it("evicts least recently used values", [&](){
+            QueryResultCache cache{3 * sizeof(int), 1h};
+            int loads = 0;
+            auto load = [&](){ return ++loads; };
+
+            cache.getOrLoad<int>("a", {}, {}, load);
+            cache.getOrLoad<int>("b", {}, {}, load);
+            cache.getOrLoad<int>("c", {}, {}, load);
+            cache.getOrLoad<int>("a", {}, {}, load);
+            cache.getOrLoad<int>("d", {}, {}, load);
+            AssertThat(loads, Equals(4));
+            AssertThat(cache.getStatistics().evictions, Equals(1u));
+
+            // "b" was evicted, "a" was used recently
+            AssertThat(*cache.getOrLoad<int>("a", {}, {}, load), Equals(1));
+            AssertThat(*cache.getOrLoad<int>("b", {}, {}, load), Equals(5));
+
+            // Value larger than the cache is returned, but not cached
+            auto vector = cache.getOrLoad<std::vector<int>>("e", {}, {}, [](){ return std::vector<int>(10); });
+            AssertThat(vector->size(), Equals(10u));
+            AssertThat(cache.getStatistics().entriesCount, Equals(3u));
+        });
+
+        it("invalidates values by key and tag", [&](){
+            QueryResultCache cache{1024, 1h};
+            int loads = 0;
+            auto load = [&](){ return ++loads; };
+
+            cache.getOrLoad<int>("a", {"users"}, {}, load);
+            cache.getOrLoad<int>("b", {"users", "groups"}, {}, load);
+            cache.getOrLoad<int>("c", {"groups"}, {}, load);
+
+            AssertThat(cache.invalidateTag("users"), Equals(2u));
+            AssertThat(cache.invalidateTag("users"), Equals(0u));
+            AssertThat(cache.invalidate("c"), IsTrue());
+            AssertThat(cache.invalidate("c"), IsFalse());
+            AssertThat(cache.getStatistics().entriesCount, Equals(0u));
+            AssertThat(cache.invalidateTag("groups"), Equals(0u));
+
+            cache.getOrLoad<int>("a", {"users"}, {}, load);
+            cache.clear();
+            AssertThat(*cache.getOrLoad<int>("a", {"users"}, {}, load), Equals(5));
+            AssertThat(cache.getStatistics().invalidations, Equals(4u));
+        });
+
+        it("loads concurrently missed values once", [&](){
+            QueryResultCache cache{1024, 1h};
+            std::atomic<int> loads{0};
+            std::promise<void> release{};
+            auto released = release.get_future().share();
+
+            std::vector<std::future<int>> results{};
+            for (int i=0; i<4; ++i)
+            {
+                results.push_back(std::async(std::launch::async, [&](){
+                    return *cache.getOrLoad<int>("a", {}, {}, [&](){
+                        released.wait();
+                        return ++loads;
+                    });
+                }));
+            }
+            while (cache.getStatistics().misses < 4)
+            {
+                std::this_thread::yield();
+            }
+            release.set_value();
+
+            for (auto&& result: results)
+            {
+                AssertThat(result.get(), Equals(1));
+            }
+            AssertThat(loads.load(), Equals(1));
+            AssertThat(cache.getStatistics().coalescedMisses, Equals(3u));
+        });
+
+        it("does not join loads started before invalidation", [&](){
+            QueryResultCache cache{1024, 1h};
+            std::promise<void> release{};
+            auto released = release.get_future().share();
+
+            auto stale = std::async(std::launch::async, [&](){
+                return *cache.getOrLoad<int>("a", {}, {}, [&](){
+                    released.wait();
+                    return 1;
+                });
+            });
+            while (cache.getStatistics().misses < 1)
+            {
+                std::this_thread::yield();
+            }
+
+            cache.invalidate("a");
+            AssertThat(*cache.getOrLoad<int>("a", {}, {}, [](){ return 2; }), Equals(2));
+            release.set_value();
+            AssertThat(stale.get(), Equals(1));
+
+            AssertThat(*cache.getOrLoad<int>("a", {}, {}, [](){ return 3; }), Equals(2));
+            AssertThat(cache.getStatistics().coalescedMisses, Equals(0u));
+        });
+
+        it("does not cache failed loads", [&](){
+            QueryResultCache cache{1024, 1h};
+            AssertThrows(std::runtime_error, cache.getOrLoad<int>("a", {}, {}, []() -> int { throw std::runtime_error{"failed"}; }));
+            AssertThat(*cache.getOrLoad<int>("a", {}, {}, [](){ return 1; }), Equals(1));
+        });
+    });
+
+    describe("Test cached queries", [&](){
+        auto& s = getSettingsRef();
+        Connection connection{s.database, s.user, s.password, s.host, s.port};
+        QueryResultCache cache{1 << 20, 1h};
+
+        it("can cache query results", [&](){
+            auto first = cachedQuery(cache, connection, "SELECT 1 AS `id`, 'a' AS `name`", {{"test"}});
+            auto second = cachedQuery(cache, connection, "SELECT 1 AS `id`,  'a' AS `name`");
+            AssertThat(first.get(), Equals(second.get()));
+            AssertThat(first->size(), Equals(1u));
+            AssertThat((*first)[0][first->getColumnHandle("name")].getString(), Equals("a"));
+
+            AssertThat(cache.invalidateTag("test"), Equals(1u));
+            auto third = cachedQuery(cache, connection, "SELECT 1 AS `id`, 'a' AS `name`");
+            AssertThat(third.get(), !Equals(first.get()));
+            AssertThat((*third)[0][0].to<int>(), Equals(1));
+        });
+
+        it("can cache prepared statement results", [&](){
+            auto first = cachedPsQuery<ResultBindings<int, Sql::String>>(cache, connection, "SELECT ? + 1, ?", {}, 1, Sql::String{"a"});
+            auto second = cachedPsQuery<ResultBindings<int, Sql::String>>(cache, connection, "SELECT ? + 1, ?", {}, 1, Sql::String{"a"});
+            auto other = cachedPsQuery<ResultBindings<int, Sql::String>>(cache, connection, "SELECT ? + 1, ?", {}, 2, Sql::String{"b"});
+            AssertThat(first.get(), Equals(second.get()));
+            AssertThat(first->size(), Equals(1u));
+            AssertThat(std::get<0>(first->front()), Equals(2));
+            AssertThat(std::get<0>(other->front()), Equals(3));
+            AssertThat(std::get<1>(other->front()).getString(), Equals("b"));
+        });
+
+        it("separates results of connections to different databases", [&](){
+            Connection otherConnection{"information_schema", s.user, s.password, s.host, s.port};
+            AssertThat(makeQueryCacheKey(connection, "SELECT 1"), !Equals(makeQueryCacheKey(otherConnection, "SELECT 1")));
+
+            auto first = cachedQuery(cache, connection, "SELECT DATABASE()");
+            auto other = cachedQuery(cache, otherConnection, "SELECT DATABASE()");
+            AssertThat((*first)[0][0].getString(), Equals(s.database));
+            AssertThat((*other)[0][0].getString(), Equals("information_schema"s));
+
+            auto firstPs = cachedPsQuery<ResultBindings<Nullable<Sql::String>>>(cache, connection, "SELECT DATABASE()", {});
+            auto otherPs = cachedPsQuery<ResultBindings<Nullable<Sql::String>>>(cache, otherConnection, "SELECT DATABASE()", {});
+            AssertThat(firstPs.get(), !Equals(otherPs.get()));
+            AssertThat(std::get<0>(otherPs->front())->getString(), Equals("information_schema"s));
+        });
+    });
+});
@@ -0,0 +1,87 @@
+/*
+ *  Author: Tomas Nozicka
+ */
+
+#include <string>
+#include <bandit/bandit.h>
+
+#include <superior_mysqlpp.hpp>
+
+#include "settings.hpp"
+
+using namespace bandit;
+using namespace snowhouse;
+using namespace SuperiorMySqlpp;
+using namespace std::string_literals;
+
+
+go_bandit([](){
+    describe("Test query templates", [&](){
+        auto& s = getSettingsRef();
+        Connection connection{s.database, s.user, s.password, s.host, s.port};
+
+        it("parses format at compile time", [&](){
+            auto sqlTemplate = SUPERIOR_MYSQLPP_SQL("SELECT {{{}}} FROM {id} WHERE a={d} AND b={s} AND c={f}");
+            using Template = decltype(sqlTemplate);
+            static_assert(Template::placeholdersCount == 5, "");
+            static_assert(Template::format.placeholders[0] == SqlPlaceholder::value, "");
+            static_assert(Template::format.placeholders[1] == SqlPlaceholder::identifier, "");
+            static_assert(Template::format.placeholders[2] == SqlPlaceholder::integer, "");
+            static_assert(Template::format.placeholders[3] == SqlPlaceholder::string, "");
+            static_assert(Template::format.placeholders[4] == SqlPlaceholder::floatingPoint, "");
+            AssertThat(Template::getSegment(0).to_string(), Equals("SELECT {"));
+            AssertThat(Template::getSegment(1).to_string(), Equals("} FROM "));
+            AssertThat(Template::getSegment(4).to_string(), Equals(" AND c="));
+        });
+
+        it("renders arguments", [&](){
+            auto query = connection.makeQuery(SUPERIOR_MYSQLPP_SQL("SELECT {}, {}, {s}, {d}, {f} FROM {id}"),
+                                              "ol'da", 7, "x\\y"s, -3, 2.5, "we`ird");
+            AssertThat(query.getQueryString(), Equals("SELECT 'ol\\'da', 7, 'x\\\\y', -3, 2.5 FROM `we``ird`"));
+        });
+
+        it("renders NULL values", [&](){
+            Nullable<int> empty{};
+            Nullable<std::string> name{"abc"};
+            auto query = connection.makeQuery(SUPERIOR_MYSQLPP_SQL("{} {d} {s} {}"), nullptr, empty, name, Nullable<double>{});
+            AssertThat(query.getQueryString(), Equals("NULL NULL 'abc' NULL"));
+        });
+
+        it("renders temporal values", [&](){
+            auto query = connection.makeQuery(SUPERIOR_MYSQLPP_SQL("SELECT {}, {s}, {}"),
+                                              Date{2015, 12, 31}, Time{838, 59, 58, true}, Datetime{2015, 1, 2, 3, 4, 5, 60});
+            AssertThat(query.getQueryString(), Equals("SELECT '2015-12-31', '-838:59:58', '2015-01-02 03:04:05.000060'"));
+
+            auto streamQuery = connection.makeQuery("SELECT ");
+            streamQuery << quoteOnly << Date{2015, 12, 31} << ", " << Time{7, 8, 9};
+            AssertThat(streamQuery.getQueryString(), Equals("SELECT '2015-12-31', 07:08:09"));
+        });
+
+        it("reads temporal values back", [&](){
+            Datetime datetime{2015, 1, 2, 3, 4, 5, 60};
+            auto query = connection.makeQuery(SUPERIOR_MYSQLPP_SQL("SELECT DATE({}), TIME({}), CAST({} AS DATETIME(6))"),
+                                              Date{2015, 12, 31}, Time{838, 59, 58, true}, datetime);
+            query.execute();
+
+            auto result = query.store();
+            auto row = result.fetchRow();
+            AssertThat(row[0].to<Date>(), Equals(Date{2015, 12, 31}));
+            auto time = row[1].to<Time>();
+            AssertThat(time, Equals(Time{838, 59, 58}));
+            AssertThat(time.isNegative(), IsTrue());
+            AssertThat(row[2].to<Datetime>(), Equals(datetime));
+        });
+
+        it("can be appended and executed", [&](){
+            auto query = connection.makeQuery("SELECT ");
+            query.format(SUPERIOR_MYSQLPP_SQL("{d} + {d}, {}"), 20, 22, StringView{"te'xt"});
+            query.execute();
+
+            auto result = query.store();
+            auto row = result.fetchRow();
+            AssertThat(static_cast<bool>(row), IsTrue());
+            AssertThat(row[0].to<int>(), Equals(42));
+            AssertThat(row[1].getString(), Equals("te'xt"));
+        });
+    });
+});
@@ -2,12 +2,19 @@
  *  Author: Tomas Nozicka
  */
 
+#include <atomic>
 #include <sstream>
+#include <cstdint>
+#include <set>
 #include <string>
+#include <tuple>
+#include <vector>
 #include <bandit/bandit.h>
 
 #include <superior_mysqlpp.hpp>
 #include <superior_mysqlpp/prepared_statement.hpp>
+#include <superior_mysqlpp/owned_row_set.hpp>
+#include <superior_mysqlpp/row_batch_reader.hpp>
 
 #include "settings.hpp"
 
@@ -144,6 +151,155 @@ go_bandit([](){
             AssertThat(result.getColumnIndex("name"sv), Equals(1u));
         });
 
+        it("can get column by handle", [&](){
+            auto query = connection.makeQuery("SELECT `id`, `name`, `id` FROM test_superior_sqlpp.xuser3 ORDER BY `id` ASC");
+            query.execute();
+            auto result = query.store();
+
+            AssertThrows(OutOfRange, result.getColumnHandle("nam"));
+
+            auto id = result.getColumnHandle("id");
+            auto name = result.getColumnHandle("name"s);
+            AssertThat(id.getIndex(), Equals(0u));
+            AssertThat(name.getIndex(), Equals(1u));
+
+            while (auto row = result.fetchRow())
+            {
+                AssertThat(row[id].getStringView(), Equals(row[0].getStringView()));
+                AssertThat(row[name].getStringView(), Equals(row[1].getStringView()));
+            }
+        });
+
+        it("can fetch use result in batches", [&](){
+            auto makeQuery = [&connection](){
+                return connection.makeQuery("SELECT `id`, `name`, NULL FROM test_superior_sqlpp.xuser3 ORDER BY `id` ASC");
+            };
+
+            std::vector<std::string> expected{};
+            {
+                auto query = makeQuery();
+                query.execute();
+                auto result = query.store();
+                while (auto row = result.fetchRow())
+                {
+                    expected.push_back(row[0].getString() + row[1].getString());
+                }
+            }
+            AssertThat(expected.size(), IsGreaterThan(2u));
+
+            {
+                auto query = makeQuery();
+                query.execute();
+                auto result = query.use();
+                std::vector<std::string> fetched{};
+                RowBatch batch{};
+                while (result.fetchBatch(batch, 2) != 0)
+                {
+                    AssertThat(batch.size(), IsLessThan(3u));
+                    for (std::size_t i=0; i<batch.size(); ++i)
+                    {
+                        auto row = batch[i];
+                        AssertThat(row.size(), Equals(3u));
+                        AssertThat(row[2].isNull(), IsTrue());
+                        fetched.push_back(row[0].getString() + row[1].getString());
+                    }
+                }
+                AssertThat(fetched, Equals(expected));
+            }
+
+            {
+                auto query = makeQuery();
+                query.execute();
+                auto result = query.use();
+                std::vector<std::string> fetched{};
+                {
+                    RowBatchReader reader{result, 2};
+                    RowBatch batch{};
+                    while (reader.fetchBatch(batch))
+                    {
+                        for (std::size_t i=0; i<batch.size(); ++i)
+                        {
+                            fetched.push_back(batch[i][0].getString() + batch[i][1].getString());
+                        }
+                    }
+                    AssertThat(reader.fetchBatch(batch), IsFalse());
+                    AssertThat(batch.empty(), IsTrue());
+                }
+                AssertThat(fetched, Equals(expected));
+            }
+        });
+
+        it("can process rows in parallel", [&](){
+            WorkerPool pool{3};
+            auto makeQuery = [&connection](){
+                return connection.makeQuery("SELECT `id`, `name` FROM test_superior_sqlpp.xuser3 ORDER BY `id` ASC");
+            };
+
+            std::vector<int> expected{};
+            auto serialQuery = makeQuery();
+            serialQuery.execute();
+            serialQuery.forEachRow([&](Row& row){
+                expected.push_back(row[0].to<int>());
+            });
+
+            auto query = makeQuery();
+            query.execute();
+            std::atomic<int> count{0};
+            query.parallelForEachRow(pool, [&](Row& row){
+                AssertThat(row.size(), Equals(2u));
+                ++count;
+            }, 2);
+            AssertThat(count.load(), Equals(static_cast<int>(expected.size())));
+
+            auto orderedQuery = makeQuery();
+            orderedQuery.execute();
+            std::vector<int> ids{};
+            orderedQuery.parallelForEachRow(pool, [](Row& row){ return row[0].to<int>(); }, 2, [&](int id){
+                ids.push_back(id);
+            });
+            AssertThat(ids, Equals(expected));
+        });
+
+        it("can copy rows into owned row set", [&](){
+            auto makeQuery = [&connection](){
+                return connection.makeQuery("SELECT `id`, `name`, NULL AS `nothing` FROM test_superior_sqlpp.xuser3 ORDER BY `id` ASC");
+            };
+
+            auto storeQuery = makeQuery();
+            storeQuery.execute();
+            auto result = storeQuery.store();
+            std::vector<std::string> expected{};
+            while (auto row = result.fetchRow())
+            {
+                expected.push_back(row[0].getString() + row[1].getString());
+            }
+            result.seekRow(0);
+            OwnedRowSet stored{result};
+
+            auto useQuery = makeQuery();
+            useQuery.execute();
+            OwnedRowSet used{useQuery.use()};
+
+            for (auto* rowSet: {&stored, &used})
+            {
+                AssertThat(rowSet->size(), Equals(expected.size()));
+                AssertThat(rowSet->getFieldsCount(), Equals(3u));
+                AssertThrows(OutOfRange, rowSet->getColumnIndex("missing"));
+
+                auto name = rowSet->getColumnHandle("name");
+                std::vector<std::string> copied{};
+                for (auto row: *rowSet)
+                {
+                    AssertThat(row.isNull(2), IsTrue());
+                    AssertThat(row[2].isNull(), IsTrue());
+                    copied.push_back(row[0].getString() + row[name].getString());
+                }
+                AssertThat(copied, Equals(expected));
+                AssertThat((*rowSet)[0][0].to<int>(), Equals(std::stoi(expected.front())));
+            }
+            AssertThat(used.getArenaSize(), Equals(stored.getArenaSize()));
+        });
+
         it("can work with NULL", [&](){
             connection.makeQuery("INSERT INTO `simple_null` (`id`, `string`) VALUES (1, 'aaa'), (2, NULL)").execute();
 
@@ -209,6 +365,67 @@ go_bandit([](){
             AssertThat(query.nextResult(), IsFalse());
             AssertThat(query.hasMoreResults(), IsFalse());
         });
+        it("can store rows in tuples", [&](){
+            auto query = connection.makeQuery(
+                "SELECT `id`, `name` FROM test_superior_sqlpp.xuser3 ORDER BY `id` ASC"
+            );
+            query.execute();
+
+            auto rows = query.storeIn<std::vector<std::tuple<int, std::string>>>();
+            AssertThat(rows.size(), Equals(3u));
+            AssertThat(std::get<0>(rows[0]), Equals(76));
+            AssertThat(std::get<1>(rows[2]), Equals("olda"));
+        });
+
+        it("can store rows in structures", [&](){
+            struct User
+            {
+                std::uint64_t id;
+                Nullable<std::string> name;
+            };
+
+            auto query = connection.makeQuery(
+                "SELECT NULL AS `name`, 5 AS `id` UNION ALL SELECT 'abc', 7 UNION ALL SELECT 'def', 9"
+            );
+            query.execute();
+
+            std::vector<User> users{};
+            query.storeIf(users, [](const User& user){ return user.id != 7; },
+                          mapColumn("id", &User::id), mapColumn("name", &User::name));
+            AssertThat(users.size(), Equals(2u));
+            AssertThat(users[0].id, Equals(5u));
+            AssertThat(users[0].name.isValid(), IsFalse());
+            AssertThat(users[1].id, Equals(9u));
+            AssertThat(*users[1].name, Equals("def"));
+        });
+
+        it("can store single column", [&](){
+            auto query = connection.makeQuery("SELECT 3 UNION ALL SELECT 1 UNION ALL SELECT 3");
+            query.execute();
+
+            std::set<int> values{};
+            query.storeIn(values);
+            AssertThat(values, Equals(std::set<int>{1, 3}));
+        });
+
+        it("throws when stored type does not match result", [&](){
+            {
+                auto query = connection.makeQuery("SELECT 1, 2");
+                query.execute();
+                AssertThrows(LogicError, query.storeIn<std::vector<std::tuple<int>>>());
+            }
+            {
+                auto query = connection.makeQuery("SELECT NULL");
+                query.execute();
+                std::vector<int> values{};
+                AssertThrows(LogicError, query.storeInSequence(values));
+            }
+            {
+                auto query = connection.makeQuery("SELECT NULL");
+                query.execute();
+                AssertThat(query.storeIn<std::vector<Nullable<int>>>().at(0).isValid(), IsFalse());
+            }
+        });
     });
 });
 
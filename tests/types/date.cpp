@@ -4,6 +4,7 @@
 
 #include <string>
 #include <tuple>
+#include <stdexcept>
 #include <bandit/bandit.h>
 
 #include <superior_mysqlpp.hpp>
@@ -79,5 +80,19 @@ go_bandit([](){
             AssertThat((Date{2010, 20, 12}>=Date{2010, 20, 12}), IsTrue());
             AssertThat((Date{2011, 20, 13}>=Date{2010, 20, 12}), IsTrue());
         });
+
+        it("can be converted from and to text", [&](){
+            AssertThat(Converters::to<Date>("2015-12-31", 10), Equals(Date{2015, 12, 31}));
+            AssertThat(Converters::to<Date>("0000-00-00", 10), Equals(Date{0, 0, 0}));
+
+            for (auto&& invalid: {"", "2015-12-3", "2015-12-31 ", "2015/12/31", "2015-13-01", "2015-12-32", "2O15-12-31"})
+            {
+                AssertThrows(std::domain_error, Converters::toDate(invalid, std::char_traits<char>::length(invalid)));
+            }
+
+            char buffer[Converters::toCharsBufferSize];
+            auto end = Converters::toChars(buffer, buffer + sizeof(buffer), Date{987, 1, 2});
+            AssertThat(std::string(buffer, end), Equals("0987-01-02"));
+        });
     });
 });
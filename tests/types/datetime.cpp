@@ -4,6 +4,7 @@
 
 #include <string>
 #include <tuple>
+#include <stdexcept>
 #include <bandit/bandit.h>
 
 #include <superior_mysqlpp.hpp>
@@ -113,5 +114,25 @@ go_bandit([](){
             AssertThat((Datetime{2010, 2, 5, 12, 30, 49, 42}<=Datetime{2010, 2, 5, 12, 30, 50, 42}), IsTrue());
             AssertThat((Datetime{2010, 2, 5, 12, 30, 50, 41}<=Datetime{2010, 2, 5, 12, 30, 50, 42}), IsTrue());
         });
+
+        it("can be converted from and to text", [&](){
+            AssertThat(Converters::to<Datetime>("2015-12-31 23:59:58", 19), Equals(Datetime{2015, 12, 31, 23, 59, 58}));
+            AssertThat(Converters::to<Datetime>("2015-12-31 23:59:58.5", 21), Equals(Datetime{2015, 12, 31, 23, 59, 58, 500000}));
+            AssertThat(Converters::to<Datetime>("2015-12-31 23:59:58.000123", 26), Equals(Datetime{2015, 12, 31, 23, 59, 58, 123}));
+            AssertThat(Converters::to<Timestamp>("1970-01-01 00:00:01", 19).getSecond(), Equals(1u));
+
+            for (auto&& invalid: {"", "2015-12-31", "2015-12-31T23:59:58", "2015-12-31 24:00:00", "2015-12-31 23:59:58.",
+                                  "2015-12-31 23:59:58,5", "2015-12-31 23:59:58.1234567", "2015-12-31 23:59:5x"})
+            {
+                AssertThrows(std::domain_error, Converters::toDatetime(invalid, std::char_traits<char>::length(invalid)));
+            }
+
+            auto write = [](const Datetime& value){
+                char buffer[Converters::toCharsBufferSize];
+                return std::string(buffer, Converters::toChars(buffer, buffer + sizeof(buffer), value));
+            };
+            AssertThat(write(Datetime{2015, 1, 2, 3, 4, 5}), Equals("2015-01-02 03:04:05"));
+            AssertThat(write(Timestamp{2015, 1, 2, 3, 4, 5, 60}), Equals("2015-01-02 03:04:05.000060"));
+        });
     });
 });
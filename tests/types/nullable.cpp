@@ -91,5 +91,20 @@ go_bandit([](){
             Nullable<StringData> nullable3{};
             Nullable<StringData> nullable4{inPlace, "aaa"};
         });
+
+        it("can assign empty nullable of advanced type", [&](){
+            Nullable<std::string> nullable1{};
+            Nullable<std::string> nullable2{};
+            nullable1 = nullable2;
+            AssertThat(nullable1.isValid(), IsFalse());
+            nullable1 = std::move(nullable2);
+            AssertThat(nullable1.isValid(), IsFalse());
+
+            Nullable<std::string> nullable3{"aaa"};
+            nullable3 = nullable1;
+            AssertThat(nullable3.isValid(), IsFalse());
+            nullable3 = Nullable<std::string>{"bbb"};
+            AssertThat(nullable3.value(), Equals("bbb"));
+        });
     });
 });
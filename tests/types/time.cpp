@@ -4,6 +4,7 @@
 
 #include <string>
 #include <tuple>
+#include <stdexcept>
 #include <bandit/bandit.h>
 
 #include <superior_mysqlpp.hpp>
@@ -90,5 +91,32 @@ go_bandit([](){
             AssertThat((Time{10, 20, 42}>=Time{10, 20, 42}), IsTrue());
             AssertThat((Time{11, 20, 43}>=Time{10, 20, 42}), IsTrue());
         });
+
+        it("can be converted from and to text", [&](){
+            auto time = Converters::to<Time>("-838:59:58.25", 13);
+            AssertThat(time, Equals(Time{838, 59, 58}));
+            AssertThat(time.isNegative(), IsTrue());
+            AssertThat(time.getSecondFraction(), Equals(250000u));
+
+            time = Converters::to<Time>("07:08:09", 8);
+            AssertThat(time, Equals(Time{7, 8, 9}));
+            AssertThat(time.isNegative(), IsFalse());
+            AssertThat(time.getSecondFraction(), Equals(0u));
+
+            for (auto&& invalid: {"", "7:08:09", "07:08:60", "07:60:09", "07:08:09.", "07:08:09.1234567", "1234:00:00", "07-08-09"})
+            {
+                AssertThrows(std::domain_error, Converters::toTime(invalid, std::char_traits<char>::length(invalid)));
+            }
+
+            auto write = [](const Time& value){
+                char buffer[Converters::toCharsBufferSize];
+                return std::string(buffer, Converters::toChars(buffer, buffer + sizeof(buffer), value));
+            };
+            AssertThat(write(Time{7, 8, 9}), Equals("07:08:09"));
+            AssertThat(write(time), Equals("07:08:09"));
+            time = Time{100, 0, 1, true};
+            time.setSecondFraction(1200);
+            AssertThat(write(time), Equals("-100:00:01.001200"));
+        });
     });
 });